@@ -0,0 +1,205 @@
+import os from 'os';
+import { Worker } from 'worker_threads';
+/**
+ * @file MLDSAWorkerPool.js
+ * @description Runs ML-DSA calls on N worker_threads, each with its own module instance,
+ * so bursts of approvals scale with cores instead of blocking the event loop.
+ */
+
+/**
+ * Pool of ML-DSA module instances living in worker threads.
+ * Exposes the same sign / verify / verifyWithCertificate / signCertificate calls as MLDSAWrapper.
+ */
+class MLDSAWorkerPool {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.size] - Number of workers (default: available parallelism)
+   * @param {string} [options.wasmPath] - WASM loader path handed to each worker's MLDSAWrapper
+   * @param {string} [options.backend] - Backend handed to each worker's MLDSAWrapper ('native', 'wasm' or 'auto')
+   */
+  constructor(options = {}) {
+    this.size = Math.max(1, options.size || (os.availableParallelism ? os.availableParallelism() : os.cpus().length));
+    this.wasmPath = options.wasmPath || '/app/utils/crypto/mldsa_lib.js';
+    this.backend = options.backend;
+    this.workers = [];
+    this.idle = [];
+    // Only the main thread touches the queue and idle list, so no locking is needed.
+    this.queue = [];
+    this.pending = new Map();
+    this.nextId = 1;
+    this.closed = false;
+  }
+
+  /**
+   * Starts all workers and waits until every module instance is ready.
+   * @returns {Promise<void>}
+   */
+  async initialize() {
+    const starting = [];
+    for (let i = 0; i < this.size; i++) {
+      starting.push(this._spawnWorker());
+    }
+    await Promise.all(starting);
+  }
+
+  /**
+   * Starts one worker and resolves once its module instance is initialized.
+   * @private
+   */
+  _spawnWorker() {
+    return new Promise((resolve, reject) => {
+      const worker = new Worker(new URL('./mldsa_worker.js', import.meta.url), {
+        workerData: { wasmPath: this.wasmPath, backend: this.backend },
+      });
+      worker.current = null;
+      let ready = false;
+
+      worker.on('message', (msg) => {
+        if (msg.ready) {
+          ready = true;
+          this.workers.push(worker);
+          this._release(worker);
+          resolve();
+          return;
+        }
+        const task = this.pending.get(msg.id);
+        this.pending.delete(msg.id);
+        worker.current = null;
+        if (task) {
+          if (msg.error) task.reject(new Error(msg.error));
+          else task.resolve(msg.result);
+        }
+        this._release(worker);
+      });
+
+      worker.on('error', (error) => {
+        if (!ready) reject(error);
+        this._failWorker(worker, error);
+      });
+
+      worker.on('exit', (code) => {
+        if (!ready) {
+          reject(new Error(`ML-DSA worker exited during startup with code ${code}`));
+          return;
+        }
+        this._failWorker(worker, new Error(`ML-DSA worker exited with code ${code}`));
+      });
+    });
+  }
+
+  /**
+   * Rejects the task a dead worker was running and replaces the worker.
+   * @private
+   */
+  _failWorker(worker, error) {
+    const index = this.workers.indexOf(worker);
+    if (index === -1) return;
+    this.workers.splice(index, 1);
+    this.idle = this.idle.filter(w => w !== worker);
+    if (worker.current !== null) {
+      const task = this.pending.get(worker.current);
+      this.pending.delete(worker.current);
+      if (task) task.reject(error);
+    }
+    if (!this.closed) {
+      this._spawnWorker().catch((spawnError) => {
+        console.error("Failed to replace ML-DSA worker:", spawnError);
+      });
+    }
+  }
+
+  /**
+   * Hands the next queued task to a worker, or parks the worker as idle.
+   * @private
+   */
+  _release(worker) {
+    const next = this.queue.shift();
+    if (next) {
+      this._run(worker, next);
+    } else {
+      this.idle.push(worker);
+    }
+  }
+
+  /**
+   * @private
+   */
+  _run(worker, task) {
+    worker.current = task.id;
+    this.pending.set(task.id, task);
+    worker.postMessage({ id: task.id, method: task.method, args: task.args });
+  }
+
+  /**
+   * Queues a call and resolves with the worker's result.
+   * @private
+   */
+  _submit(method, args) {
+    if (this.closed) {
+      return Promise.reject(new Error("ML-DSA worker pool is closed"));
+    }
+    return new Promise((resolve, reject) => {
+      const task = { id: this.nextId++, method, args, resolve, reject };
+      const worker = this.idle.pop();
+      if (worker) {
+        this._run(worker, task);
+      } else {
+        this.queue.push(task);
+      }
+    });
+  }
+
+  /**
+   * Signs a message using ML-DSA-65 on a pool worker.
+   * @param {Uint8Array} privateKey - The private key as a byte array
+   * @param {string|Uint8Array} message - The message to sign
+   * @returns {Promise<Uint8Array>} The signature as a byte array
+   */
+  sign(privateKey, message) {
+    return this._submit('sign', [privateKey, message]);
+  }
+
+  /**
+   * Verifies an ML-DSA-65 signature on a pool worker.
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  verify(publicKey, signature, message, signaturePath) {
+    return this._submit('verify', signaturePath === undefined
+      ? [publicKey, signature, message]
+      : [publicKey, signature, message, signaturePath]);
+  }
+
+  /**
+   * Verifies a signature using a certificate on a pool worker.
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  verifyWithCertificate(certData, signatureData, message) {
+    return this._submit('verifyWithCertificate', [certData, signatureData, message]);
+  }
+
+  /**
+   * Signs a certificate with a CA certificate and private key on a pool worker.
+   * @returns {Promise<Uint8Array>} The signed certificate as a byte array
+   */
+  signCertificate(caPrivateKey, csrData, caCertData, days = 365, options = {}) {
+    return this._submit('signCertificate', [caPrivateKey, csrData, caCertData, days, options]);
+  }
+
+  /**
+   * Rejects queued calls and terminates all workers.
+   * @returns {Promise<void>}
+   */
+  async close() {
+    this.closed = true;
+    const error = new Error("ML-DSA worker pool is closed");
+    this.queue.splice(0).forEach(task => task.reject(error));
+    const workers = this.workers.splice(0);
+    this.idle = [];
+    await Promise.all(workers.map(worker => worker.terminate()));
+    for (const task of this.pending.values()) task.reject(error);
+    this.pending.clear();
+  }
+}
+
+export default MLDSAWorkerPool;
+export { MLDSAWorkerPool };
@@ -1,4 +1,6 @@
 import path from 'path';
+import { createRequire } from 'module';
+import { isMainThread } from 'worker_threads';
 /**
  * @file mldsa_wrapper.js
  * @description A JavaScript wrapper for the ML-DSA WASM module that provides a clean,
@@ -13,15 +15,49 @@ class MLDSAWrapper {
   /**
    * Creates a new instance of the ML-DSA wrapper.
    * @param {string} wasmPath - Path to the compiled WASM module JS loader (default: './mldsa_lib.js')
+   * @param {Object} [options]
+   * @param {string} [options.backend] - 'native', 'wasm' or 'auto' (default: MLDSA_BACKEND env var, else 'auto')
+   * @param {string} [options.nativePath] - Path to the N-API addon (default: build/Release/mldsa_native.node next to the WASM loader)
    */
-  constructor(wasmPath = '/app/utils/crypto/mldsa_lib.js') {
+  constructor(wasmPath = '/app/utils/crypto/mldsa_lib.js', options = {}) {
     this.wasmPath = wasmPath;
+    this.backend = options.backend || process.env.MLDSA_BACKEND || 'auto';
+    this.nativePath = options.nativePath || path.join(path.dirname(wasmPath), 'build', 'Release', 'mldsa_native.node');
     this.module = null;
+    this.native = null;
+    this.pool = null;
     this.initialized = false;
     
     // Constants from the C++ header
     this.ML_DSA_65_PRIVATE_KEY_SIZE = 4032;
     this.ML_DSA_65_PUBLIC_KEY_SIZE = 1952;
+    this.ML_DSA_65_SIGNATURE_SIZE = 3309;
+    this.PEM_CAPACITY = 16 * 1024;
+    this.STATUS_TOKEN_SIZE = 50;
+    // Byte-mode capacity of a version 40-L QR symbol, the default frame size for splitQrPayload
+    this.QR_MAX_FRAME_SIZE = 2953;
+    // Staging buffer size for signStream(); bounds WASM memory per streamed document
+    this.STREAM_CHUNK_SIZE = 64 * 1024;
+
+    // Scratch regions of mldsa_arena (mldsa_lib.h)
+    this.ARENA_PRIVATE_KEY = 0;
+    this.ARENA_PUBLIC_KEY = 1;
+    this.ARENA_SIGNATURE = 2;
+    this.ARENA_MESSAGE = 3;
+    this.ARENA_INPUT = 4;
+    this.ARENA_CA_INPUT = 5;
+    this.ARENA_OUTPUT = 6;
+    this.arena = 0;
+    this.hasHeapView = false;
+
+    // Per-item status of signCertificatesBatch (mldsa_issue_status)
+    this.ISSUE_OK = 0;
+    this.ISSUE_BAD_CSR = 1;
+    this.ISSUE_SIGN_FAILED = 2;
+    this.ISSUE_NO_SPACE = 3;
+    // Keypair pool (startKeyPairPool); WASM refills from idle event-loop turns
+    this.keyPairPoolActive = false;
+    this.keyPairRefill = null;
   }
 
 
@@ -49,9 +85,12 @@ class MLDSAWrapper {
       this.NODEFS = this.module.NODEFS;
       // Wrap C functions
       this._initWrappers();
+      this._installAllocatorHooks();
+      this._initArena();
+      this._loadNative();
     
       this.initialized = true;
-      console.log("ML-DSA WASM module initialized successfully.");
+      console.log(`ML-DSA WASM module initialized successfully (backend: ${this.native ? 'native' : 'wasm'}).`);
     } catch (error) {
       console.error("Failed to initialize ML-DSA WASM module:", error);
       throw new Error(`ML-DSA initialization failed: ${error.message}`);
@@ -72,6 +111,194 @@ class MLDSAWrapper {
     this._verify_signature_with_cert = this.cwrap('verify_signature_with_cert', 'number', ['number','number','number','number','number','number',]);
     this._sign_certificate = this.cwrap('sign_certificate', 'number', ['number', 'number','number','number','number','number','number','number','number' ]);
     this._verify_certificate_issued_by_ca = this.cwrap('verify_certificate_issued_by_ca', 'number', ['number', 'number', 'number', 'number', ]);
+    // Builds with sign_certificate_der also parse DER certificates and CSRs natively
+    this._sign_certificate_der = this._optionalCwrap('sign_certificate_der', 'number', ['number', 'number','number','number','number','number','number','number','number' ]);
+    // Key handle API (absent from older builds of mldsa_lib.wasm)
+    this._load_mldsa65_private_key = this._optionalCwrap('load_mldsa65_private_key', 'number', ['number']);
+    this._load_mldsa65_public_key = this._optionalCwrap('load_mldsa65_public_key', 'number', ['number']);
+    this._free_mldsa65_key_handle = this._optionalCwrap('free_mldsa65_key_handle', null, ['number']);
+    this._sign_mldsa65_with_handle = this._optionalCwrap('sign_mldsa65_with_handle', 'number', ['number', 'number', 'number', 'number', 'number']);
+    this._verify_mldsa65_with_handle = this._optionalCwrap('verify_mldsa65_with_handle', 'number', ['number', 'number', 'number', 'number', 'number']);
+    this._new_mldsa65_sign_ctx = this._optionalCwrap('new_mldsa65_sign_ctx', 'number', ['number']);
+    this._sign_mldsa65_with_ctx = this._optionalCwrap('sign_mldsa65_with_ctx', 'number', ['number', 'number', 'number', 'number', 'number']);
+    this._free_mldsa65_sign_ctx = this._optionalCwrap('free_mldsa65_sign_ctx', null, ['number']);
+    this._new_mldsa65_sign_stream = this._optionalCwrap('new_mldsa65_sign_stream', 'number', ['number']);
+    this._update_mldsa65_sign_stream = this._optionalCwrap('update_mldsa65_sign_stream', 'number', ['number', 'number', 'number']);
+    this._final_mldsa65_sign_stream = this._optionalCwrap('final_mldsa65_sign_stream', 'number', ['number', 'number', 'number']);
+    this._free_mldsa65_sign_stream = this._optionalCwrap('free_mldsa65_sign_stream', null, ['number']);
+    this._mldsa_arena_new = this._optionalCwrap('mldsa_arena_new', 'number', ['number']);
+    this._mldsa_arena_reserve = this._optionalCwrap('mldsa_arena_reserve', 'number', ['number', 'number', 'number']);
+    this._mldsa_arena_wipe_private_key = this._optionalCwrap('mldsa_arena_wipe_private_key', null, ['number']);
+    this._sign_certificates_batch = this._optionalCwrap('sign_certificates_batch', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._verify_signature_batch = this._optionalCwrap('verify_signature_batch', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_clear_trust_store_cache = this._optionalCwrap('mldsa_clear_trust_store_cache', null, []);
+    this._mldsa_set_verify_key_cache_capacity = this._optionalCwrap('mldsa_set_verify_key_cache_capacity', null, ['number']);
+    this._mldsa_get_verify_key_cache_stats = this._optionalCwrap('mldsa_get_verify_key_cache_stats', null, ['number', 'number', 'number']);
+    this._mldsa_install_allocator_hooks = this._optionalCwrap('mldsa_install_allocator_hooks', 'number', []);
+    this._mldsa_set_issuance_arena_enabled = this._optionalCwrap('mldsa_set_issuance_arena_enabled', null, ['number']);
+    this._mldsa_get_thread_allocation_counts = this._optionalCwrap('mldsa_get_thread_allocation_counts', null, ['number', 'number']);
+    this._mldsa_stats_export = this._optionalCwrap('mldsa_stats_export', 'number', ['number', 'number', 'number']);
+    this._mldsa_stats_reset = this._optionalCwrap('mldsa_stats_reset', null, []);
+    this._mldsa_drain_errors = this._optionalCwrap('mldsa_drain_errors', 'number', ['number', 'number']);
+    this._mldsa_set_error_summary_interval = this._optionalCwrap('mldsa_set_error_summary_interval', null, ['number']);
+    this._mldsa_keypair_pool_start = this._optionalCwrap('mldsa_keypair_pool_start', 'number', ['number', 'number']);
+    this._mldsa_keypair_pool_take = this._optionalCwrap('mldsa_keypair_pool_take', 'number', ['number', 'number']);
+    this._mldsa_keypair_pool_refill = this._optionalCwrap('mldsa_keypair_pool_refill', 'number', ['number']);
+    this._mldsa_keypair_pool_size = this._optionalCwrap('mldsa_keypair_pool_size', 'number', []);
+    this._mldsa_keypair_pool_stop = this._optionalCwrap('mldsa_keypair_pool_stop', null, []);
+    this._mldsa_serial_init = this._optionalCwrap('mldsa_serial_init', 'number', ['number', 'string']);
+    this._mldsa_certificate_serial = this._optionalCwrap('mldsa_certificate_serial', 'number', ['number', 'number', 'number', 'number']);
+    this._mldsa_revocation_load_crl = this._optionalCwrap('mldsa_revocation_load_crl', 'number', ['number', 'number', 'number', 'number']);
+    this._mldsa_revocation_check = this._optionalCwrap('mldsa_revocation_check', 'number', ['number', 'number']);
+    this._mldsa_revocation_clear = this._optionalCwrap('mldsa_revocation_clear', null, []);
+    this._mldsa_verify_status_cached = this._optionalCwrap('mldsa_verify_status_cached', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_status_token_check = this._optionalCwrap('mldsa_status_token_check', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_status_set_key = this._optionalCwrap('mldsa_status_set_key', 'number', ['number', 'number']);
+    this._mldsa_status_cache_clear = this._optionalCwrap('mldsa_status_cache_clear', null, []);
+    this._mldsa_qr_message_encode = this._optionalCwrap('mldsa_qr_message_encode', 'number', ['number', 'number', 'number', 'number', 'number']);
+    this._mldsa_qr_message_fields = this._optionalCwrap('mldsa_qr_message_fields', 'number', ['number', 'number', 'number', 'number', 'number']);
+    this._mldsa_qr_payload_encode = this._optionalCwrap('mldsa_qr_payload_encode', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_qr_payload_parse = this._optionalCwrap('mldsa_qr_payload_parse', 'number', ['number', 'number', 'number', 'number']);
+    this._mldsa_qr_payload_verify = this._optionalCwrap('mldsa_qr_payload_verify', 'number', ['number', 'number', 'number', 'number']);
+    this._mldsa_qr_payload_split = this._optionalCwrap('mldsa_qr_payload_split', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_qr_payload_join = this._optionalCwrap('mldsa_qr_payload_join', 'number', ['number', 'number', 'number', 'number', 'number']);
+    this._mldsa_merkle_sign_batch = this._optionalCwrap('mldsa_merkle_sign_batch', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_merkle_verify = this._optionalCwrap('mldsa_merkle_verify', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_merkle_verify_with_cert = this._optionalCwrap('mldsa_merkle_verify_with_cert', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_sig_store_open = this._optionalCwrap('mldsa_sig_store_open', 'number', ['string', 'number']);
+    this._mldsa_sig_store_close = this._optionalCwrap('mldsa_sig_store_close', null, []);
+    this._mldsa_sig_store_put = this._optionalCwrap('mldsa_sig_store_put', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_sig_store_get = this._optionalCwrap('mldsa_sig_store_get', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+    this._mldsa_sig_store_verify_with_cert = this._optionalCwrap('mldsa_sig_store_verify_with_cert', 'number', ['number', 'number', 'number', 'number']);
+    this._mldsa_sig_store_delete = this._optionalCwrap('mldsa_sig_store_delete', 'number', ['number', 'number']);
+    this._mldsa_sig_store_sync = this._optionalCwrap('mldsa_sig_store_sync', 'number', []);
+    this._mldsa_sig_store_compact = this._optionalCwrap('mldsa_sig_store_compact', 'number', ['number']);
+    this._mldsa_sig_store_stats = this._optionalCwrap('mldsa_sig_store_stats', null, ['number', 'number', 'number', 'number']);
+    this._sign_crl = this._optionalCwrap('sign_crl', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']);
+  }
+
+  /**
+   * Routes OpenSSL allocations through the per-request issuance arena.
+   * OpenSSL only accepts the hooks before its first allocation, so this runs before any other call.
+   * Set MLDSA_ISSUANCE_ARENA=0 to keep certificate issuance on the general heap.
+   * @private
+   */
+  _installAllocatorHooks() {
+    if (!this._mldsa_install_allocator_hooks) return;
+    this._mldsa_install_allocator_hooks();
+    if (process.env.MLDSA_ISSUANCE_ARENA === '0') {
+      this._mldsa_set_issuance_arena_enabled(0);
+    }
+  }
+
+  /**
+   * Detects the HEAPU8 view and creates the reusable scratch arena when the build supports them.
+   * Without them every call falls back to per-call malloc and byte-by-byte copies.
+   * @private
+   */
+  _initArena() {
+    // Unexported runtime symbols are abort()ing getters under ASSERTIONS, so never touch them.
+    const heapDescriptor = Object.getOwnPropertyDescriptor(this.module, 'HEAPU8');
+    this.hasHeapView = !!heapDescriptor && 'value' in heapDescriptor;
+    if (this._mldsa_arena_new) {
+      this.arena = this._mldsa_arena_new(64 * 1024);
+    }
+  }
+
+  /**
+   * Returns a scratch buffer of at least `size` bytes: an arena region when available,
+   * otherwise a fresh allocation that must be handed to _releaseScratch().
+   * Arena regions are reused by the next call, so results must be copied out before returning.
+   * @private
+   */
+  _scratch(region, size) {
+    if (this.arena) {
+      const ptr = this._mldsa_arena_reserve(this.arena, region, size || 1);
+      if (ptr) return { ptr, owned: false };
+    }
+    const ptr = this.malloc(size || 1);
+    if (!ptr) throw new Error("Failed to allocate WASM memory");
+    return { ptr, owned: true };
+  }
+
+  /**
+   * Frees scratch buffers that did not come from the arena.
+   * @private
+   */
+  _releaseScratch(...buffers) {
+    for (const buffer of buffers) {
+      if (buffer && buffer.owned) this.free(buffer.ptr);
+    }
+  }
+
+  /**
+   * Loads the native N-API build of the library when the selected backend allows it.
+   * The WASM module stays loaded only for the virtual FS helpers; every library call goes to the addon.
+   * @private
+   * @throws {Error} If backend is 'native' and the addon cannot be loaded
+   */
+  _loadNative() {
+    if (this.backend === 'wasm') return;
+    try {
+      const require = createRequire(import.meta.url);
+      const nativePath = path.isAbsolute(this.nativePath) || this.nativePath.startsWith('.')
+        ? this.nativePath
+        : './' + this.nativePath;
+      this.native = require(nativePath);
+    } catch (error) {
+      if (this.backend === 'native') {
+        throw new Error(`Native ML-DSA addon could not be loaded: ${error.message}`);
+      }
+      this.native = null;
+    }
+  }
+
+  /**
+   * Routes sign, verify, verifyWithCertificate and signCertificate through a pool of
+   * worker threads, each with its own module instance, so they no longer block the event loop.
+   * @param {number} [size] - Number of workers (default: available parallelism)
+   * @returns {Promise<void>}
+   */
+  async enablePool(size) {
+    this._ensureInitialized();
+    if (this.pool) return;
+    const { MLDSAWorkerPool } = await import('./MLDSAWorkerPool.js');
+    const pool = new MLDSAWorkerPool({ size, wasmPath: this.wasmPath, backend: this.backend });
+    await pool.initialize();
+    this.pool = pool;
+    console.log(`ML-DSA worker pool started with ${pool.size} workers.`);
+  }
+
+  /**
+   * Stops the worker pool; calls run on this thread again afterwards.
+   * @returns {Promise<void>}
+   */
+  async disablePool() {
+    if (!this.pool) return;
+    const pool = this.pool;
+    this.pool = null;
+    await pool.close();
+  }
+
+  /**
+   * Wraps a C function only if the loaded module exports it.
+   * @private
+   * @returns {Function|null} The wrapped function, or null for older WASM builds
+   */
+  _optionalCwrap(name, returnType, argTypes) {
+    if (typeof this.module['_' + name] !== 'function') return null;
+    return this.cwrap(name, returnType, argTypes);
+  }
+
+  /**
+   * Ensures an optional export is available in the loaded module.
+   * @private
+   * @throws {Error} If the WASM module was built without the export
+   */
+  _ensureExport(fn, name) {
+    if (!fn) {
+      throw new Error(`${name} is not available in this build of the ML-DSA WASM module.`);
+    }
   }
 
   /**
@@ -159,9 +386,8 @@ class MLDSAWrapper {
    * @returns {string} Hexadecimal representation of the bytes
    */
   _bytesToHex(bytes) {
-    return Array.from(bytes)
-      .map(b => b.toString(16).padStart(2, '0'))
-      .join('');
+    // Node's native codec; the library's own (mldsa_hex_encode) serves browser builds.
+    return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength).toString('hex');
   }
 
   /**
@@ -171,11 +397,7 @@ class MLDSAWrapper {
    * @returns {Uint8Array} Byte array representation of the hex string
    */
   _hexToBytes(hex) {
-    const bytes = new Uint8Array(hex.length / 2);
-    for (let i = 0; i < hex.length; i += 2) {
-      bytes[i / 2] = parseInt(hex.substr(i, 2), 16);
-    }
-    return bytes;
+    return new Uint8Array(Buffer.from(hex, 'hex'));
   }
 
   /**
@@ -186,6 +408,10 @@ class MLDSAWrapper {
    * @returns {Uint8Array} The copied data
    */
   _copyFromWasmMemory(ptr, size) {
+    if (this.hasHeapView) {
+      // Re-read HEAPU8 every time: memory growth replaces the view.
+      return this.module.HEAPU8.slice(ptr, ptr + size);
+    }
     const result = new Uint8Array(size);
     for (let i = 0; i < size; i++) {
       result[i] = this.module.getValue(ptr + i, 'i8');
@@ -200,6 +426,10 @@ class MLDSAWrapper {
    * @param {Uint8Array} data - Data to copy
    */
   _copyToWasmMemory(ptr, data) {
+    if (this.hasHeapView) {
+      this.module.HEAPU8.set(data, ptr);
+      return;
+    }
     for (let i = 0; i < data.length; i++) {
       this.module.setValue(ptr + i, data[i], 'i8');
     }
@@ -212,6 +442,12 @@ class MLDSAWrapper {
    */
   async generateKeyPair() {
     this._ensureInitialized();
+    if (this.native) {
+      const { privateKey, publicKey } = this.keyPairPoolActive
+        ? this.native.keypair_pool_take()
+        : this.native.generate_mldsa65_keypair();
+      return { privateKey: new Uint8Array(privateKey), publicKey: new Uint8Array(publicKey) };
+    }
     
     // Allocate memory for the keys
     const privateKeyPtr = this.malloc(this.ML_DSA_65_PRIVATE_KEY_SIZE);
@@ -224,11 +460,14 @@ class MLDSAWrapper {
     }
     
     try {
-      // Generate the key pair
-      const result = this._generate_mldsa65_keypair(privateKeyPtr, publicKeyPtr);
+      // Generate the key pair (or take a pre-generated one from the pool)
+      const result = this.keyPairPoolActive
+        ? this._mldsa_keypair_pool_take(privateKeyPtr, publicKeyPtr)
+        : this._generate_mldsa65_keypair(privateKeyPtr, publicKeyPtr);
       if (!result) {
         throw new Error("Key generation failed");
       }
+      if (this.keyPairPoolActive) this._scheduleKeyPairRefill();
       
       // Copy the keys from WASM memory
       const privateKey = this._copyFromWasmMemory(privateKeyPtr, this.ML_DSA_65_PRIVATE_KEY_SIZE);
@@ -242,6 +481,649 @@ class MLDSAWrapper {
     }
   }
 
+  /**
+   * Starts a pool of pre-generated key pairs so generateKeyPair() returns without running keygen
+   * during registration bursts. The native backend refills it from background threads; the WASM
+   * backend generates one key pair per idle event-loop turn. An empty pool falls back to inline
+   * keygen. Unused private keys are wiped by stopKeyPairPool() and at process exit.
+   * @param {Object} [options]
+   * @param {number} [options.size=32] - Number of key pairs kept ready
+   * @param {number} [options.threads=1] - Background refill threads (native backend only)
+   * @throws {Error} If the pool is already running or cannot be allocated
+   */
+  startKeyPairPool({ size = 32, threads = 1 } = {}) {
+    this._ensureInitialized();
+    let started;
+    if (this.native) {
+      started = this.native.keypair_pool_start(size, threads);
+    } else {
+      this._ensureExport(this._mldsa_keypair_pool_start, 'mldsa_keypair_pool_start');
+      started = this._mldsa_keypair_pool_start(size, 0);
+    }
+    if (!started) throw new Error("Failed to start key pair pool");
+    this.keyPairPoolActive = true;
+    if (!this.native) this._scheduleKeyPairRefill();
+  }
+
+  /**
+   * Stops the key pair pool and wipes the key pairs it still holds.
+   */
+  stopKeyPairPool() {
+    this._ensureInitialized();
+    if (!this.keyPairPoolActive) return;
+    this.keyPairPoolActive = false;
+    if (this.keyPairRefill) {
+      clearImmediate(this.keyPairRefill);
+      this.keyPairRefill = null;
+    }
+    if (this.native) {
+      this.native.keypair_pool_stop();
+    } else {
+      this._mldsa_keypair_pool_stop();
+    }
+  }
+
+  /**
+   * @returns {number} Key pairs currently ready in the pool
+   */
+  getKeyPairPoolSize() {
+    this._ensureInitialized();
+    if (this.native) return this.native.keypair_pool_size();
+    this._ensureExport(this._mldsa_keypair_pool_size, 'mldsa_keypair_pool_size');
+    return this._mldsa_keypair_pool_size();
+  }
+
+  /**
+   * Configures the serial allocator used for every issued certificate. Call once at startup.
+   * Serials combine this node id, a counter and random bits; the counter's high-water mark is
+   * persisted to statePath so it never goes backwards across restarts. With the WASM backend
+   * statePath is a virtual FS path, so it must sit on a mounted host directory to persist.
+   * @param {number} nodeId - Unique per issuing node sharing a CA (0..32767)
+   * @param {string|null} [statePath=null] - High-water mark file, or null to not persist
+   * @throws {Error} If the node id is invalid or the state file cannot be read or written
+   */
+  initSerialAllocator(nodeId, statePath = null) {
+    this._ensureInitialized();
+    let ok;
+    if (this.native) {
+      ok = this.native.serial_init(nodeId, statePath);
+    } else {
+      this._ensureExport(this._mldsa_serial_init, 'mldsa_serial_init');
+      ok = this._mldsa_serial_init(nodeId, statePath);
+    }
+    if (!ok) throw new Error("Failed to initialize serial allocator");
+  }
+
+  /**
+   * Reads the serial number of a certificate, for indexing and revocation.
+   * @param {Uint8Array | string} certData - Certificate (PEM or DER)
+   * @returns {string} Serial as lowercase hex (big-endian, no leading zero bytes)
+   * @throws {Error} If the certificate cannot be parsed
+   */
+  getCertificateSerial(certData) {
+    this._ensureInitialized();
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    if (this.native) {
+      return this._bytesToHex(new Uint8Array(this.native.certificate_serial(certData)));
+    }
+    this._ensureExport(this._mldsa_certificate_serial, 'mldsa_certificate_serial');
+    const certPtr = this.malloc(certData.length);
+    const serialPtr = this.malloc(64);
+    try {
+      if (!certPtr || !serialPtr) throw new Error("Failed to allocate memory for certificate serial");
+      this._copyToWasmMemory(certPtr, certData);
+      const len = this._mldsa_certificate_serial(certPtr, certData.length, serialPtr, 64);
+      if (len < 0) throw new Error("Reading certificate serial failed");
+      return this._bytesToHex(this._copyFromWasmMemory(serialPtr, len));
+    } finally {
+      if (certPtr) this.free(certPtr);
+      if (serialPtr) this.free(serialPtr);
+    }
+  }
+
+  /**
+   * Verifies a CRL against its CA and loads it into the in-library revocation index. From then on
+   * the certificate verification methods reject the certificates it revokes. Loading replaces the
+   * previous CRL of the same CA and does not block verifications running concurrently.
+   * @param {Uint8Array | string} crlData - CRL (PEM or DER)
+   * @param {Uint8Array | string} caCertData - The CA certificate that signed the CRL
+   * @returns {number} Number of revoked serials loaded
+   * @throws {Error} If the CRL is malformed, not signed by the CA, or older than the loaded one
+   */
+  loadCRL(crlData, caCertData) {
+    this._ensureInitialized();
+    crlData = this._certificateInput(crlData, 'X509 CRL');
+    caCertData = this._certificateInput(caCertData, 'CERTIFICATE');
+    if (this.native) {
+      return this.native.revocation_load_crl(crlData, caCertData);
+    }
+    this._ensureExport(this._mldsa_revocation_load_crl, 'mldsa_revocation_load_crl');
+    const crlPtr = this.malloc(crlData.length);
+    const caCertPtr = this.malloc(caCertData.length);
+    try {
+      if (!crlPtr || !caCertPtr) throw new Error("Failed to allocate memory for CRL");
+      this._copyToWasmMemory(crlPtr, crlData);
+      this._copyToWasmMemory(caCertPtr, caCertData);
+      const loaded = this._mldsa_revocation_load_crl(crlPtr, crlData.length, caCertPtr, caCertData.length);
+      if (loaded < 0) throw new Error("Loading CRL failed");
+      return loaded;
+    } finally {
+      if (crlPtr) this.free(crlPtr);
+      if (caCertPtr) this.free(caCertPtr);
+    }
+  }
+
+  /**
+   * Checks a certificate against the loaded CRLs.
+   * @param {Uint8Array | string} certData - Certificate (PEM or DER)
+   * @returns {boolean} True if the certificate is revoked
+   * @throws {Error} If the certificate cannot be parsed
+   */
+  isRevoked(certData) {
+    this._ensureInitialized();
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    if (this.native) {
+      return this.native.revocation_check(certData);
+    }
+    this._ensureExport(this._mldsa_revocation_check, 'mldsa_revocation_check');
+    const certPtr = this.malloc(certData.length);
+    try {
+      if (!certPtr) throw new Error("Failed to allocate memory for certificate");
+      this._copyToWasmMemory(certPtr, certData);
+      const revoked = this._mldsa_revocation_check(certPtr, certData.length);
+      if (revoked < 0) throw new Error("Reading certificate failed");
+      return revoked === 1;
+    } finally {
+      this.free(certPtr);
+    }
+  }
+
+  /**
+   * Drops every loaded CRL.
+   */
+  clearRevocations() {
+    this._ensureInitialized();
+    if (this.native) {
+      this.native.revocation_clear();
+    } else if (this._mldsa_revocation_clear) {
+      this._mldsa_revocation_clear();
+    }
+  }
+
+  /**
+   * Issues a CRL revoking the given certificate serials.
+   * @param {Uint8Array} caPrivateKey - The CA private key as a byte array
+   * @param {Uint8Array | string} caCertData - The CA certificate
+   * @param {string[]} serials - Revoked serials as hex (see getCertificateSerial)
+   * @param {number} [nextUpdateDays=7] - Days until the CRL's nextUpdate
+   * @param {Object} [options]
+   * @param {'pem'|'der'} [options.format='pem'] - Encoding of the returned CRL
+   * @returns {Uint8Array} The signed CRL
+   * @throws {Error} If signing fails
+   */
+  signCRL(caPrivateKey, caCertData, serials, nextUpdateDays = 7, options = {}) {
+    this._ensureInitialized();
+    const derOutput = options.format === 'der';
+    caCertData = this._certificateInput(caCertData, 'CERTIFICATE');
+    const serialBytes = serials.map(serial => this._hexToBytes(serial));
+    if (this.native) {
+      return new Uint8Array(this.native.sign_crl(caPrivateKey, caCertData, serialBytes, nextUpdateDays, derOutput));
+    }
+    this._ensureExport(this._sign_crl, 'sign_crl');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for CRL");
+      allocations.push(ptr);
+      return ptr;
+    };
+    let caPrivateKeyPtr = 0;
+    try {
+      const serialPtrs = alloc(serialBytes.length * 4);
+      const serialLens = alloc(serialBytes.length * 4);
+      serialBytes.forEach((serial, i) => {
+        const ptr = alloc(serial.length);
+        this._copyToWasmMemory(ptr, serial);
+        this.module.setValue(serialPtrs + i * 4, ptr, 'i32');
+        this.module.setValue(serialLens + i * 4, serial.length, 'i32');
+      });
+      const caCertPtr = alloc(caCertData.length);
+      this._copyToWasmMemory(caCertPtr, caCertData);
+      caPrivateKeyPtr = alloc(caPrivateKey.length);
+      this._copyToWasmMemory(caPrivateKeyPtr, caPrivateKey);
+      const outSize = this.PEM_CAPACITY + serialBytes.length * 128;
+      const outPtr = alloc(outSize);
+      const len = this._sign_crl(
+        caCertPtr, caCertData.length,
+        caPrivateKeyPtr, caPrivateKey.length,
+        serialPtrs, serialLens, serialBytes.length,
+        nextUpdateDays, derOutput ? 1 : 0,
+        outPtr, outSize
+      );
+      if (!len) throw new Error("CRL signing failed");
+      return this._copyFromWasmMemory(outPtr, len);
+    } finally {
+      // Do not leave the CA key behind in freed heap memory.
+      if (caPrivateKeyPtr) this._copyToWasmMemory(caPrivateKeyPtr, new Uint8Array(caPrivateKey.length));
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  /**
+   * Verifies a signature for a QR status check. The first check of a signature UUID runs the full
+   * ML-DSA verification; repeat checks of the same content within the TTL are answered from the
+   * library's status cache. Either way the result comes with a MAC-signed status token that
+   * checkStatusToken() validates without re-verifying.
+   * @param {string} uuid - Signature UUID
+   * @param {Uint8Array | string} certData - Signer certificate
+   * @param {Uint8Array} signature - The signature as a byte array
+   * @param {string|Uint8Array} message - The signed message
+   * @param {Object} [options]
+   * @param {Uint8Array | string} [options.caCert] - When given, the signer certificate must chain to it
+   * @param {number} [options.ttl=300] - Seconds the result and token stay valid
+   * @returns {{valid: boolean, token: string}} Status and base64url token
+   * @throws {Error} If the arguments are invalid
+   */
+  verifyStatusCached(uuid, certData, signature, message, { caCert = null, ttl = 300 } = {}) {
+    this._ensureInitialized();
+    const encoder = new TextEncoder();
+    const uuidBytes = encoder.encode(uuid);
+    const messageBytes = typeof message === 'string' ? encoder.encode(message) : message;
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    const caCertData = caCert ? this._certificateInput(caCert, 'CERTIFICATE') : null;
+    if (this.native) {
+      const { valid, token } = this.native.verify_status_cached(uuidBytes, certData, caCertData, signature, messageBytes, ttl);
+      return { valid, token: Buffer.from(token).toString('base64url') };
+    }
+    this._ensureExport(this._mldsa_verify_status_cached, 'mldsa_verify_status_cached');
+
+    const allocations = [];
+    const copyIn = (bytes) => {
+      const ptr = this.malloc(bytes.length || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for status check");
+      allocations.push(ptr);
+      this._copyToWasmMemory(ptr, bytes);
+      return ptr;
+    };
+    try {
+      const uuidPtr = copyIn(uuidBytes);
+      const certPtr = copyIn(certData);
+      const caCertPtr = caCertData ? copyIn(caCertData) : 0;
+      const signaturePtr = copyIn(signature);
+      const messagePtr = copyIn(messageBytes);
+      const tokenPtr = copyIn(new Uint8Array(this.STATUS_TOKEN_SIZE));
+      const status = this._mldsa_verify_status_cached(
+        uuidPtr, uuidBytes.length,
+        certPtr, certData.length,
+        caCertPtr, caCertData ? caCertData.length : 0,
+        signaturePtr, signature.length,
+        messagePtr, messageBytes.length,
+        ttl,
+        tokenPtr, this.STATUS_TOKEN_SIZE
+      );
+      if (status < 0) throw new Error("Status verification failed");
+      const token = this._copyFromWasmMemory(tokenPtr, this.STATUS_TOKEN_SIZE);
+      return { valid: status === 1, token: Buffer.from(token).toString('base64url') };
+    } finally {
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  /**
+   * Checks a status token from verifyStatusCached() with one MAC, without re-verifying.
+   * The token only vouches for the content it was issued for, so the certificate, signature,
+   * message and CA certificate presented alongside it must be the ones passed to verifyStatusCached().
+   * Revocation is not consulted: a token stays valid until its TTL even if a CRL revokes the signer.
+   * @param {string} uuid - Signature UUID the token was issued for
+   * @param {string} token - base64url token
+   * @param {Uint8Array | string} certData - Signer certificate presented with the token
+   * @param {Uint8Array} signature - Signature presented with the token
+   * @param {string|Uint8Array} message - Message presented with the token
+   * @param {Object} [options]
+   * @param {Uint8Array | string} [options.caCert] - CA certificate the status was checked against, if any
+   * @returns {boolean|null} The attested status, or null if the token is forged, for another UUID
+   * or other content, or expired
+   */
+  checkStatusToken(uuid, token, certData, signature, message, { caCert = null } = {}) {
+    this._ensureInitialized();
+    const encoder = new TextEncoder();
+    const uuidBytes = encoder.encode(uuid);
+    const tokenBytes = new Uint8Array(Buffer.from(token, 'base64url'));
+    const messageBytes = typeof message === 'string' ? encoder.encode(message) : message;
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    const caCertData = caCert ? this._certificateInput(caCert, 'CERTIFICATE') : null;
+    let status;
+    if (this.native) {
+      status = this.native.status_token_check(uuidBytes, certData, caCertData, signature, messageBytes, tokenBytes);
+    } else {
+      this._ensureExport(this._mldsa_status_token_check, 'mldsa_status_token_check');
+      const allocations = [];
+      const copyIn = (bytes) => {
+        const ptr = this.malloc(bytes.length || 1);
+        if (!ptr) throw new Error("Failed to allocate memory for status token");
+        allocations.push(ptr);
+        this._copyToWasmMemory(ptr, bytes);
+        return ptr;
+      };
+      try {
+        const uuidPtr = copyIn(uuidBytes);
+        const certPtr = copyIn(certData);
+        const caCertPtr = caCertData ? copyIn(caCertData) : 0;
+        const signaturePtr = copyIn(signature);
+        const messagePtr = copyIn(messageBytes);
+        const tokenPtr = copyIn(tokenBytes);
+        status = this._mldsa_status_token_check(
+          uuidPtr, uuidBytes.length,
+          certPtr, certData.length,
+          caCertPtr, caCertData ? caCertData.length : 0,
+          signaturePtr, signature.length,
+          messagePtr, messageBytes.length,
+          tokenPtr, tokenBytes.length
+        );
+      } finally {
+        allocations.forEach(ptr => this.free(ptr));
+      }
+    }
+    return status < 0 ? null : status === 1;
+  }
+
+  /**
+   * Installs the status token MAC key shared by every backend node answering QR checks
+   * (otherwise each process uses its own random key). Clears the status cache.
+   * @param {Uint8Array} key - 16 to 32 secret bytes
+   * @throws {Error} If the key length is out of range
+   */
+  setStatusTokenKey(key) {
+    this._ensureInitialized();
+    let ok;
+    if (this.native) {
+      ok = this.native.status_set_key(key);
+    } else {
+      this._ensureExport(this._mldsa_status_set_key, 'mldsa_status_set_key');
+      const keyPtr = this.malloc(key.length || 1);
+      if (!keyPtr) throw new Error("Failed to allocate memory for status token key");
+      try {
+        this._copyToWasmMemory(keyPtr, key);
+        ok = this._mldsa_status_set_key(keyPtr, key.length);
+      } finally {
+        this._copyToWasmMemory(keyPtr, new Uint8Array(key.length));
+        this.free(keyPtr);
+      }
+    }
+    if (!ok) throw new Error("Status token key must be 16 to 32 bytes");
+  }
+
+  /**
+   * Drops every cached QR status.
+   */
+  clearStatusCache() {
+    this._ensureInitialized();
+    if (this.native) {
+      this.native.status_cache_clear();
+    } else if (this._mldsa_status_cache_clear) {
+      this._mldsa_status_cache_clear();
+    }
+  }
+
+  /**
+   * Packs message fields for a binary QR payload (varint count, then length-prefixed fields).
+   * Sign the result and pass it to encodeQrPayload() as the message.
+   * @param {(string|Uint8Array)[]} fields - Message fields; strings are UTF-8 encoded
+   * @returns {Uint8Array} Encoded message
+   */
+  encodeQrMessage(fields) {
+    this._ensureInitialized();
+    const encoder = new TextEncoder();
+    const fieldBytes = fields.map(field => typeof field === 'string' ? encoder.encode(field) : field);
+    if (this.native) {
+      return new Uint8Array(this.native.qr_message_encode(fieldBytes));
+    }
+    this._ensureExport(this._mldsa_qr_message_encode, 'mldsa_qr_message_encode');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for QR message");
+      allocations.push(ptr);
+      return ptr;
+    };
+    try {
+      const ptrTable = alloc(fieldBytes.length * 4);
+      const lenTable = alloc(fieldBytes.length * 4);
+      let capacity = 10;
+      fieldBytes.forEach((field, i) => {
+        const ptr = alloc(field.length);
+        this._copyToWasmMemory(ptr, field);
+        this.module.setValue(ptrTable + i * 4, ptr, 'i32');
+        this.module.setValue(lenTable + i * 4, field.length, 'i32');
+        capacity += 10 + field.length;
+      });
+      const outPtr = alloc(capacity);
+      const len = this._mldsa_qr_message_encode(ptrTable, lenTable, fieldBytes.length, outPtr, capacity);
+      if (len < 0) throw new Error("QR message encoding failed");
+      return this._copyFromWasmMemory(outPtr, len);
+    } finally {
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  /**
+   * Builds a binary QR payload: format version, signer certificate fingerprint, message and raw
+   * signature. About a quarter smaller than the base64 text format.
+   * @param {Uint8Array | string} certData - Signer certificate (only its SHA-256 fingerprint is embedded)
+   * @param {string|Uint8Array} message - The signed message (typically from encodeQrMessage())
+   * @param {Uint8Array} signature - The signature as a byte array
+   * @returns {Uint8Array} Payload for QR byte mode; use splitQrPayload() when it exceeds one symbol
+   */
+  encodeQrPayload(certData, message, signature) {
+    this._ensureInitialized();
+    const messageBytes = typeof message === 'string' ? new TextEncoder().encode(message) : message;
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    if (this.native) {
+      return new Uint8Array(this.native.qr_payload_encode(certData, messageBytes, signature));
+    }
+    this._ensureExport(this._mldsa_qr_payload_encode, 'mldsa_qr_payload_encode');
+
+    const allocations = [];
+    const copyIn = (bytes) => {
+      const ptr = this.malloc(bytes.length || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for QR payload");
+      allocations.push(ptr);
+      this._copyToWasmMemory(ptr, bytes);
+      return ptr;
+    };
+    try {
+      const certPtr = copyIn(certData);
+      const messagePtr = copyIn(messageBytes);
+      const signaturePtr = copyIn(signature);
+      const capacity = 3 + 32 + 20 + messageBytes.length + signature.length;
+      const outPtr = copyIn(new Uint8Array(capacity));
+      const len = this._mldsa_qr_payload_encode(certPtr, certData.length, messagePtr, messageBytes.length,
+        signaturePtr, signature.length, outPtr, capacity);
+      if (len < 0) throw new Error("QR payload encoding failed");
+      return this._copyFromWasmMemory(outPtr, len);
+    } finally {
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  /**
+   * Parses a binary QR payload. message, signature and fields are views into payload, not copies.
+   * @param {Uint8Array} payload - Scanned payload (joinQrPayload() output for multi-symbol codes)
+   * @returns {{version: number, fingerprint: string, message: Uint8Array, signature: Uint8Array, fields: Uint8Array[]|null} | null}
+   *   The parsed payload (fields is null when the message was not built by encodeQrMessage()), or null if malformed
+   */
+  parseQrPayload(payload) {
+    this._ensureInitialized();
+    let parsed;
+    let fieldSpans;
+    if (this.native) {
+      parsed = this.native.qr_payload_parse(payload);
+      if (!parsed) return null;
+      parsed.fingerprint = new Uint8Array(parsed.fingerprint);
+      fieldSpans = this.native.qr_message_fields(payload.subarray(parsed.messageOffset, parsed.messageOffset + parsed.messageLength));
+    } else {
+      this._ensureExport(this._mldsa_qr_payload_parse, 'mldsa_qr_payload_parse');
+      this._ensureExport(this._mldsa_qr_message_fields, 'mldsa_qr_message_fields');
+      const payloadPtr = this.malloc(payload.length || 1);
+      const spansPtr = this.malloc(4 * 4 + 32);
+      // Every field takes at least one byte, so the payload length bounds the field count.
+      const fieldTable = this.malloc((payload.length + 1) * 8);
+      try {
+        if (!payloadPtr || !spansPtr || !fieldTable) throw new Error("Failed to allocate memory for QR payload");
+        this._copyToWasmMemory(payloadPtr, payload);
+        const version = this._mldsa_qr_payload_parse(payloadPtr, payload.length, spansPtr, spansPtr + 16);
+        if (version < 0) return null;
+        const [messageOffset, messageLength, signatureOffset, signatureLength] =
+          [0, 1, 2, 3].map(i => this.module.getValue(spansPtr + i * 4, 'i32'));
+        parsed = { version, fingerprint: this._copyFromWasmMemory(spansPtr + 16, 32), messageOffset, messageLength, signatureOffset, signatureLength };
+        const maxFields = payload.length + 1;
+        const count = this._mldsa_qr_message_fields(payloadPtr + messageOffset, messageLength,
+          fieldTable, fieldTable + maxFields * 4, maxFields);
+        fieldSpans = count < 0 ? null : Array.from({ length: count }, (_, i) => [
+          this.module.getValue(fieldTable + i * 4, 'i32'),
+          this.module.getValue(fieldTable + (maxFields + i) * 4, 'i32'),
+        ]);
+      } finally {
+        if (payloadPtr) this.free(payloadPtr);
+        if (spansPtr) this.free(spansPtr);
+        if (fieldTable) this.free(fieldTable);
+      }
+    }
+    const message = payload.subarray(parsed.messageOffset, parsed.messageOffset + parsed.messageLength);
+    return {
+      version: parsed.version,
+      fingerprint: this._bytesToHex(parsed.fingerprint),
+      message,
+      signature: payload.subarray(parsed.signatureOffset, parsed.signatureOffset + parsed.signatureLength),
+      fields: fieldSpans && fieldSpans.map(([offset, length]) => message.subarray(offset, offset + length)),
+    };
+  }
+
+  /**
+   * Verifies a binary QR payload against the signer certificate. The library reads the message
+   * and signature straight out of the payload bytes.
+   * @param {Uint8Array} payload - Scanned payload
+   * @param {Uint8Array | string} certData - Signer certificate
+   * @returns {boolean} True if the payload was signed under this certificate and the signature is valid
+   * @throws {Error} If the payload is malformed
+   */
+  verifyQrPayload(payload, certData) {
+    this._ensureInitialized();
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    let result;
+    if (this.native) {
+      result = this.native.qr_payload_verify(payload, certData);
+    } else {
+      this._ensureExport(this._mldsa_qr_payload_verify, 'mldsa_qr_payload_verify');
+      const payloadPtr = this.malloc(payload.length || 1);
+      const certPtr = this.malloc(certData.length || 1);
+      try {
+        if (!payloadPtr || !certPtr) throw new Error("Failed to allocate memory for QR payload");
+        this._copyToWasmMemory(payloadPtr, payload);
+        this._copyToWasmMemory(certPtr, certData);
+        result = this._mldsa_qr_payload_verify(payloadPtr, payload.length, certPtr, certData.length);
+      } finally {
+        if (payloadPtr) this.free(payloadPtr);
+        if (certPtr) this.free(certPtr);
+      }
+    }
+    if (result < 0) throw new Error("Malformed QR payload");
+    return result === 1;
+  }
+
+  /**
+   * Splits a payload into a structured-append sequence of at most 16 frames, each small enough
+   * for one QR symbol. Frames carry a 4-byte header, so they can be scanned in any order.
+   * @param {Uint8Array} payload - Payload from encodeQrPayload()
+   * @param {number} [maxFrameSize=QR_MAX_FRAME_SIZE] - Largest frame, header included
+   * @returns {Uint8Array[]} Frames of near-equal size, in sequence order
+   * @throws {Error} If the payload needs more than 16 frames
+   */
+  splitQrPayload(payload, maxFrameSize = this.QR_MAX_FRAME_SIZE) {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.qr_payload_split(payload, maxFrameSize).map(frame => new Uint8Array(frame));
+    }
+    this._ensureExport(this._mldsa_qr_payload_split, 'mldsa_qr_payload_split');
+    const capacity = payload.length + 16 * 4;
+    const payloadPtr = this.malloc(payload.length || 1);
+    const outPtr = this.malloc(capacity);
+    const lensPtr = this.malloc(16 * 4);
+    try {
+      if (!payloadPtr || !outPtr || !lensPtr) throw new Error("Failed to allocate memory for QR frames");
+      this._copyToWasmMemory(payloadPtr, payload);
+      const count = this._mldsa_qr_payload_split(payloadPtr, payload.length, maxFrameSize, outPtr, capacity, lensPtr, 16);
+      if (count < 0) throw new Error("QR payload does not fit 16 frames of the given size");
+      const frames = [];
+      let offset = 0;
+      for (let i = 0; i < count; i++) {
+        const len = this.module.getValue(lensPtr + i * 4, 'i32');
+        frames.push(this._copyFromWasmMemory(outPtr + offset, len));
+        offset += len;
+      }
+      return frames;
+    } finally {
+      if (payloadPtr) this.free(payloadPtr);
+      if (outPtr) this.free(outPtr);
+      if (lensPtr) this.free(lensPtr);
+    }
+  }
+
+  /**
+   * Reassembles a payload from every frame of a structured-append sequence, in any order.
+   * @param {Uint8Array[]} frames - Scanned frames
+   * @returns {Uint8Array} The payload
+   * @throws {Error} If frames are missing, duplicated, from different sequences or corrupt
+   */
+  joinQrPayload(frames) {
+    this._ensureInitialized();
+    if (this.native) {
+      return new Uint8Array(this.native.qr_payload_join(frames));
+    }
+    this._ensureExport(this._mldsa_qr_payload_join, 'mldsa_qr_payload_join');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for QR frames");
+      allocations.push(ptr);
+      return ptr;
+    };
+    try {
+      const ptrTable = alloc(frames.length * 4);
+      const lenTable = alloc(frames.length * 4);
+      let capacity = 0;
+      frames.forEach((frame, i) => {
+        const ptr = alloc(frame.length);
+        this._copyToWasmMemory(ptr, frame);
+        this.module.setValue(ptrTable + i * 4, ptr, 'i32');
+        this.module.setValue(lenTable + i * 4, frame.length, 'i32');
+        capacity += frame.length;
+      });
+      const outPtr = alloc(capacity);
+      const len = this._mldsa_qr_payload_join(ptrTable, lenTable, frames.length, outPtr, capacity);
+      if (len < 0) throw new Error("QR frames are incomplete or corrupt");
+      return this._copyFromWasmMemory(outPtr, len);
+    } finally {
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  // WASM has no refill threads: top the pool up one key pair per turn so requests interleave.
+  _scheduleKeyPairRefill() {
+    if (this.native || this.keyPairRefill) return;
+    this.keyPairRefill = setImmediate(() => {
+      this.keyPairRefill = null;
+      if (this.keyPairPoolActive && this._mldsa_keypair_pool_refill(1) > 0) {
+        this._scheduleKeyPairRefill();
+      }
+    });
+    // A pending refill must not keep the process alive.
+    this.keyPairRefill.unref();
+  }
+
   /**
    * Generates a Certificate Signing Request (CSR) using a private key.
    * @param {Uint8Array} privateKey - The private key as a byte array
@@ -252,6 +1134,9 @@ class MLDSAWrapper {
    */
   async generateCSR(privateKey, publicKey, subjectInfo) {
     this._ensureInitialized();
+    if (this.native) {
+      return new Uint8Array(this.native.generate_csr(privateKey, publicKey, subjectInfo));
+    }
     const csrData = this.malloc(1024 * 1024); // Allocate 1MB for CSR data
     // Allocate memory for the private key
     const privateKeyPtr = this.malloc(privateKey.length);
@@ -305,6 +1190,9 @@ class MLDSAWrapper {
    */
   async generateSelfSignedCertificate(privateKey, csrData,  days = 365) {
     this._ensureInitialized();
+    if (this.native) {
+      return new Uint8Array(this.native.generate_self_signed_certificate(privateKey, csrData, days));
+    }
     // Allocate memory for the private key
     const privateKeyPtr = this.malloc(privateKey.length);
     const csrPtr = this.malloc(csrData.length + 1);
@@ -353,22 +1241,10 @@ class MLDSAWrapper {
    */
   async verifyCertificateIssuedByCA(certData, caCertData) {
     this._ensureInitialized();
-    // Convert certData to Uint8Array if it's a string
-    if (typeof certData === 'string') {
-      certData = new TextEncoder().encode(certData);
-    }
-    // If certData is DER, convert to PEM Uint8Array
-    if (this._isDER(certData)) {
-      certData = this._derToPem(certData, 'CERTIFICATE');
-    }
-
-    // Convert caCertData to Uint8Array if it's a string
-    if (typeof caCertData === 'string') {
-      caCertData = new TextEncoder().encode(caCertData);
-    }
-    // If caCertData is DER, convert to PEM Uint8Array
-    if (this._isDER(caCertData)) {
-      caCertData = this._derToPem(caCertData, 'CERTIFICATE');
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    caCertData = this._certificateInput(caCertData, 'CERTIFICATE');
+    if (this.native) {
+      return this.native.verify_certificate_issued_by_ca(certData, caCertData);
     }
 /*     console.log((new TextDecoder().decode(certData)));
     console.log((new TextDecoder().decode(caCertData))); */
@@ -406,59 +1282,498 @@ class MLDSAWrapper {
   }
 
   /**
-   * Signs a message using ML-DSA-65.
-   * @param {Uint8Array} privateKey - The private key as a byte array
-   * @param {string|Uint8Array} message - The message to sign
-   * @returns {Promise<Uint8Array>} The signature as a byte array
-   * @throws {Error} If signing fails
+   * Drops the cached CA trust stores so the next verifyCertificateIssuedByCA re-parses its CA.
+   * Call after rotating or revoking a CA certificate.
    */
-  async sign(privateKey, message) {
+  clearTrustStoreCache() {
     this._ensureInitialized();
-    // Allocate memory for the private key
-    const privateKeyPtr = this.malloc(privateKey.length);
-    const signaturePtr = this.malloc(1024 * 1024);
-    if (!privateKeyPtr) {
-      throw new Error("Failed to allocate memory for private key");
+    if (this.native) {
+      this.native.clear_trust_store_cache();
+    } else if (this._mldsa_clear_trust_store_cache) {
+      this._mldsa_clear_trust_store_cache();
     }
-    
-    // Convert message to Uint8Array if it's a string
-    const messageBytes = typeof message === 'string' 
-      ? new TextEncoder().encode(message) 
-      : message;
-    
-    // Allocate memory for the message
-    const messagePtr = this.malloc(messageBytes.length);
-    if (!messagePtr) {
-      this.free(privateKeyPtr);
-      throw new Error("Failed to allocate memory for message");
+  }
+
+  /**
+   * Sets how many certificates' verify keys the library keeps cached (0 disables the cache).
+   * @param {number} capacity - Maximum number of cached certificates
+   */
+  setVerifyKeyCacheCapacity(capacity) {
+    this._ensureInitialized();
+    if (this.native) {
+      this.native.set_verify_key_cache_capacity(capacity);
+      return;
     }
-    
+    this._ensureExport(this._mldsa_set_verify_key_cache_capacity, 'mldsa_set_verify_key_cache_capacity');
+    this._mldsa_set_verify_key_cache_capacity(capacity);
+  }
+
+  /**
+   * Returns the verify key cache counters.
+   * @returns {{hits: number, misses: number, entries: number}}
+   */
+  getVerifyKeyCacheStats() {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.verify_key_cache_stats();
+    }
+    this._ensureExport(this._mldsa_get_verify_key_cache_stats, 'mldsa_get_verify_key_cache_stats');
+    // uint64_t hits, uint64_t misses, size_t entries (4 bytes in wasm32)
+    const statsPtr = this.malloc(24);
+    if (!statsPtr) throw new Error("Failed to allocate memory for cache stats");
+    try {
+      this._mldsa_get_verify_key_cache_stats(statsPtr, statsPtr + 8, statsPtr + 16);
+      const view = new DataView(this._copyFromWasmMemory(statsPtr, 20).buffer);
+      return {
+        hits: Number(view.getBigUint64(0, true)),
+        misses: Number(view.getBigUint64(8, true)),
+        entries: view.getUint32(16, true),
+      };
+    } finally {
+      this.free(statsPtr);
+    }
+  }
+
+  /**
+   * Returns the OpenSSL allocations made so far by the WASM module (which is single threaded),
+   * or by the main JS thread when the native addon is loaded.
+   * Only counts once the allocator hooks are installed, which initialize() does when the build has them.
+   * @returns {{heap: number, arena: number}}
+   */
+  getAllocationCounts() {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.thread_allocation_counts();
+    }
+    this._ensureExport(this._mldsa_get_thread_allocation_counts, 'mldsa_get_thread_allocation_counts');
+    const countsPtr = this.malloc(16);
+    if (!countsPtr) throw new Error("Failed to allocate memory for allocation counts");
     try {
+      this._mldsa_get_thread_allocation_counts(countsPtr, countsPtr + 8);
+      const view = new DataView(this._copyFromWasmMemory(countsPtr, 16).buffer);
+      return {
+        heap: Number(view.getBigUint64(0, true)),
+        arena: Number(view.getBigUint64(8, true)),
+      };
+    } finally {
+      this.free(countsPtr);
+    }
+  }
+
+  /**
+   * Returns the library's call counters and latency histograms (per exported function and
+   * per phase: parse, key_import, keygen, sign, verify, encode, output_copy).
+   * Reads from the backend that serves the calls, i.e. the addon when it is loaded.
+   * @param {'json'|'prometheus'} [format='json'] - 'json' returns an object, 'prometheus' the text exposition
+   * @returns {Object|string}
+   */
+  getStats(format = 'json') {
+    this._ensureInitialized();
+    const formatId = format === 'prometheus' ? 1 : 0;
+    let text;
+    if (this.native && this.native.stats_export) {
+      text = this.native.stats_export(formatId);
+    } else {
+      this._ensureExport(this._mldsa_stats_export, 'mldsa_stats_export');
+      const size = 256 * 1024;
+      const outPtr = this.malloc(size);
+      if (!outPtr) throw new Error("Failed to allocate memory for stats");
+      try {
+        const len = this._mldsa_stats_export(formatId, outPtr, size);
+        if (len < 0) throw new Error("Stats export failed");
+        text = this.UTF8ToString(outPtr, len);
+      } finally {
+        this.free(outPtr);
+      }
+    }
+    return formatId === 0 ? JSON.parse(text) : text;
+  }
+
+  /**
+   * Zeroes the library's call counters and latency histograms.
+   */
+  resetStats() {
+    this._ensureInitialized();
+    if (this.native && this.native.stats_reset) {
+      this.native.stats_reset();
+    } else if (this._mldsa_stats_reset) {
+      this._mldsa_stats_reset();
+    }
+  }
+
+  /**
+   * Takes the errors the library queued since the last drain (failures are no longer printed).
+   * Each entry carries a code (openssl, invalid_signature, cert_chain, file_io, invalid_argument),
+   * the failing call, OpenSSL / X509 / errno detail and its reason string.
+   * Errors that did not fit are left for the next call.
+   * @returns {{dropped: number, totals: Object<string, number>, errors: Array<Object>}}
+   */
+  drainErrors() {
+    this._ensureInitialized();
+    let text;
+    if (this.native && this.native.drain_errors) {
+      text = this.native.drain_errors();
+    } else {
+      this._ensureExport(this._mldsa_drain_errors, 'mldsa_drain_errors');
+      const size = 64 * 1024;
+      const outPtr = this.malloc(size);
+      if (!outPtr) throw new Error("Failed to allocate memory for error drain");
+      try {
+        const len = this._mldsa_drain_errors(outPtr, size);
+        if (len < 0) throw new Error("Error drain failed");
+        text = this.UTF8ToString(outPtr, len);
+      } finally {
+        this.free(outPtr);
+      }
+    }
+    return JSON.parse(text);
+  }
+
+  /**
+   * Sets how often (at most) the library prints a one-line error summary to stderr.
+   * @param {number} seconds - Minimum interval between summaries; 0 disables them
+   */
+  setErrorSummaryInterval(seconds) {
+    this._ensureInitialized();
+    if (this.native && this.native.set_error_summary_interval) {
+      this.native.set_error_summary_interval(seconds);
+    }
+    if (this._mldsa_set_error_summary_interval) {
+      this._mldsa_set_error_summary_interval(seconds);
+    }
+  }
+
+  /**
+   * Signs a message using ML-DSA-65.
+   * @param {Uint8Array} privateKey - The private key as a byte array
+   * @param {string|Uint8Array} message - The message to sign
+   * @returns {Promise<Uint8Array>} The signature as a byte array
+   * @throws {Error} If signing fails
+   */
+  async sign(privateKey, message) {
+    this._ensureInitialized();
+    if (this.pool) {
+      return this.pool.sign(privateKey, message);
+    }
+    if (this.native) {
+      return new Uint8Array(this.native.sign_mldsa65(privateKey, message));
+    }
+    // Convert message to Uint8Array if it's a string
+    const messageBytes = typeof message === 'string' 
+      ? new TextEncoder().encode(message) 
+      : message;
+
+    const privateKeyBuf = this._scratch(this.ARENA_PRIVATE_KEY, privateKey.length);
+    let messageBuf = null, signatureBuf = null;
+    try {
+      messageBuf = this._scratch(this.ARENA_MESSAGE, messageBytes.length);
+      signatureBuf = this._scratch(this.ARENA_SIGNATURE, this.ML_DSA_65_SIGNATURE_SIZE);
       // Copy data to WASM memory
-      this._copyToWasmMemory(privateKeyPtr, privateKey);
-      this._copyToWasmMemory(messagePtr, messageBytes);
+      this._copyToWasmMemory(privateKeyBuf.ptr, privateKey);
+      this._copyToWasmMemory(messageBuf.ptr, messageBytes);
       
       // Sign the message
       const result = this._sign_mldsa65(
-        privateKeyPtr,
+        privateKeyBuf.ptr,
+        messageBuf.ptr,
+        messageBytes.length,
+        signatureBuf.ptr,
+        this.ML_DSA_65_SIGNATURE_SIZE
+      );
+      
+      if (!result) {
+        throw new Error("Signing failed");
+      }
+      return this._copyFromWasmMemory(signatureBuf.ptr, result);
+    } finally {
+      if (!privateKeyBuf.owned) this._mldsa_arena_wipe_private_key(this.arena);
+      this._releaseScratch(privateKeyBuf, messageBuf, signatureBuf);
+    }
+  }
+
+  /**
+   * Imports a raw ML-DSA-65 private key once and keeps it parsed inside the module.
+   * Use it for officers that sign many documents in one session. The handle is a number with
+   * the WASM backend and an external object with the native addon.
+   * @param {Uint8Array} privateKey - The private key as a byte array
+   * @returns {number|Object} Opaque key handle; release it with freeKeyHandle()
+   * @throws {Error} If the key cannot be imported
+   */
+  loadPrivateKey(privateKey) {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.load_mldsa65_private_key(privateKey);
+    }
+    this._ensureExport(this._load_mldsa65_private_key, 'load_mldsa65_private_key');
+    return this._loadKeyHandle(this._load_mldsa65_private_key, privateKey, this.ML_DSA_65_PRIVATE_KEY_SIZE);
+  }
+
+  /**
+   * Imports a raw ML-DSA-65 public key once and keeps it parsed inside the module.
+   * @param {Uint8Array} publicKey - The public key as a byte array
+   * @returns {number|Object} Opaque key handle; release it with freeKeyHandle()
+   * @throws {Error} If the key cannot be imported
+   */
+  loadPublicKey(publicKey) {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.load_mldsa65_public_key(publicKey);
+    }
+    this._ensureExport(this._load_mldsa65_public_key, 'load_mldsa65_public_key');
+    return this._loadKeyHandle(this._load_mldsa65_public_key, publicKey, this.ML_DSA_65_PUBLIC_KEY_SIZE);
+  }
+
+  /**
+   * Copies a raw key into the WASM heap and imports it with the given loader.
+   * @private
+   */
+  _loadKeyHandle(loader, key, expectedSize) {
+    if (key.length !== expectedSize) {
+      throw new Error(`Invalid key size: expected ${expectedSize} bytes, got ${key.length}`);
+    }
+    const keyPtr = this.malloc(key.length);
+    if (!keyPtr) {
+      throw new Error("Failed to allocate memory for key");
+    }
+    try {
+      this._copyToWasmMemory(keyPtr, key);
+      const handle = loader(keyPtr);
+      if (!handle) {
+        throw new Error("Key import failed");
+      }
+      return handle;
+    } finally {
+      this.free(keyPtr);
+    }
+  }
+
+  /**
+   * Releases a key handle returned by loadPrivateKey() or loadPublicKey().
+   * @param {number|Object} handle - The key handle
+   */
+  freeKeyHandle(handle) {
+    this._ensureInitialized();
+    if (this.native) {
+      if (handle) this.native.free_mldsa65_key_handle(handle);
+      return;
+    }
+    this._ensureExport(this._free_mldsa65_key_handle, 'free_mldsa65_key_handle');
+    if (handle) this._free_mldsa65_key_handle(handle);
+  }
+
+  /**
+   * Signs a message using a loaded private key handle.
+   * @param {number|Object} handle - Handle returned by loadPrivateKey()
+   * @param {string|Uint8Array} message - The message to sign
+   * @returns {Promise<Uint8Array>} The signature as a byte array
+   * @throws {Error} If signing fails
+   */
+  async signWithHandle(handle, message) {
+    this._ensureInitialized();
+    if (this.native) {
+      return new Uint8Array(this.native.sign_mldsa65_with_handle(handle, message));
+    }
+    this._ensureExport(this._sign_mldsa65_with_handle, 'sign_mldsa65_with_handle');
+    return this._signFixedSize(this._sign_mldsa65_with_handle, handle, message);
+  }
+
+  /**
+   * Creates a reusable signing context for a loaded private key handle.
+   * The context keeps its own reference to the key and must be released with freeSignContext().
+   * @param {number|Object} handle - Handle returned by loadPrivateKey()
+   * @returns {number|Object} Opaque signing context
+   * @throws {Error} If the context cannot be created
+   */
+  createSignContext(handle) {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.new_mldsa65_sign_ctx(handle);
+    }
+    this._ensureExport(this._new_mldsa65_sign_ctx, 'new_mldsa65_sign_ctx');
+    const ctx = this._new_mldsa65_sign_ctx(handle);
+    if (!ctx) {
+      throw new Error("Failed to create signing context");
+    }
+    return ctx;
+  }
+
+  /**
+   * Signs a message using a signing context created by createSignContext().
+   * @param {number|Object} ctx - The signing context
+   * @param {string|Uint8Array} message - The message to sign
+   * @returns {Promise<Uint8Array>} The signature as a byte array
+   * @throws {Error} If signing fails
+   */
+  async signWithContext(ctx, message) {
+    this._ensureInitialized();
+    if (this.native) {
+      return new Uint8Array(this.native.sign_mldsa65_with_ctx(ctx, message));
+    }
+    this._ensureExport(this._sign_mldsa65_with_ctx, 'sign_mldsa65_with_ctx');
+    return this._signFixedSize(this._sign_mldsa65_with_ctx, ctx, message);
+  }
+
+  /**
+   * Releases a signing context created by createSignContext().
+   * @param {number|Object} ctx - The signing context
+   */
+  freeSignContext(ctx) {
+    this._ensureInitialized();
+    if (this.native) {
+      if (ctx) this.native.free_mldsa65_sign_ctx(ctx);
+      return;
+    }
+    this._ensureExport(this._free_mldsa65_sign_ctx, 'free_mldsa65_sign_ctx');
+    if (ctx) this._free_mldsa65_sign_ctx(ctx);
+  }
+
+  /**
+   * Signs a document fed in chunks, e.g. straight from an upload or fs.createReadStream().
+   * Chunks are hashed as they arrive through a fixed staging buffer, so neither JS nor the
+   * WASM heap ever holds the whole file. The signature verifies like one from sign().
+   * Always runs on this instance: async iterables cannot be handed to pool workers.
+   * @param {Uint8Array|number|Object} privateKey - Raw private key, or a handle from loadPrivateKey()
+   * @param {AsyncIterable<Uint8Array|string>|Iterable<Uint8Array|string>} chunks - The document
+   * @returns {Promise<Uint8Array>} The signature as a byte array
+   * @throws {Error} If signing fails
+   */
+  async signStream(privateKey, chunks) {
+    this._ensureInitialized();
+    if (this.native) {
+      return this._signStreamNative(privateKey, chunks);
+    }
+    this._ensureExport(this._new_mldsa65_sign_stream, 'new_mldsa65_sign_stream');
+    const ownsHandle = privateKey instanceof Uint8Array;
+    const handle = ownsHandle ? this.loadPrivateKey(privateKey) : privateKey;
+    const stream = this._new_mldsa65_sign_stream(handle);
+    // Not an arena region: other calls may run while we await the next chunk.
+    const stagingPtr = stream ? this.malloc(this.STREAM_CHUNK_SIZE) : 0;
+    const signaturePtr = stagingPtr ? this.malloc(this.ML_DSA_65_SIGNATURE_SIZE) : 0;
+    try {
+      if (!stream || !stagingPtr || !signaturePtr) {
+        throw new Error("Failed to start streaming signature");
+      }
+      const encoder = new TextEncoder();
+      for await (const chunk of chunks) {
+        const bytes = typeof chunk === 'string' ? encoder.encode(chunk) : chunk;
+        for (let offset = 0; offset < bytes.length; offset += this.STREAM_CHUNK_SIZE) {
+          const slice = bytes.subarray(offset, offset + this.STREAM_CHUNK_SIZE);
+          this._copyToWasmMemory(stagingPtr, slice);
+          if (!this._update_mldsa65_sign_stream(stream, stagingPtr, slice.length)) {
+            throw new Error("Streaming signature update failed");
+          }
+        }
+      }
+      const result = this._final_mldsa65_sign_stream(stream, signaturePtr, this.ML_DSA_65_SIGNATURE_SIZE);
+      if (!result) {
+        throw new Error("Streaming signature failed");
+      }
+      return this._copyFromWasmMemory(signaturePtr, result);
+    } finally {
+      if (signaturePtr) this.free(signaturePtr);
+      if (stagingPtr) this.free(stagingPtr);
+      if (stream) this._free_mldsa65_sign_stream(stream);
+      if (ownsHandle) this.freeKeyHandle(handle);
+    }
+  }
+
+  /**
+   * signStream() through the native addon, which hashes each chunk straight from the JS buffer.
+   * @private
+   */
+  async _signStreamNative(privateKey, chunks) {
+    const ownsHandle = privateKey instanceof Uint8Array;
+    const handle = ownsHandle ? this.loadPrivateKey(privateKey) : privateKey;
+    let stream = null;
+    try {
+      stream = this.native.new_mldsa65_sign_stream(handle);
+      for await (const chunk of chunks) {
+        if (!this.native.update_mldsa65_sign_stream(stream, chunk)) {
+          throw new Error("Streaming signature update failed");
+        }
+      }
+      return new Uint8Array(this.native.final_mldsa65_sign_stream(stream));
+    } finally {
+      if (stream) this.native.free_mldsa65_sign_stream(stream);
+      if (ownsHandle) this.freeKeyHandle(handle);
+    }
+  }
+
+  /**
+   * Signs a message with a handle-based signer into a fixed-size signature buffer.
+   * @private
+   */
+  async _signFixedSize(signer, target, message) {
+    const messageBytes = typeof message === 'string'
+      ? new TextEncoder().encode(message)
+      : message;
+
+    const messagePtr = this.malloc(messageBytes.length || 1);
+    const signaturePtr = this.malloc(this.ML_DSA_65_SIGNATURE_SIZE);
+    if (!messagePtr || !signaturePtr) {
+      if (messagePtr) this.free(messagePtr);
+      if (signaturePtr) this.free(signaturePtr);
+      throw new Error("Failed to allocate memory for message or signature");
+    }
+
+    try {
+      this._copyToWasmMemory(messagePtr, messageBytes);
+      const result = signer(
+        target,
         messagePtr,
         messageBytes.length,
         signaturePtr,
-        1024 * 1024 
+        this.ML_DSA_65_SIGNATURE_SIZE
       );
-      
       if (!result) {
         throw new Error("Signing failed");
       }
-      
-      // Read the signature file from virtual FS
-      const signatureData = this._copyFromWasmMemory(signaturePtr, result);
-      return new Uint8Array(signatureData);
+      return new Uint8Array(this._copyFromWasmMemory(signaturePtr, result));
     } finally {
-      // Free allocated memory
-      if (privateKeyPtr) this.free(privateKeyPtr);
+      this.free(messagePtr);
+      this.free(signaturePtr);
+    }
+  }
+
+  /**
+   * Verifies an ML-DSA-65 signature using a loaded key handle.
+   * @param {number|Object} handle - Handle returned by loadPublicKey() or loadPrivateKey()
+   * @param {Uint8Array} signature - The signature to verify
+   * @param {string|Uint8Array} message - The original message
+   * @returns {Promise<boolean>} True if the signature is valid, false otherwise
+   */
+  async verifyWithHandle(handle, signature, message) {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.verify_mldsa65_with_handle(handle, signature, message);
+    }
+    this._ensureExport(this._verify_mldsa65_with_handle, 'verify_mldsa65_with_handle');
+    const messageBytes = typeof message === 'string'
+      ? new TextEncoder().encode(message)
+      : message;
+
+    const messagePtr = this.malloc(messageBytes.length || 1);
+    const signaturePtr = this.malloc(signature.length || 1);
+    if (!messagePtr || !signaturePtr) {
       if (messagePtr) this.free(messagePtr);
       if (signaturePtr) this.free(signaturePtr);
+      throw new Error("Failed to allocate memory for message or signature");
+    }
+
+    try {
+      this._copyToWasmMemory(messagePtr, messageBytes);
+      this._copyToWasmMemory(signaturePtr, signature);
+      const result = this._verify_mldsa65_with_handle(
+        handle,
+        signaturePtr,
+        signature.length,
+        messagePtr,
+        messageBytes.length
+      );
+      return !!result;
+    } finally {
+      this.free(messagePtr);
+      this.free(signaturePtr);
     }
   }
 
@@ -473,6 +1788,13 @@ class MLDSAWrapper {
    */
   async verify(publicKey, signature, message, signaturePath = '/working/signature.bin') {
     this._ensureInitialized();
+    if (this.pool) {
+      return this.pool.verify(publicKey, signature, message, signaturePath);
+    }
+    if (this.native) {
+      // The addon verifies the signature bytes directly instead of reading signaturePath.
+      return this.native.verify_mldsa65(publicKey, signature, message);
+    }
     
     // Allocate memory for the public key
     const publicKeyPtr = this.malloc(publicKey.length);
@@ -526,62 +1848,479 @@ class MLDSAWrapper {
    */
   async verifyWithCertificate(certData, signatureData, message) {
     this._ensureInitialized();
-    if (typeof certData === 'string') {
-      certData = new TextEncoder().encode(certData);
-    }
-    // If certData is DER, convert to PEM Uint8Array
-    if (this._isDER(certData)) {
-      certData = this._derToPem(certData, 'CERTIFICATE');
+    if (this.pool) {
+      return this.pool.verifyWithCertificate(certData, signatureData, message);
     }
+    certData = this._certificateInput(certData, 'CERTIFICATE');
 
     // Convert signatureData to Uint8Array if it's a string
     if (typeof signatureData === 'string') {
       signatureData = new TextEncoder().encode(signatureData);
     }
     
+    if (this.native) {
+      return this.native.verify_signature_with_cert(certData, signatureData, message);
+    }
+
     // Convert message to Uint8Array if it's a string
     const messageBytes = typeof message === 'string' 
       ? new TextEncoder().encode(message) 
       : message;
-    const certPtr = this.malloc(certData.length + 1);
-    const signaturePtr = this.malloc(signatureData.length + 1);
-    if (!certPtr || !signaturePtr) {
-      if (certPtr) this.free(certPtr);
-      if (signaturePtr) this.free(signaturePtr);
-      throw new Error("Failed to allocate memory for certificate or signature");
-    }
-    // Allocate memory for the message
-    const messagePtr = this.malloc(messageBytes.length);
-    if (!messagePtr) {
-      throw new Error("Failed to allocate memory for message");
-    }
-    // console.log("Certificate Data:", new TextDecoder().decode(certData));
+    const certBuf = this._scratch(this.ARENA_INPUT, certData.length + 1);
+    let signatureBuf = null, messageBuf = null;
     try {
-      // Copy message to WASM memory
-      this._copyToWasmMemory(messagePtr, messageBytes);
-      this._copyToWasmMemory(certPtr, certData);
-      this._copyToWasmMemory(signaturePtr, signatureData);
+      signatureBuf = this._scratch(this.ARENA_SIGNATURE, signatureData.length);
+      messageBuf = this._scratch(this.ARENA_MESSAGE, messageBytes.length);
+      this._copyToWasmMemory(messageBuf.ptr, messageBytes);
+      this._copyToWasmMemory(certBuf.ptr, certData);
+      this._copyToWasmMemory(signatureBuf.ptr, signatureData);
       
       // Verify the signature
       const result = this._verify_signature_with_cert(
-        certPtr,
+        certBuf.ptr,
         certData.length,
-        signaturePtr,
+        signatureBuf.ptr,
         signatureData.length,
-        messagePtr,
+        messageBuf.ptr,
         messageBytes.length
       );
       
       return !!result; // Convert to boolean
     } finally {
-      // Free allocated memory
-      if (messagePtr) this.free(messagePtr);
-      if (certPtr) this.free(certPtr);
-      if (signaturePtr) this.free(signaturePtr);
+      this._releaseScratch(certBuf, signatureBuf, messageBuf);
     }
   }
 
+  /**
+   * Signs many documents with a single ML-DSA-65 signature over a SHA-256 Merkle tree of their
+   * digests. Store the signature once per batch and one small inclusion proof per document
+   * (12 + 32 * ceil(log2(n)) bytes) instead of a 3309-byte signature each.
+   * @param {Uint8Array} privateKey - The private key as a byte array
+   * @param {(string|Uint8Array)[]} documents - Documents to approve
+   * @returns {Promise<{signature: Uint8Array, proofs: Uint8Array[]}>} Batch signature and per-document proofs, in input order
+   * @throws {Error} If signing fails
+   */
+  async signMerkleBatch(privateKey, documents) {
+    this._ensureInitialized();
+    const encoder = new TextEncoder();
+    const docBytes = documents.map(doc => typeof doc === 'string' ? encoder.encode(doc) : doc);
+    if (this.native) {
+      const { signature, proofs } = this.native.merkle_sign_batch(privateKey, docBytes);
+      return { signature: new Uint8Array(signature), proofs: proofs.map(proof => new Uint8Array(proof)) };
+    }
+    this._ensureExport(this._mldsa_merkle_sign_batch, 'mldsa_merkle_sign_batch');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for Merkle batch");
+      allocations.push(ptr);
+      return ptr;
+    };
+    let privateKeyPtr = 0;
+    try {
+      const docPtrs = alloc(docBytes.length * 4);
+      const docLens = alloc(docBytes.length * 4);
+      docBytes.forEach((doc, i) => {
+        const ptr = alloc(doc.length);
+        this._copyToWasmMemory(ptr, doc);
+        this.module.setValue(docPtrs + i * 4, ptr, 'i32');
+        this.module.setValue(docLens + i * 4, doc.length, 'i32');
+      });
+      let depth = 0;
+      for (let width = docBytes.length; width > 1; width = Math.ceil(width / 2)) depth++;
+      const proofCapacity = docBytes.length * (12 + 32 * depth);
+      const proofsPtr = alloc(proofCapacity);
+      const proofLens = alloc(docBytes.length * 4);
+      const signaturePtr = alloc(this.ML_DSA_65_SIGNATURE_SIZE);
+      privateKeyPtr = alloc(privateKey.length);
+      this._copyToWasmMemory(privateKeyPtr, privateKey);
 
+      const sigLen = this._mldsa_merkle_sign_batch(privateKeyPtr, docPtrs, docLens, docBytes.length,
+        signaturePtr, this.ML_DSA_65_SIGNATURE_SIZE, proofsPtr, proofCapacity, proofLens);
+      if (sigLen < 0) throw new Error("Merkle batch signing failed");
+      const proofs = [];
+      let offset = 0;
+      for (let i = 0; i < docBytes.length; i++) {
+        const len = this.module.getValue(proofLens + i * 4, 'i32');
+        proofs.push(this._copyFromWasmMemory(proofsPtr + offset, len));
+        offset += len;
+      }
+      return { signature: this._copyFromWasmMemory(signaturePtr, sigLen), proofs };
+    } finally {
+      if (privateKeyPtr) this._copyToWasmMemory(privateKeyPtr, new Uint8Array(privateKey.length));
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  /**
+   * Checks one document of a batch signed by signMerkleBatch().
+   * @param {Uint8Array} publicKey - The public key as a byte array
+   * @param {Uint8Array} signature - The batch signature
+   * @param {Uint8Array} proof - The document's inclusion proof
+   * @param {string|Uint8Array} document - The document
+   * @returns {Promise<boolean>} True if the document is in the signed batch
+   * @throws {Error} If the proof is malformed
+   */
+  async verifyMerkleProof(publicKey, signature, proof, document) {
+    return this._verifyMerkle(publicKey, null, signature, proof, document);
+  }
+
+  /**
+   * Same as verifyMerkleProof(), with the signer certificate instead of a raw public key.
+   * @param {Uint8Array | string} certData - Signer certificate (PEM or DER)
+   * @param {Uint8Array} signature - The batch signature
+   * @param {Uint8Array} proof - The document's inclusion proof
+   * @param {string|Uint8Array} document - The document
+   * @returns {Promise<boolean>} True if the document is in the signed batch
+   * @throws {Error} If the proof is malformed
+   */
+  async verifyMerkleProofWithCertificate(certData, signature, proof, document) {
+    return this._verifyMerkle(null, this._certificateInput(certData, 'CERTIFICATE'), signature, proof, document);
+  }
+
+  /**
+   * Shared body of verifyMerkleProof and verifyMerkleProofWithCertificate; exactly one of publicKey / certData is set.
+   * @private
+   */
+  _verifyMerkle(publicKey, certData, signature, proof, document) {
+    this._ensureInitialized();
+    const docBytes = typeof document === 'string' ? new TextEncoder().encode(document) : document;
+    const keyBytes = publicKey || certData;
+    let result;
+    if (this.native) {
+      result = publicKey
+        ? this.native.merkle_verify(publicKey, signature, proof, docBytes)
+        : this.native.merkle_verify_with_cert(certData, signature, proof, docBytes);
+    } else {
+      if (publicKey) {
+        this._ensureExport(this._mldsa_merkle_verify, 'mldsa_merkle_verify');
+      } else {
+        this._ensureExport(this._mldsa_merkle_verify_with_cert, 'mldsa_merkle_verify_with_cert');
+      }
+      const allocations = [];
+      const copyIn = (bytes) => {
+        const ptr = this.malloc(bytes.length || 1);
+        if (!ptr) throw new Error("Failed to allocate memory for Merkle proof");
+        allocations.push(ptr);
+        this._copyToWasmMemory(ptr, bytes);
+        return ptr;
+      };
+      try {
+        const keyPtr = copyIn(keyBytes);
+        const signaturePtr = copyIn(signature);
+        const proofPtr = copyIn(proof);
+        const docPtr = copyIn(docBytes);
+        result = publicKey
+          ? this._mldsa_merkle_verify(keyPtr, signaturePtr, signature.length, proofPtr, proof.length, docPtr, docBytes.length)
+          : this._mldsa_merkle_verify_with_cert(keyPtr, certData.length, signaturePtr, signature.length,
+            proofPtr, proof.length, docPtr, docBytes.length);
+      } finally {
+        allocations.forEach(ptr => this.free(ptr));
+      }
+    }
+    if (result < 0) throw new Error("Malformed Merkle proof");
+    return result === 1;
+  }
+
+  /**
+   * Opens the append-only signature store, replacing per-application signature files.
+   * Records live in memory-mapped segment files under dir and are found through an
+   * in-memory index by signature UUID, rebuilt from the segments on open.
+   * @param {string} dir - Store directory (created if missing)
+   * @param {Object} [options]
+   * @param {number} [options.segmentSize=0] - Segment file size in bytes; 0 for the library default (64 MiB)
+   * @throws {Error} If the store cannot be opened
+   */
+  openSignatureStore(dir, { segmentSize = 0 } = {}) {
+    this._ensureInitialized();
+    let ok;
+    if (this.native) {
+      ok = this.native.sig_store_open(dir, segmentSize);
+    } else {
+      this._ensureExport(this._mldsa_sig_store_open, 'mldsa_sig_store_open');
+      ok = this._mldsa_sig_store_open(dir, segmentSize);
+    }
+    if (!ok) throw new Error(`Failed to open signature store at ${dir}`);
+  }
+
+  /**
+   * Syncs and closes the signature store.
+   */
+  closeSignatureStore() {
+    this._ensureInitialized();
+    if (this.native) {
+      this.native.sig_store_close();
+    } else if (this._mldsa_sig_store_close) {
+      this._mldsa_sig_store_close();
+    }
+  }
+
+  /**
+   * Stores a signature and the message it signs under a signature UUID, replacing any earlier record.
+   * @param {string} uuid - Signature UUID
+   * @param {string|Uint8Array} message - The signed message
+   * @param {Uint8Array} signature - The raw signature
+   * @param {Object} [options]
+   * @param {boolean} [options.durable=true] - Return only once the record is on disk; concurrent
+   *   durable puts share one sync. Pass false for bulk loads and call syncSignatureStore() after.
+   * @throws {Error} If the record cannot be written
+   */
+  putSignature(uuid, message, signature, { durable = true } = {}) {
+    this._ensureInitialized();
+    const encoder = new TextEncoder();
+    const keyBytes = encoder.encode(uuid);
+    const messageBytes = typeof message === 'string' ? encoder.encode(message) : message;
+    let ok;
+    if (this.native) {
+      ok = this.native.sig_store_put(keyBytes, messageBytes, signature, durable);
+    } else {
+      this._ensureExport(this._mldsa_sig_store_put, 'mldsa_sig_store_put');
+      const allocations = [];
+      const copyIn = (bytes) => {
+        const ptr = this.malloc(bytes.length || 1);
+        if (!ptr) throw new Error("Failed to allocate memory for signature record");
+        allocations.push(ptr);
+        this._copyToWasmMemory(ptr, bytes);
+        return ptr;
+      };
+      try {
+        ok = this._mldsa_sig_store_put(copyIn(keyBytes), keyBytes.length, copyIn(messageBytes), messageBytes.length,
+          copyIn(signature), signature.length, durable ? 1 : 0);
+      } finally {
+        allocations.forEach(ptr => this.free(ptr));
+      }
+    }
+    if (!ok) throw new Error("Failed to store signature");
+  }
+
+  /**
+   * Fetches a stored signature: one index lookup and one copy out of the mapped segment.
+   * @param {string} uuid - Signature UUID
+   * @returns {{message: Uint8Array, signature: Uint8Array} | null} The record, or null if not stored
+   */
+  getSignature(uuid) {
+    this._ensureInitialized();
+    const keyBytes = new TextEncoder().encode(uuid);
+    if (this.native) {
+      const record = this.native.sig_store_get(keyBytes);
+      return record && { message: new Uint8Array(record.message), signature: new Uint8Array(record.signature) };
+    }
+    this._ensureExport(this._mldsa_sig_store_get, 'mldsa_sig_store_get');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for signature record");
+      allocations.push(ptr);
+      return ptr;
+    };
+    try {
+      const keyPtr = alloc(keyBytes.length);
+      this._copyToWasmMemory(keyPtr, keyBytes);
+      const lensPtr = alloc(8); // two size_t (4 bytes in wasm32)
+      // Size probe first: with no buffers the call reports the record's lengths.
+      let found = this._mldsa_sig_store_get(keyPtr, keyBytes.length, 0, 0, lensPtr, 0, 0, lensPtr + 4);
+      if (found === 0) return null;
+      const messageLength = this.module.getValue(lensPtr, 'i32');
+      const signatureLength = this.module.getValue(lensPtr + 4, 'i32');
+      const messagePtr = alloc(messageLength);
+      const signaturePtr = alloc(signatureLength);
+      found = this._mldsa_sig_store_get(keyPtr, keyBytes.length, messagePtr, messageLength, lensPtr,
+        signaturePtr, signatureLength, lensPtr + 4);
+      // Deleted or replaced by a larger record between the two calls
+      if (found !== 1) return found === 0 ? null : this.getSignature(uuid);
+      return {
+        message: this._copyFromWasmMemory(messagePtr, messageLength),
+        signature: this._copyFromWasmMemory(signaturePtr, signatureLength),
+      };
+    } finally {
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
+
+  /**
+   * Verifies a stored signature against its stored message without copying either out of the store.
+   * @param {string} uuid - Signature UUID
+   * @param {Uint8Array | string} certData - Signer certificate
+   * @returns {Promise<boolean|null>} Whether the signature is valid, or null if it is not stored
+   */
+  async verifyStoredSignature(uuid, certData) {
+    this._ensureInitialized();
+    const keyBytes = new TextEncoder().encode(uuid);
+    certData = this._certificateInput(certData, 'CERTIFICATE');
+    let result;
+    if (this.native) {
+      result = this.native.sig_store_verify_with_cert(keyBytes, certData);
+    } else {
+      this._ensureExport(this._mldsa_sig_store_verify_with_cert, 'mldsa_sig_store_verify_with_cert');
+      const keyPtr = this.malloc(keyBytes.length || 1);
+      const certPtr = this.malloc(certData.length || 1);
+      try {
+        if (!keyPtr || !certPtr) throw new Error("Failed to allocate memory for stored signature check");
+        this._copyToWasmMemory(keyPtr, keyBytes);
+        this._copyToWasmMemory(certPtr, certData);
+        result = this._mldsa_sig_store_verify_with_cert(keyPtr, keyBytes.length, certPtr, certData.length);
+      } finally {
+        if (keyPtr) this.free(keyPtr);
+        if (certPtr) this.free(certPtr);
+      }
+    }
+    return result < 0 ? null : result === 1;
+  }
+
+  /**
+   * Deletes a stored signature.
+   * @param {string} uuid - Signature UUID
+   * @returns {boolean} True if it was stored
+   */
+  deleteSignature(uuid) {
+    this._ensureInitialized();
+    const keyBytes = new TextEncoder().encode(uuid);
+    if (this.native) {
+      return this.native.sig_store_delete(keyBytes);
+    }
+    this._ensureExport(this._mldsa_sig_store_delete, 'mldsa_sig_store_delete');
+    const keyPtr = this.malloc(keyBytes.length || 1);
+    if (!keyPtr) throw new Error("Failed to allocate memory for signature key");
+    try {
+      this._copyToWasmMemory(keyPtr, keyBytes);
+      return !!this._mldsa_sig_store_delete(keyPtr, keyBytes.length);
+    } finally {
+      this.free(keyPtr);
+    }
+  }
+
+  /**
+   * Syncs every signature stored so far (after putSignature(..., { durable: false })).
+   * @throws {Error} If the sync fails
+   */
+  syncSignatureStore() {
+    this._ensureInitialized();
+    let ok;
+    if (this.native) {
+      ok = this.native.sig_store_sync();
+    } else {
+      this._ensureExport(this._mldsa_sig_store_sync, 'mldsa_sig_store_sync');
+      ok = this._mldsa_sig_store_sync();
+    }
+    if (!ok) throw new Error("Failed to sync signature store");
+  }
+
+  /**
+   * Rewrites the live records of mostly-dead segments and removes the old segment files.
+   * @param {number} [maxLiveRatio=0.5] - Compact sealed segments whose live fraction is at most this
+   * @returns {number} Segments reclaimed
+   * @throws {Error} If compaction fails
+   */
+  compactSignatureStore(maxLiveRatio = 0.5) {
+    this._ensureInitialized();
+    let reclaimed;
+    if (this.native) {
+      reclaimed = this.native.sig_store_compact(maxLiveRatio);
+    } else {
+      this._ensureExport(this._mldsa_sig_store_compact, 'mldsa_sig_store_compact');
+      reclaimed = this._mldsa_sig_store_compact(maxLiveRatio);
+    }
+    if (reclaimed < 0) throw new Error("Signature store compaction failed");
+    return reclaimed;
+  }
+
+  /**
+   * Returns the signature store counters.
+   * @returns {{records: number, segments: number, bytes: number, deadBytes: number}}
+   */
+  getSignatureStoreStats() {
+    this._ensureInitialized();
+    if (this.native) {
+      return this.native.sig_store_stats();
+    }
+    this._ensureExport(this._mldsa_sig_store_stats, 'mldsa_sig_store_stats');
+    const statsPtr = this.malloc(32);
+    if (!statsPtr) throw new Error("Failed to allocate memory for store stats");
+    try {
+      this._mldsa_sig_store_stats(statsPtr, statsPtr + 8, statsPtr + 16, statsPtr + 24);
+      const view = new DataView(this._copyFromWasmMemory(statsPtr, 32).buffer);
+      return {
+        records: Number(view.getBigUint64(0, true)),
+        segments: Number(view.getBigUint64(8, true)),
+        bytes: Number(view.getBigUint64(16, true)),
+        deadBytes: Number(view.getBigUint64(24, true)),
+      };
+    } finally {
+      this.free(statsPtr);
+    }
+  }
+
+  /**
+   * Verifies many signatures against a shared certificate table in one call.
+   * Each certificate is parsed once, which makes nightly audit sweeps much cheaper
+   * than calling verifyWithCertificate() per document.
+   * @param {(Uint8Array|string)[]} certificates - Certificate table (PEM or DER)
+   * @param {{certIndex: number, signature: Uint8Array, message: string|Uint8Array}[]} items - Signatures to verify
+   * @returns {Promise<boolean[]>} Per-item verification results, in input order
+   * @throws {Error} If the batch cannot be submitted
+   */
+  async verifySignatureBatch(certificates, items) {
+    this._ensureInitialized();
+    const encoder = new TextEncoder();
+    const certBytes = certificates.map(cert => this._certificateInput(cert, 'CERTIFICATE'));
+    const signatureBytes = items.map(item => item.signature);
+    const messageBytes = items.map(item => typeof item.message === 'string' ? encoder.encode(item.message) : item.message);
+    if (this.native) {
+      // 0 threads: one worker per core inside the addon
+      return this.native.verify_signature_batch(certBytes, items.map(item => item.certIndex),
+        signatureBytes, messageBytes, 0);
+    }
+    this._ensureExport(this._verify_signature_batch, 'verify_signature_batch');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for signature batch");
+      allocations.push(ptr);
+      return ptr;
+    };
+    // Copies each buffer into the heap and returns [pointer table, length table].
+    const packBuffers = (buffers) => {
+      const ptrTable = alloc(buffers.length * 4);
+      const lenTable = alloc(buffers.length * 4);
+      buffers.forEach((buf, i) => {
+        const ptr = alloc(buf.length);
+        this._copyToWasmMemory(ptr, buf);
+        this.module.setValue(ptrTable + i * 4, ptr, 'i32');
+        this.module.setValue(lenTable + i * 4, buf.length, 'i32');
+      });
+      return [ptrTable, lenTable];
+    };
+
+    try {
+      const [certPtrs, certLens] = packBuffers(certBytes);
+      const [sigPtrs, sigLens] = packBuffers(signatureBytes);
+      const [msgPtrs, msgLens] = packBuffers(messageBytes);
+      const indexTable = alloc(items.length * 4);
+      items.forEach((item, i) => this.module.setValue(indexTable + i * 4, item.certIndex, 'i32'));
+      const bitmapSize = Math.ceil(items.length / 8);
+      const bitmapPtr = alloc(bitmapSize);
+
+      const result = this._verify_signature_batch(
+        certPtrs, certLens, certBytes.length,
+        indexTable,
+        sigPtrs, sigLens,
+        msgPtrs, msgLens,
+        items.length,
+        bitmapPtr, bitmapSize,
+        0
+      );
+      if (result < 0) {
+        throw new Error("Batch signature verification failed");
+      }
+      const bitmap = this._copyFromWasmMemory(bitmapPtr, bitmapSize);
+      return items.map((_, i) => (bitmap[i >> 3] & (1 << (i & 7))) !== 0);
+    } finally {
+      allocations.forEach(ptr => this.free(ptr));
+    }
+  }
 
   /**
    * Signs a certificate with a CA certificate and private key.
@@ -589,69 +2328,139 @@ class MLDSAWrapper {
    * @param {Uint8Array | string} csrData - The CSR data as a byte array
    * @param {Uint8Array | string} caCertData - The CA certificate data as a byte array
    * @param {number} [days=365] - Validity period in days
+   * @param {Object} [options]
+   * @param {'pem'|'der'} [options.format='pem'] - Encoding of the returned certificate
    * @returns {Promise<Uint8Array>} The signed certificate as a byte array
    * @throws {Error} If certificate signing fails
    */
-  async signCertificate(caPrivateKey, csrData, caCertData, days = 365) {
-    this._ensureInitialized();
-
+  async signCertificate(caPrivateKey, csrData, caCertData, days = 365, options = {}) {
     this._ensureInitialized();
-    if (typeof csrData === 'string') {
-      csrData = new TextEncoder().encode(csrData);
-    }
-    if (this._isDER(csrData)) {
-      csrData = this._derToPem(csrData, 'CERTIFICATE REQUEST');
+    if (this.pool) {
+      return this.pool.signCertificate(caPrivateKey, csrData, caCertData, days, options);
     }
+    const derOutput = options.format === 'der';
 
-    // Convert caCertData to Uint8Array PEM if needed
-    if (typeof caCertData === 'string') {
-      caCertData = new TextEncoder().encode(caCertData);
-    }
-    if (this._isDER(caCertData)) {
-      caCertData = this._derToPem(caCertData, 'CERTIFICATE');
+    csrData = this._certificateInput(csrData, 'CERTIFICATE REQUEST');
+    caCertData = this._certificateInput(caCertData, 'CERTIFICATE');
+    if (this.native) {
+      const sign = derOutput ? this.native.sign_certificate_der : this.native.sign_certificate;
+      return new Uint8Array(sign(caPrivateKey, csrData, caCertData, days));
     }
-    // Allocate memory for the CA private key
-    const caPrivateKeyPtr = this.malloc(caPrivateKey.length);
-    const csrPtr = this.malloc(csrData.length + 1); 
-    const caCertPtr = this.malloc(caCertData.length + 1); 
-    const certPtr = this.malloc(1024 * 1024); // Allocate 1MB for signed certificate data
-    if (!caPrivateKeyPtr) {
-      throw new Error("Failed to allocate memory for CA private key");
+    if (derOutput) {
+      this._ensureExport(this._sign_certificate_der, 'sign_certificate_der');
     }
-    
+    const signCertificate = derOutput ? this._sign_certificate_der : this._sign_certificate;
+    const caPrivateKeyBuf = this._scratch(this.ARENA_PRIVATE_KEY, caPrivateKey.length);
+    let csrBuf = null, caCertBuf = null, certBuf = null;
     try {
-      // Copy CA private key to WASM memory
-      this._copyToWasmMemory(caPrivateKeyPtr, caPrivateKey);
-      this._copyToWasmMemory(csrPtr, csrData);
-      this._copyToWasmMemory(caCertPtr, caCertData);
-      
-      // Write CSR and CA certificate to virtual FS
+      csrBuf = this._scratch(this.ARENA_INPUT, csrData.length + 1);
+      caCertBuf = this._scratch(this.ARENA_CA_INPUT, caCertData.length + 1);
+      certBuf = this._scratch(this.ARENA_OUTPUT, this.PEM_CAPACITY);
+      // Copy CA private key, CSR and CA certificate to WASM memory
+      this._copyToWasmMemory(caPrivateKeyBuf.ptr, caPrivateKey);
+      this._copyToWasmMemory(csrBuf.ptr, csrData);
+      this._copyToWasmMemory(caCertBuf.ptr, caCertData);
       
       // Sign the certificate
-      const result = this._sign_certificate(
-        csrPtr,
+      const result = signCertificate(
+        csrBuf.ptr,
         csrData.length,
-        caCertPtr,
+        caCertBuf.ptr,
         caCertData.length,
-        caPrivateKeyPtr,
+        caPrivateKeyBuf.ptr,
         caPrivateKey.length,
-        certPtr,
-        1024 * 1024, 
+        certBuf.ptr,
+        this.PEM_CAPACITY,
         days
       );
       if (!result) {
         throw new Error("Certificate signing failed");
       }
-      
-      // Read the signed certificate file from virtual FS
-      const signedCertData = this._copyFromWasmMemory(certPtr, result);
-      return new Uint8Array(signedCertData);
+      return this._copyFromWasmMemory(certBuf.ptr, result);
     } finally {
-      // Free allocated memory
-      if (caPrivateKeyPtr) this.free(caPrivateKeyPtr);
-      if (csrPtr) this.free(csrPtr);
-      if (caCertPtr) this.free(caCertPtr);
-      if (certPtr) this.free(certPtr);
+      if (!caPrivateKeyBuf.owned) this._mldsa_arena_wipe_private_key(this.arena);
+      this._releaseScratch(caPrivateKeyBuf, csrBuf, caCertBuf, certBuf);
+    }
+  }
+
+  /**
+   * Issues one certificate per CSR under a single CA. The CA certificate and key are parsed once
+   * for the whole batch and, with the native backend, the CSRs are signed across worker threads.
+   * A bad CSR fails only its own item.
+   * @param {Uint8Array} caPrivateKey - The CA private key as a byte array
+   * @param {Array<Uint8Array | string>} csrs - CSRs (PEM or DER)
+   * @param {Uint8Array | string} caCertData - The CA certificate
+   * @param {number} [days=365] - Validity period in days
+   * @param {Object} [options]
+   * @param {'pem'|'der'} [options.format='pem'] - Encoding of the returned certificates
+   * @param {number} [options.threads=0] - Worker threads, 0 for one per core (native backend only)
+   * @returns {Promise<Array<{status: number, certificate: Uint8Array|null}>>} One entry per CSR, in order;
+   *   status is one of ISSUE_OK, ISSUE_BAD_CSR, ISSUE_SIGN_FAILED, ISSUE_NO_SPACE
+   * @throws {Error} If the CA certificate or key is unusable
+   */
+  async signCertificatesBatch(caPrivateKey, csrs, caCertData, days = 365, options = {}) {
+    this._ensureInitialized();
+    const derOutput = options.format === 'der';
+    const csrBytes = csrs.map(csr => this._certificateInput(csr, 'CERTIFICATE REQUEST'));
+    caCertData = this._certificateInput(caCertData, 'CERTIFICATE');
+    if (this.native) {
+      return this.native.sign_certificates_batch(caPrivateKey, csrBytes, caCertData, days, derOutput, options.threads || 0)
+        .map(({ status, certificate }) => ({ status, certificate: certificate && new Uint8Array(certificate) }));
+    }
+    this._ensureExport(this._sign_certificates_batch, 'sign_certificates_batch');
+
+    const allocations = [];
+    const alloc = (size) => {
+      const ptr = this.malloc(size || 1);
+      if (!ptr) throw new Error("Failed to allocate memory for certificate batch");
+      allocations.push(ptr);
+      return ptr;
+    };
+    let caPrivateKeyPtr = 0;
+    try {
+      const csrPtrs = alloc(csrBytes.length * 4);
+      const csrLens = alloc(csrBytes.length * 4);
+      csrBytes.forEach((csr, i) => {
+        const ptr = alloc(csr.length);
+        this._copyToWasmMemory(ptr, csr);
+        this.module.setValue(csrPtrs + i * 4, ptr, 'i32');
+        this.module.setValue(csrLens + i * 4, csr.length, 'i32');
+      });
+      const caCertPtr = alloc(caCertData.length);
+      this._copyToWasmMemory(caCertPtr, caCertData);
+      caPrivateKeyPtr = alloc(caPrivateKey.length);
+      this._copyToWasmMemory(caPrivateKeyPtr, caPrivateKey);
+      // Every certificate fits in PEM_CAPACITY, so ISSUE_NO_SPACE cannot happen here.
+      const outSize = Math.max(1, csrBytes.length) * this.PEM_CAPACITY;
+      const outPtr = alloc(outSize);
+      const lensPtr = alloc(csrBytes.length * 4);
+      const statusPtr = alloc(csrBytes.length * 4);
+
+      const issued = this._sign_certificates_batch(
+        csrPtrs, csrLens, csrBytes.length,
+        caCertPtr, caCertData.length,
+        caPrivateKeyPtr, caPrivateKey.length,
+        days, derOutput ? 1 : 0,
+        outPtr, outSize,
+        lensPtr, statusPtr,
+        0
+      );
+      if (issued < 0) {
+        throw new Error("Batch certificate signing failed");
+      }
+      let offset = 0;
+      return csrBytes.map((_, i) => {
+        const status = this.module.getValue(statusPtr + i * 4, 'i32');
+        if (status !== this.ISSUE_OK) return { status, certificate: null };
+        const len = this.module.getValue(lensPtr + i * 4, 'i32');
+        const certificate = this._copyFromWasmMemory(outPtr + offset, len);
+        offset += len;
+        return { status, certificate };
+      });
+    } finally {
+      // Do not leave the CA key behind in freed heap memory.
+      if (caPrivateKeyPtr) this._copyToWasmMemory(caPrivateKeyPtr, new Uint8Array(caPrivateKey.length));
+      allocations.forEach(ptr => this.free(ptr));
     }
   }
 
@@ -692,15 +2501,38 @@ class MLDSAWrapper {
     this._ensureInitialized();
     return new Uint8Array(this.FS.readFile(path));
   }
+  /**
+   * DER always starts with a SEQUENCE tag; PEM starts with "-----BEGIN" or whitespace.
+   * @private
+   */
   _isDER(data) {
-    return data instanceof Uint8Array && !(new TextDecoder().decode(data).includes('-----BEGIN'));
+    return data instanceof Uint8Array && data.length > 0 && data[0] === 0x30;
+  }
+
+  /**
+   * Prepares a certificate or CSR for the library. DER is passed through untouched when the
+   * library parses it natively; only older WASM builds still need the PEM round-trip.
+   * @private
+   * @param {Uint8Array|string} data - PEM string, PEM bytes or DER bytes
+   * @param {string} label - PEM label used for the fallback conversion
+   * @returns {Uint8Array}
+   */
+  _certificateInput(data, label) {
+    if (typeof data === 'string') {
+      return new TextEncoder().encode(data);
+    }
+    if (this._isDER(data) && !this.native && !this._sign_certificate_der) {
+      return this._derToPem(data, label);
+    }
+    return data;
   }
 
   /**
    * Helper to convert DER Uint8Array to PEM Uint8Array.
    */
   _derToPem(der, label) {
-    const base64 = btoa(String.fromCharCode(...der));
+    // Spreading a large certificate into String.fromCharCode can overflow the call stack.
+    const base64 = Buffer.from(der.buffer, der.byteOffset, der.byteLength).toString('base64');
     const pem = `-----BEGIN ${label}-----\n${base64.match(/.{1,64}/g).join('\n')}\n-----END ${label}-----\n`;
     return new TextEncoder().encode(pem);
   }
@@ -708,6 +2540,13 @@ class MLDSAWrapper {
 
 // Export the wrapper class
 const Mldsa_wrapper = new MLDSAWrapper();
-Mldsa_wrapper.initialize();
+// Pool workers import this module for the class only; they must not start their own instance.
+if (isMainThread) {
+  const poolSize = Number(process.env.MLDSA_POOL_SIZE) || 0;
+  // Failures are logged by initialize(); later calls throw from _ensureInitialized().
+  Mldsa_wrapper.initialize()
+    .then(() => poolSize > 0 ? Mldsa_wrapper.enablePool(poolSize) : undefined)
+    .catch(() => {});
+}
 export default Mldsa_wrapper;
 export { MLDSAWrapper }; // Export the class for direct use if needed
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "mldsa_lib.h"
+
+// src/arena.cpp
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <openssl/crypto.h>
+
+struct mldsa_arena {
+    unsigned char *region[MLDSA_ARENA_REGION_COUNT];
+    size_t capacity[MLDSA_ARENA_REGION_COUNT];
+};
+
+static bool is_fixed_region(int region) {
+    return region == MLDSA_ARENA_PRIVATE_KEY || region == MLDSA_ARENA_PUBLIC_KEY || region == MLDSA_ARENA_SIGNATURE;
+}
+
+static bool is_valid_region(int region) {
+    return region >= 0 && region < MLDSA_ARENA_REGION_COUNT;
+}
+
+mldsa_arena* mldsa_arena_new(size_t message_capacity) {
+    mldsa_arena *arena = new (std::nothrow) mldsa_arena{};
+    if (!arena) {
+        return nullptr;
+    }
+    arena->capacity[MLDSA_ARENA_PRIVATE_KEY] = ml_dsa_65_private_key_size;
+    arena->capacity[MLDSA_ARENA_PUBLIC_KEY] = ml_dsa_65_public_key_size;
+    arena->capacity[MLDSA_ARENA_SIGNATURE] = ml_dsa_65_signature_size;
+    arena->capacity[MLDSA_ARENA_MESSAGE] = message_capacity > 0 ? message_capacity : 1;
+    arena->capacity[MLDSA_ARENA_INPUT] = mldsa_arena_pem_capacity;
+    arena->capacity[MLDSA_ARENA_CA_INPUT] = mldsa_arena_pem_capacity;
+    arena->capacity[MLDSA_ARENA_OUTPUT] = mldsa_arena_pem_capacity;
+
+    for (int i = 0; i < MLDSA_ARENA_REGION_COUNT; ++i) {
+        arena->region[i] = static_cast<unsigned char*>(malloc(arena->capacity[i]));
+        if (!arena->region[i]) {
+            mldsa_arena_free(arena);
+            return nullptr;
+        }
+    }
+    return arena;
+}
+
+void mldsa_arena_free(mldsa_arena *arena) {
+    if (!arena) {
+        return;
+    }
+    mldsa_arena_wipe_private_key(arena);
+    for (int i = 0; i < MLDSA_ARENA_REGION_COUNT; ++i) {
+        free(arena->region[i]);
+    }
+    delete arena;
+}
+
+unsigned char* mldsa_arena_region_ptr(mldsa_arena *arena, int region) {
+    if (!arena || !is_valid_region(region)) {
+        return nullptr;
+    }
+    return arena->region[region];
+}
+
+size_t mldsa_arena_region_size(mldsa_arena *arena, int region) {
+    if (!arena || !is_valid_region(region)) {
+        return 0;
+    }
+    return arena->capacity[region];
+}
+
+unsigned char* mldsa_arena_reserve(mldsa_arena *arena, int region, size_t size) {
+    if (!arena || !is_valid_region(region)) {
+        return nullptr;
+    }
+    if (size <= arena->capacity[region]) {
+        return arena->region[region];
+    }
+    if (is_fixed_region(region)) {
+        return nullptr;
+    }
+    // Grow geometrically so a stream of slightly larger documents does not realloc every call.
+    size_t new_capacity = arena->capacity[region];
+    while (new_capacity < size) {
+        new_capacity = new_capacity > SIZE_MAX / 2 ? size : new_capacity * 2;
+    }
+    unsigned char *grown = static_cast<unsigned char*>(realloc(arena->region[region], new_capacity));
+    if (!grown) {
+        return nullptr;
+    }
+    arena->region[region] = grown;
+    arena->capacity[region] = new_capacity;
+    return grown;
+}
+
+void mldsa_arena_wipe_private_key(mldsa_arena *arena) {
+    if (arena && arena->region[MLDSA_ARENA_PRIVATE_KEY]) {
+        OPENSSL_cleanse(arena->region[MLDSA_ARENA_PRIVATE_KEY], arena->capacity[MLDSA_ARENA_PRIVATE_KEY]);
+    }
+}
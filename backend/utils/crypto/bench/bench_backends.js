@@ -0,0 +1,77 @@
+/**
+ * @file bench_backends.js
+ * @description Throughput comparison of the WASM and native (N-API) builds of the
+ * ML-DSA library for sign, verify (with certificate) and sign_certificate.
+ *
+ * Usage (from backend/utils/crypto, after `npx node-gyp rebuild`):
+ *   node bench/bench_backends.js [iterations] [--markdown]
+ *
+ * --markdown prints the table in the form kept in bench/README.md.
+ */
+import os from 'node:os';
+import { MLDSAWrapper } from '../MLDSAWrapper.js';
+
+const args = process.argv.slice(2);
+const markdown = args.includes('--markdown');
+const iterations = Number(args.find(arg => arg !== '--markdown')) || 200;
+const message = 'Birth registration #12345 approved by SYT officer.';
+
+async function timeOps(label, fn) {
+  // Warm up once so lazy provider loading is not measured.
+  await fn();
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) {
+    await fn();
+  }
+  const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+  return { label, opsPerSec: (iterations * 1000) / elapsedMs, meanMs: elapsedMs / iterations };
+}
+
+async function runBackend(backend) {
+  const wrapper = new MLDSAWrapper('./mldsa_lib.js', { backend });
+  await wrapper.initialize();
+  if (backend === 'native' && !wrapper.native) {
+    throw new Error('native backend requested but the addon is not loaded');
+  }
+
+  const ca = await wrapper.generateKeyPair();
+  const caCsr = await wrapper.generateCSR(ca.privateKey, ca.publicKey, ['C=VN', 'CN=Bench CA']);
+  const caCert = await wrapper.generateSelfSignedCertificate(ca.privateKey, caCsr);
+  const officer = await wrapper.generateKeyPair();
+  const officerCsr = await wrapper.generateCSR(officer.privateKey, officer.publicKey, ['C=VN', 'CN=Bench Officer']);
+  const officerCert = await wrapper.signCertificate(ca.privateKey, officerCsr, caCert);
+  const signature = await wrapper.sign(officer.privateKey, message);
+
+  return [
+    await timeOps('sign', () => wrapper.sign(officer.privateKey, message)),
+    await timeOps('verifyWithCertificate', () => wrapper.verifyWithCertificate(officerCert, signature, message)),
+    await timeOps('signCertificate', () => wrapper.signCertificate(ca.privateKey, officerCsr, caCert)),
+  ];
+}
+
+const results = { wasm: await runBackend('wasm') };
+try {
+  results.native = await runBackend('native');
+} catch (error) {
+  console.warn(`Skipping native backend: ${error.message}`);
+}
+
+if (markdown) {
+  console.log(`\n${iterations} iterations per operation, Node ${process.versions.node}, ${os.cpus()[0]?.model ?? 'unknown CPU'}\n`);
+  console.log('| operation | wasm ops/s | native ops/s | speedup |');
+  console.log('|-----------|-----------:|-------------:|--------:|');
+} else {
+  console.log(`\nML-DSA-65 throughput, ${iterations} iterations per operation`);
+  console.log('operation                 wasm ops/s   native ops/s   speedup');
+}
+results.wasm.forEach((wasmResult, i) => {
+  const nativeResult = results.native?.[i];
+  const wasmOps = wasmResult.opsPerSec.toFixed(1);
+  const nativeOps = nativeResult ? nativeResult.opsPerSec.toFixed(1) : 'n/a';
+  const speedup = nativeResult ? (nativeResult.opsPerSec / wasmResult.opsPerSec).toFixed(2) + 'x' : 'n/a';
+  if (markdown) {
+    console.log(`| \`${wasmResult.label}\` | ${wasmOps} | ${nativeOps} | ${speedup} |`);
+  } else {
+    console.log(`${wasmResult.label.padEnd(24)} ${wasmOps.padStart(11)}   ${nativeOps.padStart(12)}   ${speedup.padStart(7)}`);
+  }
+});
@@ -0,0 +1,113 @@
+// bench/bench_codec.cpp
+// Throughput of the vector codec (codec.cpp) against the OpenSSL BIO path it replaces,
+// for signature-, certificate- and scan-sized inputs.
+//
+// Build with the "Compile benchmark with clang" task, then run:
+//   ./bench/bench_codec [iterations]
+#include "../mldsa_lib.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+template<typename F>
+static double mb_per_s(size_t bytes, int iterations, F&& op) {
+    op(); // warm up
+    auto start = clock_type::now();
+    for (int i = 0; i < iterations; ++i) op();
+    double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return bytes * (double) iterations / seconds / 1e6;
+}
+
+// --- BIO baselines (the pre-codec helper.cpp / PEM paths) ---
+static std::string bio_base64_encode(const std::vector<unsigned char>& input) {
+    BIO *b64 = BIO_new(BIO_f_base64());
+    BIO *mem = BIO_new(BIO_s_mem());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    BIO_push(b64, mem);
+    BIO_write(b64, input.data(), (int) input.size());
+    BIO_flush(b64);
+    BUF_MEM *buf = nullptr;
+    BIO_get_mem_ptr(mem, &buf);
+    std::string out(buf->data, buf->length);
+    BIO_free_all(b64);
+    return out;
+}
+
+static size_t bio_base64_decode(const std::string& input, std::vector<unsigned char>& out) {
+    BIO *b64 = BIO_new(BIO_f_base64());
+    BIO *mem = BIO_new_mem_buf(input.data(), (int) input.size());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    BIO_push(b64, mem);
+    int len = BIO_read(b64, out.data(), (int) out.size());
+    BIO_free_all(b64);
+    return len > 0 ? (size_t) len : 0;
+}
+
+static std::string bio_pem_armor(const std::vector<unsigned char>& der) {
+    BIO *mem = BIO_new(BIO_s_mem());
+    PEM_write_bio(mem, "CERTIFICATE", "", der.data(), (long) der.size());
+    char *data = nullptr;
+    long len = BIO_get_mem_data(mem, &data);
+    std::string out(data, len);
+    BIO_free(mem);
+    return out;
+}
+
+static size_t bio_pem_dearmor(const std::string& pem) {
+    BIO *mem = BIO_new_mem_buf(pem.data(), (int) pem.size());
+    char *name = nullptr, *header = nullptr;
+    unsigned char *data = nullptr;
+    long len = 0;
+    PEM_read_bio(mem, &name, &header, &data, &len);
+    OPENSSL_free(name);
+    OPENSSL_free(header);
+    OPENSSL_free(data);
+    BIO_free(mem);
+    return (size_t) len;
+}
+
+static void run(const char *label, size_t size, int iterations) {
+    std::mt19937 rng(42);
+    std::vector<unsigned char> data(size);
+    for (auto& b : data) b = (unsigned char) rng();
+
+    std::string b64((size + 2) / 3 * 4 + 1, '\0');
+    long b64_len = mldsa_base64_encode(data.data(), size, &b64[0], b64.size());
+    b64.resize(b64_len);
+    std::string hex(size * 2 + 1, '\0');
+    std::string pem(size * 2 + 128, '\0');
+    std::vector<unsigned char> decoded(size + 16);
+    std::string bio_pem = bio_pem_armor(data);
+
+    printf("%s (%zu bytes)\n", label, size);
+    printf("  base64 encode  codec %9.1f MB/s   BIO %9.1f MB/s\n",
+           mb_per_s(size, iterations, [&] { mldsa_base64_encode(data.data(), size, &b64[0], b64.size() + 1); }),
+           mb_per_s(size, iterations, [&] { bio_base64_encode(data); }));
+    printf("  base64 decode  codec %9.1f MB/s   BIO %9.1f MB/s\n",
+           mb_per_s(size, iterations, [&] { mldsa_base64_decode(b64.data(), b64.size(), decoded.data(), decoded.size()); }),
+           mb_per_s(size, iterations, [&] { bio_base64_decode(b64, decoded); }));
+    printf("  PEM armor      codec %9.1f MB/s   BIO %9.1f MB/s\n",
+           mb_per_s(size, iterations, [&] { mldsa_pem_armor("CERTIFICATE", data.data(), size, &pem[0], pem.size()); }),
+           mb_per_s(size, iterations, [&] { bio_pem_armor(data); }));
+    printf("  PEM dearmor    codec %9.1f MB/s   BIO %9.1f MB/s\n",
+           mb_per_s(size, iterations, [&] { mldsa_pem_dearmor(bio_pem.data(), bio_pem.size(), "CERTIFICATE", decoded.data(), decoded.size()); }),
+           mb_per_s(size, iterations, [&] { bio_pem_dearmor(bio_pem); }));
+    printf("  hex encode     codec %9.1f MB/s\n",
+           mb_per_s(size, iterations, [&] { mldsa_hex_encode(data.data(), size, &hex[0], hex.size()); }));
+    printf("  hex decode     codec %9.1f MB/s\n",
+           mb_per_s(size, iterations, [&] { mldsa_hex_decode(hex.data(), size * 2, decoded.data(), decoded.size()); }));
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+    if (iterations <= 0) iterations = 2000;
+    printf("codec backend: %s\n", mldsa_codec_backend());
+    run("signature", ml_dsa_65_signature_size, iterations);
+    run("certificate", 7400, iterations);
+    run("document scan", 1 << 20, iterations / 100 > 0 ? iterations / 100 : 1);
+    return 0;
+}
@@ -0,0 +1,108 @@
+// bench/bench_issuance_alloc.cpp
+// OpenSSL allocation counts and throughput of sign_certificate with the per-request
+// issuance arena off (general heap) and on.
+//
+// Build with the "Compile benchmark with clang" task, then run:
+//   ./bench/bench_issuance_alloc [iterations] [threads]
+#include "../mldsa_lib.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+struct issuance_fixture {
+    std::vector<char> ca_private_key = std::vector<char>(ml_dsa_65_private_key_size);
+    std::vector<char> ca_cert = std::vector<char>(mldsa_arena_pem_capacity);
+    std::vector<char> csr = std::vector<char>(mldsa_arena_pem_capacity);
+    int ca_cert_len = 0;
+    int csr_len = 0;
+};
+
+static bool make_fixture(issuance_fixture& f) {
+    std::vector<char> ca_public_key(ml_dsa_65_public_key_size);
+    std::vector<char> private_key(ml_dsa_65_private_key_size);
+    std::vector<char> public_key(ml_dsa_65_public_key_size);
+    std::vector<char> ca_csr(mldsa_arena_pem_capacity);
+    char ca_subject[] = "CN=Bench CA";
+    char subject[] = "CN=Bench Officer";
+    char *ca_subject_vec[] = {ca_subject};
+    char *subject_vec[] = {subject};
+
+    if (!generate_mldsa65_keypair(f.ca_private_key.data(), ca_public_key.data()) ||
+        !generate_mldsa65_keypair(private_key.data(), public_key.data())) {
+        return false;
+    }
+    int ca_csr_len = generate_csr(f.ca_private_key.data(), ca_public_key.data(), ca_subject_vec, 1, ca_csr.data(), ca_csr.size());
+    f.ca_cert_len = ca_csr_len > 0
+        ? generate_self_signed_certificate(ca_csr.data(), ca_csr_len, f.ca_private_key.data(), f.ca_cert.data(), f.ca_cert.size(), 365)
+        : 0;
+    f.csr_len = generate_csr(private_key.data(), public_key.data(), subject_vec, 1, f.csr.data(), f.csr.size());
+    return f.ca_cert_len > 0 && f.csr_len > 0;
+}
+
+static bool issue(const issuance_fixture& f, std::vector<char>& out) {
+    return sign_certificate(f.csr.data(), f.csr_len, f.ca_cert.data(), f.ca_cert_len,
+                            f.ca_private_key.data(), ml_dsa_65_private_key_size,
+                            out.data(), out.size(), 365) > 0;
+}
+
+static void run(const char *label, const issuance_fixture& f, int iterations, int threads) {
+    // Single thread: allocations per issuance on this thread.
+    std::vector<char> out(mldsa_arena_pem_capacity);
+    uint64_t heap_before, arena_before, heap_after, arena_after;
+    mldsa_get_thread_allocation_counts(&heap_before, &arena_before);
+    for (int i = 0; i < iterations; ++i) {
+        if (!issue(f, out)) {
+            fprintf(stderr, "%s: sign_certificate failed\n", label);
+            return;
+        }
+    }
+    mldsa_get_thread_allocation_counts(&heap_after, &arena_after);
+
+    // Concurrent issuance throughput.
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            std::vector<char> thread_out(mldsa_arena_pem_capacity);
+            for (int i = 0; i < iterations; ++i) {
+                issue(f, thread_out);
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-12s heap allocs/op %8.1f   arena allocs/op %8.1f   %d threads: %8.1f certs/s\n",
+           label,
+           double(heap_after - heap_before) / iterations,
+           double(arena_after - arena_before) / iterations,
+           threads,
+           iterations * threads / seconds);
+}
+
+int main(int argc, char **argv) {
+    // Must run before anything else touches OpenSSL.
+    if (!mldsa_install_allocator_hooks()) {
+        fprintf(stderr, "OpenSSL allocator hooks could not be installed\n");
+        return 1;
+    }
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    int threads = argc > 2 ? atoi(argv[2]) : (int) std::thread::hardware_concurrency();
+    if (iterations <= 0) iterations = 200;
+    if (threads <= 0) threads = 1;
+
+    issuance_fixture fixture;
+    if (!make_fixture(fixture)) {
+        fprintf(stderr, "failed to build CA / CSR fixture\n");
+        return 1;
+    }
+
+    printf("sign_certificate, %d iterations\n", iterations);
+    mldsa_set_issuance_arena_enabled(false);
+    run("heap", fixture, iterations, threads);
+    mldsa_set_issuance_arena_enabled(true);
+    run("arena", fixture, iterations, threads);
+    return 0;
+}
@@ -0,0 +1,189 @@
+// bench/bench_mldsa.cpp
+// Latency, throughput and OpenSSL allocations per call for every exported key, certificate,
+// signing and verification entry point. Run it before and after a change and attach both
+// tables to the PR.
+//
+// Build with the "Compile benchmark with clang" task, then run:
+//   ./bench/bench_mldsa [iterations] [message_bytes] [filter]
+// `filter` keeps only the operations whose name contains it, e.g. "verify".
+#include "../mldsa_lib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+struct bench_fixture {
+    std::vector<char> ca_private_key = std::vector<char>(ml_dsa_65_private_key_size);
+    std::vector<char> ca_public_key = std::vector<char>(ml_dsa_65_public_key_size);
+    std::vector<char> private_key = std::vector<char>(ml_dsa_65_private_key_size);
+    std::vector<char> public_key = std::vector<char>(ml_dsa_65_public_key_size);
+    std::vector<char> ca_csr = std::vector<char>(mldsa_arena_pem_capacity);
+    std::vector<char> ca_cert = std::vector<char>(mldsa_arena_pem_capacity);
+    std::vector<char> csr = std::vector<char>(mldsa_arena_pem_capacity);
+    std::vector<char> cert = std::vector<char>(mldsa_arena_pem_capacity);
+    std::vector<unsigned char> signature = std::vector<unsigned char>(ml_dsa_65_signature_size);
+    std::vector<char> message;
+    std::string signature_path;
+    int ca_csr_len = 0;
+    int ca_cert_len = 0;
+    int csr_len = 0;
+    int cert_len = 0;
+    int signature_len = 0;
+};
+
+static char ca_subject[] = "CN=Bench CA";
+static char subject[] = "CN=Bench Officer";
+static char *ca_subject_vec[] = {ca_subject};
+static char *subject_vec[] = {subject};
+
+static bool make_fixture(bench_fixture& f, size_t message_len) {
+    f.message.assign(message_len, 'm');
+    if (!generate_mldsa65_keypair(f.ca_private_key.data(), f.ca_public_key.data()) ||
+        !generate_mldsa65_keypair(f.private_key.data(), f.public_key.data())) {
+        return false;
+    }
+    f.ca_csr_len = generate_csr(f.ca_private_key.data(), f.ca_public_key.data(), ca_subject_vec, 1, f.ca_csr.data(), f.ca_csr.size());
+    f.ca_cert_len = f.ca_csr_len > 0
+        ? generate_self_signed_certificate(f.ca_csr.data(), f.ca_csr_len, f.ca_private_key.data(), f.ca_cert.data(), f.ca_cert.size(), 365)
+        : 0;
+    f.csr_len = generate_csr(f.private_key.data(), f.public_key.data(), subject_vec, 1, f.csr.data(), f.csr.size());
+    f.cert_len = f.ca_cert_len > 0 && f.csr_len > 0
+        ? sign_certificate(f.csr.data(), f.csr_len, f.ca_cert.data(), f.ca_cert_len,
+                           f.ca_private_key.data(), ml_dsa_65_private_key_size, f.cert.data(), f.cert.size(), 365)
+        : 0;
+    f.signature_len = sign_mldsa65(f.private_key.data(), f.message.data(), f.message.size(), f.signature.data(), f.signature.size());
+    if (f.cert_len <= 0 || f.signature_len <= 0) {
+        return false;
+    }
+
+    // verify_mldsa65 reads the signature from a file.
+    f.signature_path = "bench_mldsa_signature.bin";
+    FILE *file = fopen(f.signature_path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool written = fwrite(f.signature.data(), 1, f.signature_len, file) == (size_t) f.signature_len;
+    return fclose(file) == 0 && written;
+}
+
+static void report(const char *name, std::vector<double>& samples_us, uint64_t allocs) {
+    std::sort(samples_us.begin(), samples_us.end());
+    double total = 0;
+    for (double s : samples_us) total += s;
+    size_t n = samples_us.size();
+    printf("%-34s %10.1f ops/s   p50 %9.1f us   p99 %9.1f us   %8.1f allocs/op\n",
+           name,
+           total > 0 ? n * 1e6 / total : 0.0,
+           samples_us[n / 2],
+           samples_us[std::min(n - 1, (n * 99) / 100)],
+           double(allocs) / n);
+}
+
+static bool run(const char *name, const char *filter, int iterations, const std::function<bool()>& op) {
+    if (filter && !strstr(name, filter)) {
+        return true;
+    }
+    // Warm up once so provider loading and first-use caches are not measured.
+    if (!op()) {
+        fprintf(stderr, "%s failed\n", name);
+        return false;
+    }
+    std::vector<double> samples_us;
+    samples_us.reserve(iterations);
+    uint64_t heap_before, arena_before, heap_after, arena_after;
+    mldsa_get_thread_allocation_counts(&heap_before, &arena_before);
+    for (int i = 0; i < iterations; ++i) {
+        auto start = bench_clock::now();
+        if (!op()) {
+            fprintf(stderr, "%s failed at iteration %d\n", name, i);
+            return false;
+        }
+        samples_us.push_back(std::chrono::duration<double, std::micro>(bench_clock::now() - start).count());
+    }
+    mldsa_get_thread_allocation_counts(&heap_after, &arena_after);
+    report(name, samples_us, (heap_after - heap_before) + (arena_after - arena_before));
+    return true;
+}
+
+int main(int argc, char **argv) {
+    // Must run before anything else touches OpenSSL, otherwise allocs/op reads 0.
+    if (!mldsa_install_allocator_hooks()) {
+        fprintf(stderr, "OpenSSL allocator hooks could not be installed; allocs/op will read 0\n");
+    }
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    size_t message_len = argc > 2 ? strtoul(argv[2], nullptr, 10) : 512;
+    const char *filter = argc > 3 ? argv[3] : nullptr;
+    if (iterations <= 0) iterations = 200;
+
+    bench_fixture f;
+    if (!make_fixture(f, message_len)) {
+        fprintf(stderr, "failed to build key / certificate fixture\n");
+        return 1;
+    }
+
+    std::vector<char> private_key(ml_dsa_65_private_key_size);
+    std::vector<char> public_key(ml_dsa_65_public_key_size);
+    std::vector<char> out(mldsa_arena_pem_capacity);
+    std::vector<unsigned char> signature(ml_dsa_65_signature_size);
+
+    printf("ML-DSA-65 library, %d iterations, %zu-byte message\n", iterations, message_len);
+    bool ok = run("generate_mldsa65_keypair", filter, iterations, [&] {
+        return generate_mldsa65_keypair(private_key.data(), public_key.data());
+    });
+    ok = ok && run("generate_csr", filter, iterations, [&] {
+        return generate_csr(f.private_key.data(), f.public_key.data(), subject_vec, 1, out.data(), out.size()) > 0;
+    });
+    ok = ok && run("generate_self_signed_certificate", filter, iterations, [&] {
+        return generate_self_signed_certificate(f.ca_csr.data(), f.ca_csr_len, f.ca_private_key.data(), out.data(), out.size(), 365) > 0;
+    });
+    ok = ok && run("sign_certificate", filter, iterations, [&] {
+        return sign_certificate(f.csr.data(), f.csr_len, f.ca_cert.data(), f.ca_cert_len,
+                                f.ca_private_key.data(), ml_dsa_65_private_key_size, out.data(), out.size(), 365) > 0;
+    });
+    // One op = one batch of batch_size CSRs under a CA parsed once.
+    constexpr size_t batch_size = 16;
+    std::vector<const char*> batch_csrs(batch_size, f.csr.data());
+    std::vector<size_t> batch_csr_lens(batch_size, static_cast<size_t>(f.csr_len));
+    std::vector<char> batch_out(batch_size * mldsa_arena_pem_capacity);
+    std::vector<size_t> batch_lens(batch_size);
+    std::vector<int> batch_status(batch_size);
+    ok = ok && run("sign_certificates_batch (16 CSRs)", filter, iterations, [&] {
+        return sign_certificates_batch(batch_csrs.data(), batch_csr_lens.data(), batch_size, f.ca_cert.data(), f.ca_cert_len,
+                                       f.ca_private_key.data(), ml_dsa_65_private_key_size, 365, false,
+                                       batch_out.data(), batch_out.size(), batch_lens.data(), batch_status.data(), 0)
+               == static_cast<long>(batch_size);
+    });
+    ok = ok && run("sign_mldsa65", filter, iterations, [&] {
+        return sign_mldsa65(f.private_key.data(), f.message.data(), f.message.size(), signature.data(), signature.size()) > 0;
+    });
+    // One op = one signature plus proofs for merkle_docs documents; compare with merkle_docs x sign_mldsa65.
+    constexpr size_t merkle_docs = 256;
+    std::vector<const char*> merkle_bufs(merkle_docs, f.message.data());
+    std::vector<size_t> merkle_lens(merkle_docs, f.message.size());
+    std::vector<unsigned char> merkle_proofs(merkle_docs * (12 + 32 * 8));
+    std::vector<size_t> merkle_proof_lens(merkle_docs);
+    ok = ok && run("mldsa_merkle_sign_batch (256 docs)", filter, iterations, [&] {
+        return mldsa_merkle_sign_batch(f.private_key.data(), merkle_bufs.data(), merkle_lens.data(), merkle_docs,
+                                       signature.data(), signature.size(), merkle_proofs.data(), merkle_proofs.size(),
+                                       merkle_proof_lens.data()) > 0;
+    });
+    ok = ok && run("verify_mldsa65", filter, iterations, [&] {
+        return verify_mldsa65(f.public_key.data(), f.signature_path.c_str(), f.message.data(), (int) f.message.size());
+    });
+    ok = ok && run("verify_signature_with_cert", filter, iterations, [&] {
+        return verify_signature_with_cert(f.cert.data(), f.cert_len, f.signature.data(), f.signature_len,
+                                          f.message.data(), (int) f.message.size());
+    });
+    ok = ok && run("verify_certificate_issued_by_ca", filter, iterations, [&] {
+        return verify_certificate_issued_by_ca(f.cert.data(), f.cert_len, f.ca_cert.data(), f.ca_cert_len);
+    });
+
+    remove(f.signature_path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file bench_mldsa.js
+ * @description WASM counterpart of bench_mldsa.cpp: ops/s, p50/p99 latency and OpenSSL
+ * allocations per call for every exported key, certificate, signing and verification
+ * entry point, measured through MLDSAWrapper as the backend uses it.
+ *
+ * Usage (from backend/utils/crypto):
+ *   node bench/bench_mldsa.js [iterations] [message_bytes] [filter]
+ */
+import { MLDSAWrapper } from '../MLDSAWrapper.js';
+
+const iterations = Number(process.argv[2]) || 200;
+const messageBytes = Number(process.argv[3]) || 512;
+const filter = process.argv[4];
+const message = new Uint8Array(messageBytes).fill(0x6d);
+const signaturePath = '/bench_signature.bin';
+
+const wrapper = new MLDSAWrapper('./mldsa_lib.js', { backend: 'wasm' });
+await wrapper.initialize();
+
+// Builds without the allocator hooks cannot count allocations; report n/a instead of 0.
+function allocationTotal() {
+  try {
+    const counts = wrapper.getAllocationCounts();
+    return counts.heap + counts.arena;
+  } catch {
+    return null;
+  }
+}
+
+// requiredExport is the wrapper's cwrap of an optional export: a WASM build without it prints
+// n/a for that row instead of aborting the rest of the table.
+async function run(label, fn, requiredExport) {
+  if (filter && !label.includes(filter)) return;
+  if (requiredExport === null) {
+    console.log(`${label.padEnd(34)} ${'n/a'.padStart(10)} ops/s   (not exported by this build)`);
+    return;
+  }
+  // Warm up once so lazy provider loading is not measured.
+  if (!(await fn())) throw new Error(`${label} failed`);
+  const samples = new Float64Array(iterations);
+  const allocsBefore = allocationTotal();
+  for (let i = 0; i < iterations; i++) {
+    const start = process.hrtime.bigint();
+    if (!(await fn())) throw new Error(`${label} failed at iteration ${i}`);
+    samples[i] = Number(process.hrtime.bigint() - start) / 1e3;
+  }
+  const allocsAfter = allocationTotal();
+
+  samples.sort();
+  const totalUs = samples.reduce((sum, s) => sum + s, 0);
+  const p50 = samples[Math.floor(iterations / 2)];
+  const p99 = samples[Math.min(iterations - 1, Math.floor((iterations * 99) / 100))];
+  const allocs = allocsBefore === null ? 'n/a' : ((allocsAfter - allocsBefore) / iterations).toFixed(1);
+  console.log(
+    `${label.padEnd(34)} ${((iterations * 1e6) / totalUs).toFixed(1).padStart(10)} ops/s` +
+    `   p50 ${p50.toFixed(1).padStart(9)} us   p99 ${p99.toFixed(1).padStart(9)} us` +
+    `   ${allocs.padStart(8)} allocs/op`
+  );
+}
+
+const ca = await wrapper.generateKeyPair();
+const caCsr = await wrapper.generateCSR(ca.privateKey, ca.publicKey, ['CN=Bench CA']);
+const caCert = await wrapper.generateSelfSignedCertificate(ca.privateKey, caCsr);
+const officer = await wrapper.generateKeyPair();
+const officerCsr = await wrapper.generateCSR(officer.privateKey, officer.publicKey, ['CN=Bench Officer']);
+const officerCert = await wrapper.signCertificate(ca.privateKey, officerCsr, caCert);
+const signature = await wrapper.sign(officer.privateKey, message);
+// verify_mldsa65 reads the signature from the virtual filesystem.
+wrapper.saveToVirtualFS(signaturePath, signature);
+
+console.log(`ML-DSA-65 library (wasm), ${iterations} iterations, ${messageBytes}-byte message`);
+await run('generate_mldsa65_keypair', async () => !!(await wrapper.generateKeyPair()));
+await run('generate_csr', async () => !!(await wrapper.generateCSR(officer.privateKey, officer.publicKey, ['CN=Bench Officer'])));
+await run('generate_self_signed_certificate', async () => !!(await wrapper.generateSelfSignedCertificate(ca.privateKey, caCsr)));
+await run('sign_certificate', async () => !!(await wrapper.signCertificate(ca.privateKey, officerCsr, caCert)));
+await run('sign_certificates_batch (16 CSRs)', async () =>
+  (await wrapper.signCertificatesBatch(ca.privateKey, new Array(16).fill(officerCsr), caCert)).every(r => r.status === wrapper.ISSUE_OK),
+  wrapper._sign_certificates_batch);
+await run('sign_mldsa65', async () => !!(await wrapper.sign(officer.privateKey, message)));
+await run('mldsa_merkle_sign_batch (256 docs)', async () =>
+  (await wrapper.signMerkleBatch(officer.privateKey, new Array(256).fill(message))).proofs.length === 256,
+  wrapper._mldsa_merkle_sign_batch);
+await run('verify_mldsa65', () => wrapper.verify(officer.publicKey, signature, message, signaturePath));
+await run('verify_signature_with_cert', () => wrapper.verifyWithCertificate(officerCert, signature, message));
+await run('verify_certificate_issued_by_ca', () => wrapper.verifyCertificateIssuedByCA(officerCert, caCert));
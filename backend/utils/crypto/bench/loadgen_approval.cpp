@@ -0,0 +1,296 @@
+// bench/loadgen_approval.cpp
+// Offline replay of the citizen approval workflow (birth registration, BCA / SYT approval,
+// QR lookup) against the library, with N concurrent officers. Every iteration is one
+// citizen application:
+//
+//   keygen          generate_mldsa65_keypair for the applicant
+//   csr             generate_csr
+//   issue           sign_certificate by the CA
+//   applicant_sign  applicant signs the application
+//   officer_verify  officer checks the applicant signature against the issued certificate
+//   officer_sign    officer signs {applicant signature, time}, as sytController does
+//   qr_verify       QR lookup: officer signature against the officer certificate, plus
+//                   the officer certificate against the CA
+//
+// Arrivals are open loop: each officer starts applications on a fixed schedule, and latency
+// counts from the scheduled start. Once the library falls behind, queueing shows up in the
+// end-to-end percentiles instead of silently lowering the offered rate. A rate of 0 runs
+// closed loop (as fast as possible) and reports saturation throughput.
+//
+// Build with the "Compile benchmark with clang" task, then run:
+//   ./bench/loadgen_approval [officers] [rate_per_s | 0 | sweep] [seconds]
+// "sweep" measures saturation first, then offers 25%..150% of it to locate the knee.
+#include "../mldsa_lib.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+enum stage {
+    stage_keygen,
+    stage_csr,
+    stage_issue,
+    stage_applicant_sign,
+    stage_officer_verify,
+    stage_officer_sign,
+    stage_qr_verify,
+    stage_end_to_end,
+    stage_count
+};
+
+static const char *stage_names[stage_count] = {
+    "keygen", "csr", "issue", "applicant_sign", "officer_verify", "officer_sign", "qr_verify", "end_to_end"
+};
+
+// Log-linear histogram: 8 sub-buckets per power of two of microseconds, so every bucket is
+// within 12.5% of its neighbours. Per thread, merged after the run.
+struct latency_histogram {
+    static constexpr int sub_buckets = 8;
+    static constexpr int octaves = 32;
+    std::vector<uint64_t> counts = std::vector<uint64_t>(sub_buckets * octaves);
+    uint64_t total = 0;
+    double max_us = 0;
+
+    static int bucket_of(double us) {
+        if (us < 1) return 0;
+        int octave = std::min(octaves - 1, (int) std::floor(std::log2(us)));
+        int sub = (int) ((us / std::ldexp(1.0, octave) - 1.0) * sub_buckets);
+        return octave * sub_buckets + std::min(sub, sub_buckets - 1);
+    }
+    static double upper_bound_us(int bucket) {
+        int octave = bucket / sub_buckets, sub = bucket % sub_buckets;
+        return std::ldexp(1.0, octave) * (1.0 + double(sub + 1) / sub_buckets);
+    }
+
+    void record(double us) {
+        counts[bucket_of(us)]++;
+        total++;
+        max_us = std::max(max_us, us);
+    }
+    void merge(const latency_histogram& other) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total += other.total;
+        max_us = std::max(max_us, other.max_us);
+    }
+    double percentile(double p) const {
+        uint64_t rank = (uint64_t) std::ceil(total * p), seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank && counts[i]) return std::min(upper_bound_us((int) i), max_us);
+        }
+        return max_us;
+    }
+};
+
+struct officer_identity {
+    std::vector<char> private_key = std::vector<char>(ml_dsa_65_private_key_size);
+    std::vector<char> public_key = std::vector<char>(ml_dsa_65_public_key_size);
+    std::vector<char> cert = std::vector<char>(mldsa_arena_pem_capacity);
+    int cert_len = 0;
+};
+
+struct workflow_fixture {
+    officer_identity ca;
+    std::vector<officer_identity> officers;
+};
+
+static bool make_identity(officer_identity& id, const char *subject, const officer_identity *issuer) {
+    std::vector<char> csr(mldsa_arena_pem_capacity);
+    std::string subject_copy(subject);
+    char *subject_vec[] = {subject_copy.data()};
+    if (!generate_mldsa65_keypair(id.private_key.data(), id.public_key.data())) {
+        return false;
+    }
+    int csr_len = generate_csr(id.private_key.data(), id.public_key.data(), subject_vec, 1, csr.data(), csr.size());
+    if (csr_len <= 0) {
+        return false;
+    }
+    id.cert_len = issuer
+        ? sign_certificate(csr.data(), csr_len, issuer->cert.data(), issuer->cert_len,
+                           issuer->private_key.data(), ml_dsa_65_private_key_size, id.cert.data(), id.cert.size(), 365)
+        : generate_self_signed_certificate(csr.data(), csr_len, id.private_key.data(), id.cert.data(), id.cert.size(), 365);
+    return id.cert_len > 0;
+}
+
+static bool make_fixture(workflow_fixture& f, int officers) {
+    if (!make_identity(f.ca, "CN=Loadgen CA", nullptr)) {
+        return false;
+    }
+    f.officers.resize(officers);
+    for (int i = 0; i < officers; ++i) {
+        std::string subject = "CN=Officer " + std::to_string(i);
+        if (!make_identity(f.officers[i], subject.c_str(), &f.ca)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One citizen application, end to end. Records each stage into `h`.
+static bool run_application(const workflow_fixture& f, const officer_identity& officer, uint64_t id,
+                            latency_histogram *h) {
+    std::vector<char> private_key(ml_dsa_65_private_key_size);
+    std::vector<char> public_key(ml_dsa_65_public_key_size);
+    std::vector<char> csr(mldsa_arena_pem_capacity);
+    std::vector<char> cert(mldsa_arena_pem_capacity);
+    std::vector<unsigned char> applicant_signature(ml_dsa_65_signature_size);
+    std::vector<unsigned char> officer_signature(ml_dsa_65_signature_size);
+    std::string subject = "CN=Citizen " + std::to_string(id);
+    char *subject_vec[] = {subject.data()};
+    std::string application = "{\"type\":\"birth_registration\",\"id\":" + std::to_string(id) + ",\"name\":\"Nguyen Van A\"}";
+    int csr_len = 0, cert_len = 0, applicant_len = 0, officer_len = 0;
+    std::string approval;
+
+    auto stage_start = bench_clock::now();
+    auto lap = [&](stage s, bool ok) {
+        auto now = bench_clock::now();
+        h[s].record(std::chrono::duration<double, std::micro>(now - stage_start).count());
+        stage_start = now;
+        return ok;
+    };
+
+    if (!lap(stage_keygen, generate_mldsa65_keypair(private_key.data(), public_key.data()))) return false;
+    csr_len = generate_csr(private_key.data(), public_key.data(), subject_vec, 1, csr.data(), csr.size());
+    if (!lap(stage_csr, csr_len > 0)) return false;
+    cert_len = sign_certificate(csr.data(), csr_len, f.ca.cert.data(), f.ca.cert_len,
+                                f.ca.private_key.data(), ml_dsa_65_private_key_size, cert.data(), cert.size(), 365);
+    if (!lap(stage_issue, cert_len > 0)) return false;
+    applicant_len = sign_mldsa65(private_key.data(), application.data(), application.size(),
+                                 applicant_signature.data(), applicant_signature.size());
+    if (!lap(stage_applicant_sign, applicant_len > 0)) return false;
+    if (!lap(stage_officer_verify, verify_signature_with_cert(cert.data(), cert_len, applicant_signature.data(), applicant_len,
+                                                              application.data(), (int) application.size()))) return false;
+    applicant_signature.resize(applicant_len);
+    approval = "{\"signature\":\"" + base64_encode(applicant_signature) +
+               "\",\"time\":" + std::to_string(id) + "}";
+    officer_len = sign_mldsa65(officer.private_key.data(), approval.data(), approval.size(),
+                               officer_signature.data(), officer_signature.size());
+    if (!lap(stage_officer_sign, officer_len > 0)) return false;
+    bool qr_ok = verify_signature_with_cert(officer.cert.data(), officer.cert_len, officer_signature.data(), officer_len,
+                                            approval.data(), (int) approval.size()) &&
+                 verify_certificate_issued_by_ca(officer.cert.data(), officer.cert_len, f.ca.cert.data(), f.ca.cert_len);
+    return lap(stage_qr_verify, qr_ok);
+}
+
+struct run_result {
+    latency_histogram stages[stage_count];
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    double seconds = 0;
+};
+
+// rate_per_s == 0 runs closed loop.
+static run_result run_load(const workflow_fixture& f, double rate_per_s, double seconds) {
+    int officers = (int) f.officers.size();
+    std::vector<run_result> per_thread(officers);
+    std::atomic<uint64_t> next_id{0};
+    auto t0 = bench_clock::now();
+    auto deadline = t0 + std::chrono::duration_cast<bench_clock::duration>(std::chrono::duration<double>(seconds));
+    // Each officer takes every officers-th slot of the global schedule, staggered.
+    auto interval = rate_per_s > 0
+        ? std::chrono::duration_cast<bench_clock::duration>(std::chrono::duration<double>(officers / rate_per_s))
+        : bench_clock::duration::zero();
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < officers; ++t) {
+        pool.emplace_back([&, t] {
+            run_result& r = per_thread[t];
+            auto scheduled = t0 + interval * t / officers;
+            while (scheduled < deadline && bench_clock::now() < deadline) {
+                if (rate_per_s > 0) {
+                    std::this_thread::sleep_until(scheduled);
+                } else {
+                    scheduled = bench_clock::now();
+                }
+                if (run_application(f, f.officers[t], next_id.fetch_add(1), r.stages)) {
+                    r.stages[stage_end_to_end].record(
+                        std::chrono::duration<double, std::micro>(bench_clock::now() - scheduled).count());
+                    r.completed++;
+                } else {
+                    r.failed++;
+                }
+                scheduled += interval;
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    run_result total;
+    total.seconds = std::chrono::duration<double>(bench_clock::now() - t0).count();
+    for (const run_result& r : per_thread) {
+        for (int s = 0; s < stage_count; ++s) total.stages[s].merge(r.stages[s]);
+        total.completed += r.completed;
+        total.failed += r.failed;
+    }
+    return total;
+}
+
+static void print_stages(const run_result& r) {
+    printf("%-16s %10s %10s %10s %10s %10s\n", "stage", "count", "p50 us", "p90 us", "p99 us", "max us");
+    for (int s = 0; s < stage_count; ++s) {
+        const latency_histogram& h = r.stages[s];
+        printf("%-16s %10llu %10.0f %10.0f %10.0f %10.0f\n", stage_names[s], (unsigned long long) h.total,
+               h.percentile(0.50), h.percentile(0.90), h.percentile(0.99), h.max_us);
+    }
+}
+
+static void print_histogram(const latency_histogram& h) {
+    printf("\nend_to_end histogram (us, upper bound: count)\n");
+    for (size_t i = 0; i < h.counts.size(); ++i) {
+        if (h.counts[i]) {
+            printf("  <= %10.0f: %llu\n", latency_histogram::upper_bound_us((int) i), (unsigned long long) h.counts[i]);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int officers = argc > 1 ? atoi(argv[1]) : (int) std::thread::hardware_concurrency();
+    const char *rate_arg = argc > 2 ? argv[2] : "0";
+    double seconds = argc > 3 ? atof(argv[3]) : 10;
+    if (officers <= 0) officers = 1;
+    if (seconds <= 0) seconds = 10;
+
+    workflow_fixture fixture;
+    if (!make_fixture(fixture, officers)) {
+        fprintf(stderr, "failed to build CA / officer fixture\n");
+        return 1;
+    }
+
+    if (strcmp(rate_arg, "sweep") != 0) {
+        double rate = atof(rate_arg);
+        run_result r = run_load(fixture, rate, seconds);
+        printf("approval workflow, %d officers, %s, %.1f s\n", officers,
+               rate > 0 ? (std::to_string(rate) + " applications/s offered").c_str() : "closed loop", r.seconds);
+        printf("completed %llu, failed %llu, throughput %.1f applications/s\n\n",
+               (unsigned long long) r.completed, (unsigned long long) r.failed, r.completed / r.seconds);
+        print_stages(r);
+        print_histogram(r.stages[stage_end_to_end]);
+        return r.failed ? 1 : 0;
+    }
+
+    // Sweep: saturation first, then offered load as a fraction of it. The knee is where
+    // achieved throughput stops tracking the offered rate and p99 climbs.
+    run_result saturation = run_load(fixture, 0, seconds);
+    double max_rate = saturation.completed / saturation.seconds;
+    printf("approval workflow sweep, %d officers, %.1f s per step, saturation %.1f applications/s\n\n",
+           officers, seconds, max_rate);
+    printf("%8s %12s %12s %12s %12s %8s\n", "load", "offered/s", "achieved/s", "p50 us", "p99 us", "failed");
+    bool ok = saturation.failed == 0;
+    for (int percent = 25; percent <= 150; percent += 25) {
+        double offered = max_rate * percent / 100.0;
+        run_result r = run_load(fixture, offered, seconds);
+        const latency_histogram& e2e = r.stages[stage_end_to_end];
+        printf("%7d%% %12.1f %12.1f %12.0f %12.0f %8llu\n", percent, offered, r.completed / r.seconds,
+               e2e.percentile(0.50), e2e.percentile(0.99), (unsigned long long) r.failed);
+        ok = ok && r.failed == 0;
+    }
+    return ok ? 0 : 1;
+}
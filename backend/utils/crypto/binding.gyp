@@ -0,0 +1,54 @@
+{
+  # Native N-API build of the ML-DSA library (same sources as mldsa_lib.wasm).
+  #   cd backend/utils/crypto && OPENSSL_ROOT=/path/to/openssl-3.5 npx node-gyp rebuild
+  # (or pass --openssl_root=/path/to/openssl-3.5 to node-gyp).
+  # MLDSAWrapper loads build/Release/mldsa_native.node when present and falls back to WASM.
+  #
+  # Node ships its own libcrypto without ML-DSA, so OpenSSL 3.5 is linked statically
+  # with symbols bound locally to keep the addon from resolving into Node's copy.
+  "variables": {
+    "openssl_root%": "<!(node -p \"process.env.OPENSSL_ROOT || ''\")"
+  },
+  "targets": [
+    {
+      "target_name": "mldsa_native",
+      "conditions": [
+        [ "openssl_root==''", {
+          "variables": {
+            "openssl_root_missing": "<!(node -e \"console.error('mldsa_native: set OPENSSL_ROOT or pass --openssl_root=<OpenSSL 3.5 prefix>'); process.exit(1)\")"
+          }
+        } ]
+      ],
+      "sources": [
+        "native/mldsa_addon.cpp",
+        "verification.cpp",
+        "key_generation.cpp",
+        "signing.cpp",
+        "key_handle.cpp",
+        "arena.cpp",
+        "ossl_arena.cpp",
+        "cert_format.cpp",
+        "codec.cpp",
+        "stats.cpp",
+        "errors.cpp",
+        "keypair_pool.cpp",
+        "serial.cpp",
+        "revocation.cpp",
+        "status_token.cpp",
+        "qr_payload.cpp",
+        "merkle_batch.cpp",
+        "signature_store.cpp"
+      ],
+      "include_dirs": [
+        "<(openssl_root)/include"
+      ],
+      "libraries": [
+        "<(openssl_root)/lib/libssl.a",
+        "<(openssl_root)/lib/libcrypto.a"
+      ],
+      "cflags_cc": [ "-std=c++20", "-O3", "-pthread", "-fexceptions" ],
+      "cflags_cc!": [ "-fno-exceptions", "-std=gnu++17" ],
+      "ldflags": [ "-pthread", "-Wl,-Bsymbolic", "-Wl,--exclude-libs,ALL" ]
+    }
+  ]
+}
@@ -0,0 +1,128 @@
+#include "mldsa_lib.h"
+
+// src/cert_format.cpp
+// PEM / DER handling shared by the certificate entry points.
+//
+// Inputs are auto-detected: DER always starts with a SEQUENCE tag (0x30) while PEM starts
+// with "-----BEGIN" (possibly after whitespace), so the first byte is enough. DER goes
+// straight to d2i_*, skipping the base64 decode the PEM path needs.
+#include <climits>
+#include <cstring>
+#include <vector>
+
+void handle_openssl_error(const char* context);
+
+namespace {
+
+// Strips the armor with the vector codec (codec.cpp) so PEM parses through d2i as well.
+// Returns an empty vector when the block is missing or unusual; callers then fall back to
+// OpenSSL's PEM reader, which also handles labels like "X509 CERTIFICATE".
+std::vector<unsigned char> dearmor(const char *buf, size_t len, const char *label) {
+    std::vector<unsigned char> der(len / 4 * 3 + 3);
+    long der_len = mldsa_pem_dearmor(buf, len, label, der.data(), der.size());
+    der.resize(der_len > 0 ? static_cast<size_t>(der_len) : 0);
+    return der;
+}
+
+} // namespace
+
+bool is_der_encoded(const char *buf, size_t len) {
+    return buf && len > 0 && static_cast<unsigned char>(buf[0]) == 0x30;
+}
+
+X509_ptr read_x509(const char *buf, size_t len) {
+    stats_phase_timer parse_timer(stats_phase::parse);
+    if (!buf || len == 0 || len > INT_MAX) {
+        return X509_ptr(nullptr, X509_free);
+    }
+    if (is_der_encoded(buf, len)) {
+        const unsigned char *p = reinterpret_cast<const unsigned char*>(buf);
+        X509_ptr cert(d2i_X509(nullptr, &p, static_cast<long>(len)), X509_free);
+        if (!cert) {
+            handle_openssl_error("d2i_X509");
+        }
+        return cert;
+    }
+    std::vector<unsigned char> der = dearmor(buf, len, "CERTIFICATE");
+    if (!der.empty()) {
+        const unsigned char *p = der.data();
+        X509_ptr cert(d2i_X509(nullptr, &p, static_cast<long>(der.size())), X509_free);
+        if (cert) {
+            return cert;
+        }
+        ERR_clear_error();
+    }
+    BIO_ptr bio(BIO_new_mem_buf(buf, static_cast<int>(len)), BIO_free_all);
+    if (!bio) {
+        handle_openssl_error("BIO_new_mem_buf for certificate");
+        return X509_ptr(nullptr, X509_free);
+    }
+    X509_ptr cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr), X509_free);
+    if (!cert) {
+        handle_openssl_error("PEM_read_bio_X509");
+    }
+    return cert;
+}
+
+X509_REQ_ptr read_x509_req(const char *buf, size_t len) {
+    stats_phase_timer parse_timer(stats_phase::parse);
+    if (!buf || len == 0 || len > INT_MAX) {
+        return X509_REQ_ptr(nullptr, X509_REQ_free);
+    }
+    if (is_der_encoded(buf, len)) {
+        const unsigned char *p = reinterpret_cast<const unsigned char*>(buf);
+        X509_REQ_ptr req(d2i_X509_REQ(nullptr, &p, static_cast<long>(len)), X509_REQ_free);
+        if (!req) {
+            handle_openssl_error("d2i_X509_REQ");
+        }
+        return req;
+    }
+    std::vector<unsigned char> der = dearmor(buf, len, "CERTIFICATE REQUEST");
+    if (!der.empty()) {
+        const unsigned char *p = der.data();
+        X509_REQ_ptr req(d2i_X509_REQ(nullptr, &p, static_cast<long>(der.size())), X509_REQ_free);
+        if (req) {
+            return req;
+        }
+        ERR_clear_error();
+    }
+    BIO_ptr bio(BIO_new_mem_buf(buf, static_cast<int>(len)), BIO_free_all);
+    if (!bio) {
+        handle_openssl_error("BIO_new_mem_buf for CSR");
+        return X509_REQ_ptr(nullptr, X509_REQ_free);
+    }
+    X509_REQ_ptr req(PEM_read_bio_X509_REQ(bio.get(), nullptr, nullptr, nullptr), X509_REQ_free);
+    if (!req) {
+        handle_openssl_error("PEM_read_bio_X509_REQ");
+    }
+    return req;
+}
+
+int write_x509(X509 *cert, bool der, char *out_buf, size_t out_buf_size) {
+    // DER and armored PEM go straight into out_buf, so this is all encode time.
+    stats_phase_timer encode_timer(stats_phase::encode);
+    int der_len = i2d_X509(cert, nullptr);
+    if (der_len <= 0) {
+        handle_openssl_error("i2d_X509");
+        return 0;
+    }
+    if (der) {
+        if (static_cast<size_t>(der_len) > out_buf_size) {
+            return 0;
+        }
+        // i2d advances the pointer, so hand it a copy.
+        unsigned char *p = reinterpret_cast<unsigned char*>(out_buf);
+        return i2d_X509(cert, &p);
+    }
+
+    // PEM: DER into a scratch buffer, then armor with the vector codec instead of a BIO chain.
+    std::vector<unsigned char> encoded(static_cast<size_t>(der_len));
+    unsigned char *p = encoded.data();
+    if (i2d_X509(cert, &p) != der_len) {
+        handle_openssl_error("i2d_X509");
+        return 0;
+    }
+    // PEM output is NUL-terminated, so it needs one spare byte.
+    long pem_len = mldsa_pem_armor("CERTIFICATE", encoded.data(), encoded.size(), out_buf, out_buf_size);
+    return pem_len > 0 ? static_cast<int>(pem_len) : 0;
+}
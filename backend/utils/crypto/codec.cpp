@@ -0,0 +1,454 @@
+#include "mldsa_lib.h"
+
+// src/codec.cpp
+// Base64, hex and PEM armor for signatures, keys and certificates.
+//
+// Whole blocks go through vector kernels (codec_simd.h): AVX2 or SSSE3 picked at runtime on
+// x86, SIMD128 in WASM builds compiled with -msimd128. Tails, padding, whitespace and
+// anything the kernels reject are finished by the scalar code, which is also the complete
+// fallback on other targets.
+#include <climits>
+#include <cstring>
+
+namespace {
+
+const char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char hex_digits[] = "0123456789abcdef";
+constexpr size_t pem_line_chars = 64;
+constexpr size_t pem_line_bytes = pem_line_chars / 4 * 3;
+
+// 0..63 for alphabet characters, 0xfe for ASCII whitespace, 0xff for anything else.
+constexpr unsigned char b64_whitespace = 0xfe;
+constexpr unsigned char b64_invalid = 0xff;
+
+struct base64_decode_table {
+    unsigned char value[256];
+    constexpr base64_decode_table() : value() {
+        for (int i = 0; i < 256; ++i) value[i] = b64_invalid;
+        for (int i = 0; i < 64; ++i) value[static_cast<unsigned char>(base64_alphabet[i])] = static_cast<unsigned char>(i);
+        value[' '] = value['\t'] = value['\r'] = value['\n'] = b64_whitespace;
+    }
+};
+constexpr base64_decode_table b64_table;
+
+inline int hex_value(unsigned char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// --- Scalar ---
+
+void base64_encode_scalar(const unsigned char *src, size_t len, char *dst) {
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t group = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8) | src[i + 2];
+        *dst++ = base64_alphabet[group >> 18];
+        *dst++ = base64_alphabet[(group >> 12) & 0x3f];
+        *dst++ = base64_alphabet[(group >> 6) & 0x3f];
+        *dst++ = base64_alphabet[group & 0x3f];
+    }
+    if (len - i == 1) {
+        uint32_t group = uint32_t(src[i]) << 16;
+        *dst++ = base64_alphabet[group >> 18];
+        *dst++ = base64_alphabet[(group >> 12) & 0x3f];
+        *dst++ = '=';
+        *dst++ = '=';
+    } else if (len - i == 2) {
+        uint32_t group = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8);
+        *dst++ = base64_alphabet[group >> 18];
+        *dst++ = base64_alphabet[(group >> 12) & 0x3f];
+        *dst++ = base64_alphabet[(group >> 6) & 0x3f];
+        *dst++ = '=';
+    }
+}
+
+void hex_encode_scalar(const unsigned char *src, size_t len, char *dst) {
+    for (size_t i = 0; i < len; ++i) {
+        *dst++ = hex_digits[src[i] >> 4];
+        *dst++ = hex_digits[src[i] & 0x0f];
+    }
+}
+
+// Returns characters consumed, or SIZE_MAX if a non-hex character was found.
+size_t hex_decode_scalar(const char *src, size_t len, unsigned char *dst) {
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        int hi = hex_value(static_cast<unsigned char>(src[i]));
+        int lo = hex_value(static_cast<unsigned char>(src[i + 1]));
+        if (hi < 0 || lo < 0) return SIZE_MAX;
+        *dst++ = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return len;
+}
+
+// --- Vector kernels ---
+
+typedef size_t (*base64_encode_blocks_fn)(const unsigned char*, size_t, char*);
+typedef size_t (*base64_decode_blocks_fn)(const char*, size_t, unsigned char*, size_t, size_t*);
+typedef size_t (*hex_encode_blocks_fn)(const unsigned char*, size_t, char*);
+typedef size_t (*hex_decode_blocks_fn)(const char*, size_t, unsigned char*);
+
+struct codec_kernels {
+    const char *name;
+    base64_encode_blocks_fn base64_encode;
+    base64_decode_blocks_fn base64_decode;
+    hex_encode_blocks_fn hex_encode;
+    hex_decode_blocks_fn hex_decode;
+};
+
+} // namespace
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("ssse3"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("ssse3")
+#endif
+namespace codec_ssse3 {
+struct V {
+    typedef __m128i vec;
+    static constexpr size_t lanes = 1;
+    static vec load(const void *p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+    static void store(void *p, vec v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+    static void store_low64(void *p, vec v) { _mm_storel_epi64(static_cast<__m128i*>(p), v); }
+    static vec load_encode_input(const unsigned char *p) { return load(p); }
+    static void store_decode_output(unsigned char *p, vec v) { store(p, v); }
+    static vec table(char a0, char a1, char a2, char a3, char a4, char a5, char a6, char a7,
+                     char a8, char a9, char a10, char a11, char a12, char a13, char a14, char a15) {
+        return _mm_setr_epi8(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15);
+    }
+    static vec splat8(char c) { return _mm_set1_epi8(c); }
+    static vec splat32(int x) { return _mm_set1_epi32(x); }
+    static vec and_(vec a, vec b) { return _mm_and_si128(a, b); }
+    static vec or_(vec a, vec b) { return _mm_or_si128(a, b); }
+    static vec add8(vec a, vec b) { return _mm_add_epi8(a, b); }
+    static vec subs_u8(vec a, vec b) { return _mm_subs_epu8(a, b); }
+    static vec cmpgt8(vec a, vec b) { return _mm_cmpgt_epi8(a, b); }
+    static vec cmpeq8(vec a, vec b) { return _mm_cmpeq_epi8(a, b); }
+    static vec shuffle(vec table, vec idx) { return _mm_shuffle_epi8(table, idx); }
+    static vec interleave_lo8(vec a, vec b) { return _mm_unpacklo_epi8(a, b); }
+    static vec interleave_hi8(vec a, vec b) { return _mm_unpackhi_epi8(a, b); }
+    static bool all_zero(vec v) { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xffff; }
+    template<int N> static vec srli32(vec v) { return _mm_srli_epi32(v, N); }
+    template<int N> static vec slli32(vec v) { return _mm_slli_epi32(v, N); }
+    template<int N> static vec srli16(vec v) { return _mm_srli_epi16(v, N); }
+    template<int N> static vec slli16(vec v) { return _mm_slli_epi16(v, N); }
+};
+#define CODEC_SIMD_HEX
+#include "codec_simd.h"
+#undef CODEC_SIMD_HEX
+} // namespace codec_ssse3
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+namespace codec_avx2 {
+struct V {
+    typedef __m256i vec;
+    static constexpr size_t lanes = 2;
+    static vec load(const void *p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+    static void store(void *p, vec v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+    // 12 bytes per lane: lane 0 from p, lane 1 from p + 12.
+    static vec load_encode_input(const unsigned char *p) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12));
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    }
+    static void store_decode_output(unsigned char *p, vec v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 12), _mm256_extracti128_si256(v, 1));
+    }
+    static vec table(char a0, char a1, char a2, char a3, char a4, char a5, char a6, char a7,
+                     char a8, char a9, char a10, char a11, char a12, char a13, char a14, char a15) {
+        return _mm256_setr_epi8(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15,
+                                a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15);
+    }
+    static vec splat8(char c) { return _mm256_set1_epi8(c); }
+    static vec splat32(int x) { return _mm256_set1_epi32(x); }
+    static vec and_(vec a, vec b) { return _mm256_and_si256(a, b); }
+    static vec or_(vec a, vec b) { return _mm256_or_si256(a, b); }
+    static vec add8(vec a, vec b) { return _mm256_add_epi8(a, b); }
+    static vec subs_u8(vec a, vec b) { return _mm256_subs_epu8(a, b); }
+    static vec cmpgt8(vec a, vec b) { return _mm256_cmpgt_epi8(a, b); }
+    static vec cmpeq8(vec a, vec b) { return _mm256_cmpeq_epi8(a, b); }
+    static vec shuffle(vec table, vec idx) { return _mm256_shuffle_epi8(table, idx); }
+    static bool all_zero(vec v) { return _mm256_testz_si256(v, v); }
+    template<int N> static vec srli32(vec v) { return _mm256_srli_epi32(v, N); }
+    template<int N> static vec slli32(vec v) { return _mm256_slli_epi32(v, N); }
+};
+#include "codec_simd.h"
+} // namespace codec_avx2
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+namespace {
+codec_kernels pick_kernels() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", codec_avx2::base64_encode_blocks, codec_avx2::base64_decode_blocks,
+                codec_ssse3::hex_encode_blocks, codec_ssse3::hex_decode_blocks};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return {"ssse3", codec_ssse3::base64_encode_blocks, codec_ssse3::base64_decode_blocks,
+                codec_ssse3::hex_encode_blocks, codec_ssse3::hex_decode_blocks};
+    }
+    return {"scalar", nullptr, nullptr, nullptr, nullptr};
+}
+} // namespace
+
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+
+namespace codec_simd128 {
+struct V {
+    typedef v128_t vec;
+    static constexpr size_t lanes = 1;
+    static vec load(const void *p) { return wasm_v128_load(p); }
+    static void store(void *p, vec v) { wasm_v128_store(p, v); }
+    static void store_low64(void *p, vec v) { wasm_v128_store64_lane(p, v, 0); }
+    static vec load_encode_input(const unsigned char *p) { return load(p); }
+    static void store_decode_output(unsigned char *p, vec v) { store(p, v); }
+    static vec table(char a0, char a1, char a2, char a3, char a4, char a5, char a6, char a7,
+                     char a8, char a9, char a10, char a11, char a12, char a13, char a14, char a15) {
+        return wasm_i8x16_make(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15);
+    }
+    static vec splat8(char c) { return wasm_i8x16_splat(c); }
+    static vec splat32(int x) { return wasm_i32x4_splat(x); }
+    static vec and_(vec a, vec b) { return wasm_v128_and(a, b); }
+    static vec or_(vec a, vec b) { return wasm_v128_or(a, b); }
+    static vec add8(vec a, vec b) { return wasm_i8x16_add(a, b); }
+    static vec subs_u8(vec a, vec b) { return wasm_u8x16_sub_sat(a, b); }
+    static vec cmpgt8(vec a, vec b) { return wasm_i8x16_gt(a, b); }
+    static vec cmpeq8(vec a, vec b) { return wasm_i8x16_eq(a, b); }
+    // swizzle zeroes out-of-range indices, which covers pshufb's "high bit clears" use here.
+    static vec shuffle(vec table, vec idx) { return wasm_i8x16_swizzle(table, idx); }
+    static vec interleave_lo8(vec a, vec b) {
+        return wasm_i8x16_shuffle(a, b, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    }
+    static vec interleave_hi8(vec a, vec b) {
+        return wasm_i8x16_shuffle(a, b, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+    }
+    static bool all_zero(vec v) { return !wasm_v128_any_true(v); }
+    template<int N> static vec srli32(vec v) { return wasm_u32x4_shr(v, N); }
+    template<int N> static vec slli32(vec v) { return wasm_i32x4_shl(v, N); }
+    template<int N> static vec srli16(vec v) { return wasm_u16x8_shr(v, N); }
+    template<int N> static vec slli16(vec v) { return wasm_i16x8_shl(v, N); }
+};
+#define CODEC_SIMD_HEX
+#include "codec_simd.h"
+#undef CODEC_SIMD_HEX
+} // namespace codec_simd128
+
+namespace {
+codec_kernels pick_kernels() {
+    return {"simd128", codec_simd128::base64_encode_blocks, codec_simd128::base64_decode_blocks,
+            codec_simd128::hex_encode_blocks, codec_simd128::hex_decode_blocks};
+}
+} // namespace
+
+#else
+namespace {
+codec_kernels pick_kernels() {
+    return {"scalar", nullptr, nullptr, nullptr, nullptr};
+}
+} // namespace
+#endif
+
+namespace {
+
+const codec_kernels& kernels() {
+    static const codec_kernels picked = pick_kernels();
+    return picked;
+}
+
+void base64_encode_into(const unsigned char *src, size_t len, char *dst) {
+    size_t done = 0;
+    if (kernels().base64_encode) {
+        done = kernels().base64_encode(src, len, dst);
+    }
+    base64_encode_scalar(src + done, len - done, dst + done / 3 * 4);
+}
+
+// Decodes src, skipping ASCII whitespace. Returns bytes written, or -1 on invalid input
+// or when dst is too small.
+long base64_decode_into(const char *src, size_t len, unsigned char *dst, size_t dst_size) {
+    size_t out = 0;
+    size_t pos = 0;
+    uint32_t group = 0;
+    int quad = 0;     // characters in the current group
+    int padding = 0;  // '=' seen
+    while (pos < len) {
+        // Whole vector blocks only start on a group boundary before any padding.
+        if (quad == 0 && padding == 0 && kernels().base64_decode) {
+            size_t written = 0;
+            pos += kernels().base64_decode(src + pos, len - pos, dst + out, dst_size - out, &written);
+            out += written;
+            if (pos >= len) break;
+        }
+        unsigned char c = static_cast<unsigned char>(src[pos++]);
+        unsigned char v = b64_table.value[c];
+        if (v == b64_whitespace) continue;
+        if (c == '=') {
+            // Padding only completes a group of two or three characters.
+            if (quad < 2 || ++padding + quad > 4) return -1;
+            continue;
+        }
+        if (v == b64_invalid || padding) return -1;
+        group = (group << 6) | v;
+        if (++quad == 4) {
+            if (dst_size - out < 3) return -1;
+            dst[out++] = static_cast<unsigned char>(group >> 16);
+            dst[out++] = static_cast<unsigned char>(group >> 8);
+            dst[out++] = static_cast<unsigned char>(group);
+            group = 0;
+            quad = 0;
+        }
+    }
+    // A trailing partial group (padded or not) carries one or two bytes.
+    if (quad == 1) return -1;
+    if (quad > 1) {
+        if (padding && quad + padding != 4) return -1;
+        size_t extra = static_cast<size_t>(quad - 1);
+        if (dst_size - out < extra) return -1;
+        group <<= 6 * (4 - quad);
+        dst[out++] = static_cast<unsigned char>(group >> 16);
+        if (extra == 2) dst[out++] = static_cast<unsigned char>(group >> 8);
+    }
+    return static_cast<long>(out);
+}
+
+// Finds "-----<marker> <label>-----" at or after from; any label when label is nullptr.
+// Returns the position just past the closing dashes, or npos. label_out receives the label.
+size_t find_pem_boundary(const char *pem, size_t len, size_t from, const char *marker, const char *label,
+                         size_t *boundary_start, const char **label_out, size_t *label_len) {
+    const size_t marker_len = strlen(marker);
+    for (size_t i = from; i + 10 + marker_len <= len; ++i) {
+        const char *hit = static_cast<const char*>(memchr(pem + i, '-', len - i));
+        if (!hit) break;
+        i = static_cast<size_t>(hit - pem);
+        if (i + 5 + marker_len + 1 > len || memcmp(pem + i, "-----", 5) != 0 ||
+            memcmp(pem + i + 5, marker, marker_len) != 0 || pem[i + 5 + marker_len] != ' ') {
+            continue;
+        }
+        size_t name_start = i + 5 + marker_len + 1;
+        const char *close = nullptr;
+        for (size_t j = name_start; j + 5 <= len && pem[j] != '\n'; ++j) {
+            if (memcmp(pem + j, "-----", 5) == 0) {
+                close = pem + j;
+                break;
+            }
+        }
+        if (!close) continue;
+        size_t name_len = static_cast<size_t>(close - (pem + name_start));
+        if (label && (strlen(label) != name_len || memcmp(pem + name_start, label, name_len) != 0)) {
+            continue;
+        }
+        if (boundary_start) *boundary_start = i;
+        if (label_out) *label_out = pem + name_start;
+        if (label_len) *label_len = name_len;
+        return static_cast<size_t>(close - pem) + 5;
+    }
+    return SIZE_MAX;
+}
+
+} // namespace
+
+const char* mldsa_codec_backend(void) {
+    return kernels().name;
+}
+
+long mldsa_base64_encode(const unsigned char *src, size_t src_len, char *dst, size_t dst_size) {
+    if ((!src && src_len) || !dst || src_len > (SIZE_MAX - 2) / 4 * 3) return -1;
+    size_t needed = (src_len + 2) / 3 * 4;
+    if (needed >= dst_size || needed > LONG_MAX) return -1;
+    base64_encode_into(src, src_len, dst);
+    dst[needed] = '\0';
+    return static_cast<long>(needed);
+}
+
+long mldsa_base64_decode(const char *src, size_t src_len, unsigned char *dst, size_t dst_size) {
+    if ((!src && src_len) || (!dst && dst_size)) return -1;
+    return base64_decode_into(src, src_len, dst, dst_size);
+}
+
+long mldsa_hex_encode(const unsigned char *src, size_t src_len, char *dst, size_t dst_size) {
+    if ((!src && src_len) || !dst || src_len > (SIZE_MAX - 1) / 2) return -1;
+    size_t needed = src_len * 2;
+    if (needed >= dst_size || needed > LONG_MAX) return -1;
+    size_t done = kernels().hex_encode ? kernels().hex_encode(src, src_len, dst) : 0;
+    hex_encode_scalar(src + done, src_len - done, dst + done * 2);
+    dst[needed] = '\0';
+    return static_cast<long>(needed);
+}
+
+long mldsa_hex_decode(const char *src, size_t src_len, unsigned char *dst, size_t dst_size) {
+    if ((!src && src_len) || (!dst && dst_size) || src_len % 2 != 0 || src_len / 2 > dst_size) return -1;
+    size_t done = kernels().hex_decode ? kernels().hex_decode(src, src_len, dst) : 0;
+    if (hex_decode_scalar(src + done, src_len - done, dst + done / 2) == SIZE_MAX) return -1;
+    return static_cast<long>(src_len / 2);
+}
+
+long mldsa_pem_armor(const char *label, const unsigned char *der, size_t der_len, char *dst, size_t dst_size) {
+    if (!label || (!der && der_len) || !dst) return -1;
+    const size_t label_len = strlen(label);
+    const size_t body_chars = (der_len + 2) / 3 * 4;
+    const size_t lines = (body_chars + pem_line_chars - 1) / pem_line_chars;
+    // "-----BEGIN " label "-----\n" body (one '\n' per line) "-----END " label "-----\n"
+    const size_t needed = 11 + label_len + 6 + body_chars + lines + 9 + label_len + 6;
+    if (needed >= dst_size || needed > LONG_MAX) return -1;
+
+    char *out = dst;
+    memcpy(out, "-----BEGIN ", 11); out += 11;
+    memcpy(out, label, label_len); out += label_len;
+    memcpy(out, "-----\n", 6); out += 6;
+    // Encode straight into place, then open a gap for each newline from the back.
+    base64_encode_into(der, der_len, out);
+    for (size_t line = lines; line-- > 0;) {
+        size_t start = line * pem_line_chars;
+        size_t chars = body_chars - start < pem_line_chars ? body_chars - start : pem_line_chars;
+        memmove(out + start + line, out + start, chars);
+        out[start + line + chars] = '\n';
+    }
+    out += body_chars + lines;
+    memcpy(out, "-----END ", 9); out += 9;
+    memcpy(out, label, label_len); out += label_len;
+    memcpy(out, "-----\n", 6); out += 6;
+    *out = '\0';
+    return static_cast<long>(out - dst);
+}
+
+long mldsa_pem_dearmor(const char *pem, size_t pem_len, const char *label, unsigned char *dst, size_t dst_size) {
+    if (!pem || (!dst && dst_size)) return -1;
+    const char *found_label = nullptr;
+    size_t found_label_len = 0;
+    size_t body_start = find_pem_boundary(pem, pem_len, 0, "BEGIN", label, nullptr, &found_label, &found_label_len);
+    if (body_start == SIZE_MAX) return -1;
+
+    // The END line must carry the same label as BEGIN.
+    char end_label[128];
+    if (found_label_len >= sizeof(end_label)) return -1;
+    memcpy(end_label, found_label, found_label_len);
+    end_label[found_label_len] = '\0';
+    size_t body_end = 0;
+    if (find_pem_boundary(pem, pem_len, body_start, "END", end_label, &body_end, nullptr, nullptr) == SIZE_MAX) {
+        return -1;
+    }
+    // RFC 1421 headers (Proc-Type, DEK-Info) mean encrypted content, which is not handled here.
+    if (memchr(pem + body_start, ':', body_end - body_start)) return -1;
+    return base64_decode_into(pem + body_start, body_end - body_start, dst, dst_size);
+}
@@ -0,0 +1,149 @@
+// codec_simd.h
+// Vector kernels for codec.cpp. Not a public header: codec.cpp includes it once per
+// instruction set, inside a namespace that defines the traits type `V` and under the
+// matching target pragma, so every instantiation is compiled for that instruction set.
+//
+// V provides:
+//   vec                      vector type (16 or 32 bytes; shuffles stay within 16-byte lanes)
+//   lanes                    number of 16-byte lanes
+//   load / store             unaligned full-width load and store
+//   load_encode_input(p)     12 input bytes into bytes 0..11 of each lane (reads lanes*12+4 bytes)
+//   store_decode_output(p,v) bytes 0..11 of each lane to p (writes lanes*12+4 bytes)
+//   table(...)               16-byte constant repeated in every lane
+//   splat8 / splat32, and_, or_, add8, subs_u8, cmpgt8, cmpeq8, shuffle, all_zero,
+//   srli32<N>, slli32<N>, srli16<N>, slli16<N>, store_low64 (hex only, 1 lane)
+
+// --- Base64 ---
+// Encode: per 32-bit lane, rebuild the 24-bit group big-endian, split it into four 6-bit
+// indices with uniform shifts, then map indices to ASCII with one offset lookup
+// (W. Mula, "Base64 encoding with SIMD instructions").
+static inline typename V::vec base64_encode_block(typename V::vec in) {
+    using vec = typename V::vec;
+    // Each 32-bit lane becomes b2 | b1 << 8 | b0 << 16, i.e. the group as a 24-bit integer.
+    vec group = V::shuffle(in, V::table(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+    vec mask = V::splat32(0x3f);
+    vec idx = V::or_(
+        V::or_(V::and_(V::template srli32<18>(group), mask),
+               V::template slli32<8>(V::and_(V::template srli32<12>(group), mask))),
+        V::or_(V::template slli32<16>(V::and_(V::template srli32<6>(group), mask)),
+               V::template slli32<24>(V::and_(group, mask))));
+
+    // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12; then add the per-range offset.
+    vec range = V::subs_u8(idx, V::splat8(51));
+    vec upper = V::cmpgt8(V::splat8(26), idx);
+    range = V::or_(range, V::and_(upper, V::splat8(13)));
+    vec offsets = V::table(71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 65, 0, 0);
+    return V::add8(idx, V::shuffle(offsets, range));
+}
+
+// Encodes whole blocks while the input allows the over-read. Returns bytes consumed.
+static size_t base64_encode_blocks(const unsigned char *src, size_t len, char *dst) {
+    const size_t in_step = 12 * V::lanes;
+    const size_t read_size = in_step + 4;
+    size_t consumed = 0;
+    while (len - consumed >= read_size) {
+        V::store(dst, base64_encode_block(V::load_encode_input(src + consumed)));
+        consumed += in_step;
+        dst += 16 * V::lanes;
+    }
+    return consumed;
+}
+
+// Decode: classify every byte by its nibbles to reject anything outside the alphabet
+// (including '=' and whitespace, which the scalar path handles), translate to 6-bit values,
+// and pack four values per 32-bit lane back into three bytes (Mula & Lemire,
+// "Faster Base64 Encoding and Decoding Using AVX2 Instructions").
+static inline bool base64_decode_block(typename V::vec in, typename V::vec& out) {
+    using vec = typename V::vec;
+    vec low_nibble_mask = V::splat8(0x0f);
+    vec hi = V::and_(V::template srli32<4>(in), low_nibble_mask);
+    vec lo = V::and_(in, low_nibble_mask);
+    vec lo_class = V::shuffle(V::table(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a), lo);
+    vec hi_class = V::shuffle(V::table(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                       0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hi);
+    if (!V::all_zero(V::and_(lo_class, hi_class))) {
+        return false;
+    }
+    vec is_slash = V::cmpeq8(in, V::splat8(0x2f));
+    vec roll = V::shuffle(V::table(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                          V::add8(is_slash, hi));
+    vec values = V::add8(in, roll);
+
+    // Lane bytes a, b, c, d (a first) -> a << 18 | b << 12 | c << 6 | d.
+    vec mask = V::splat32(0x3f);
+    vec group = V::or_(
+        V::or_(V::template slli32<18>(V::and_(values, mask)),
+               V::template slli32<12>(V::and_(V::template srli32<8>(values), mask))),
+        V::or_(V::template slli32<6>(V::and_(V::template srli32<16>(values), mask)),
+               V::template srli32<24>(values)));
+    out = V::shuffle(group, V::table(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+
+// Decodes whole blocks until one holds a non-alphabet byte or space runs out.
+// Returns characters consumed; *written receives the bytes produced.
+static size_t base64_decode_blocks(const char *src, size_t len, unsigned char *dst, size_t dst_size, size_t *written) {
+    const size_t in_step = 16 * V::lanes;
+    const size_t out_step = 12 * V::lanes;
+    const size_t write_size = out_step + 4;
+    size_t consumed = 0, produced = 0;
+    while (len - consumed >= in_step && dst_size - produced >= write_size) {
+        typename V::vec out;
+        if (!base64_decode_block(V::load(src + consumed), out)) {
+            break;
+        }
+        V::store_decode_output(dst + produced, out);
+        consumed += in_step;
+        produced += out_step;
+    }
+    *written = produced;
+    return consumed;
+}
+
+#ifdef CODEC_SIMD_HEX
+// --- Hex (16 bytes <-> 32 characters per step) ---
+static size_t hex_encode_blocks(const unsigned char *src, size_t len, char *dst) {
+    using vec = typename V::vec;
+    const vec digits = V::table('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const vec nibble = V::splat8(0x0f);
+    size_t consumed = 0;
+    while (len - consumed >= 16) {
+        vec in = V::load(src + consumed);
+        vec hi = V::shuffle(digits, V::and_(V::template srli16<4>(in), nibble));
+        vec lo = V::shuffle(digits, V::and_(in, nibble));
+        V::store(dst, V::interleave_lo8(hi, lo));
+        V::store(dst + 16, V::interleave_hi8(hi, lo));
+        consumed += 16;
+        dst += 32;
+    }
+    return consumed;
+}
+
+// Returns characters consumed; stops at the first block holding a non-hex character.
+static size_t hex_decode_blocks(const char *src, size_t len, unsigned char *dst) {
+    using vec = typename V::vec;
+    size_t consumed = 0;
+    while (len - consumed >= 16) {
+        vec in = V::load(src + consumed);
+        // Bytes >= 0x80 compare as negative, so they fail both range checks.
+        vec digit = V::and_(V::cmpgt8(in, V::splat8('0' - 1)), V::cmpgt8(V::splat8('9' + 1), in));
+        vec lower = V::or_(in, V::splat8(0x20));
+        vec alpha = V::and_(V::cmpgt8(lower, V::splat8('a' - 1)), V::cmpgt8(V::splat8('f' + 1), lower));
+        vec valid = V::or_(digit, alpha);
+        if (!V::all_zero(V::cmpeq8(valid, V::splat8(0)))) {
+            break;
+        }
+        // digit: c - '0'; letter: (c | 0x20) - 'a' + 10
+        vec values = V::or_(V::and_(digit, V::add8(in, V::splat8(-'0'))),
+                            V::and_(alpha, V::add8(lower, V::splat8(10 - 'a'))));
+        // 16-bit lanes hold hi | lo << 8 -> hi << 4 | lo in the low byte.
+        vec pairs = V::or_(V::template slli16<4>(V::and_(values, V::splat8(0x0f))),
+                           V::template srli16<8>(values));
+        V::store_low64(dst, V::shuffle(pairs, V::table(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1)));
+        consumed += 16;
+        dst += 8;
+    }
+    return consumed;
+}
+#endif
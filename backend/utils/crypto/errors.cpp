@@ -0,0 +1,257 @@
+#include "mldsa_lib.h"
+
+// src/errors.cpp
+// Bounded per-thread error rings replacing the synchronous stderr printing on failure
+// paths. A flood of forged signatures used to turn into a flood of blocking writes to
+// stderr; now a failure costs one ring slot write and a couple of relaxed atomics, and
+// nothing is formatted until someone drains the rings.
+//
+// Each thread owns one single-producer / single-consumer ring. The owner appends without
+// locks; mldsa_drain_errors is the only consumer (serialized by the registry mutex). A full
+// ring drops the new record and counts it, so the producer never waits. Rings are returned
+// to a free list when their thread exits and reused by the next thread, so short-lived
+// worker threads (verify_signature_batch) do not grow the registry.
+//
+// On top of that, at most one summary line per interval goes to stderr so operators still
+// see that something is failing, without one line per failure.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <openssl/err.h>
+#include <openssl/x509.h>
+
+namespace {
+
+constexpr size_t ring_capacity = 64; // power of two
+constexpr uint64_t default_summary_interval_ns = 60ull * 1000 * 1000 * 1000;
+
+const char *code_names[MLDSA_ERR_CODE_COUNT] = {
+    "none", "openssl", "invalid_signature", "cert_chain", "file_io", "invalid_argument"
+};
+
+struct error_record {
+    uint64_t time_ns;
+    unsigned long detail;
+    const char *context;
+    uint32_t code;
+    uint32_t thread_id;
+};
+
+struct error_ring {
+    error_record records[ring_capacity];
+    std::atomic<uint64_t> head{0}; // written by the owning thread
+    std::atomic<uint64_t> tail{0}; // written by the drainer
+    std::atomic<uint64_t> dropped{0};
+    uint32_t thread_id = 0; // of the current owner; reused rings get a new one
+};
+
+std::mutex registry_mutex;
+std::vector<error_ring*> all_rings;
+std::vector<error_ring*> free_rings;
+uint32_t next_thread_id = 1;
+
+std::atomic<uint64_t> totals[MLDSA_ERR_CODE_COUNT];
+std::atomic<uint64_t> summary_interval_ns{default_summary_interval_ns};
+std::atomic<uint64_t> last_summary_ns{0};
+uint64_t summarized_totals[MLDSA_ERR_CODE_COUNT]; // owned by whoever wins last_summary_ns
+
+// Hands the ring back when its thread exits.
+struct ring_owner {
+    error_ring *ring = nullptr;
+    ~ring_owner() {
+        if (ring) {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            free_rings.push_back(ring);
+        }
+    }
+};
+
+thread_local ring_owner current_ring;
+// Last record_error on this thread, for take_last_error.
+thread_local int last_error_code = 0;
+thread_local unsigned long last_error_detail = 0;
+
+error_ring* thread_ring() {
+    if (current_ring.ring) {
+        return current_ring.ring;
+    }
+    // First error on this thread: the only time the producer side takes the lock.
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    error_ring *ring;
+    if (!free_rings.empty()) {
+        ring = free_rings.back();
+        free_rings.pop_back();
+    } else {
+        ring = new error_ring();
+        all_rings.push_back(ring);
+    }
+    ring->thread_id = next_thread_id++;
+    current_ring.ring = ring;
+    return ring;
+}
+
+uint64_t wall_clock_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void maybe_print_summary(uint64_t now) {
+    uint64_t interval = summary_interval_ns.load(std::memory_order_relaxed);
+    uint64_t last = last_summary_ns.load(std::memory_order_relaxed);
+    if (interval == 0 || (last != 0 && now < last + interval)) {
+        return;
+    }
+    if (!last_summary_ns.compare_exchange_strong(last, now, std::memory_order_acq_rel)) {
+        return; // another thread is printing this interval's summary
+    }
+    char line[256];
+    int len = snprintf(line, sizeof(line), "mldsa: errors since last summary:");
+    for (int code = 1; code < MLDSA_ERR_CODE_COUNT && len > 0 && static_cast<size_t>(len) < sizeof(line); ++code) {
+        uint64_t total = totals[code].load(std::memory_order_relaxed);
+        uint64_t delta = total - summarized_totals[code];
+        summarized_totals[code] = total;
+        if (delta) {
+            len += snprintf(line + len, sizeof(line) - len, " %s=%llu", code_names[code], (unsigned long long) delta);
+        }
+    }
+    fprintf(stderr, "%s (details: mldsa_drain_errors)\n", line);
+}
+
+const char* reason_for(const error_record& r) {
+    const char *reason = nullptr;
+    switch (r.code) {
+    case MLDSA_ERR_OPENSSL:
+        reason = r.detail ? ERR_reason_error_string(r.detail) : nullptr;
+        break;
+    case MLDSA_ERR_CERT_CHAIN:
+        reason = X509_verify_cert_error_string(static_cast<long>(r.detail));
+        break;
+    case MLDSA_ERR_FILE_IO:
+        reason = r.detail ? strerror(static_cast<int>(r.detail)) : nullptr;
+        break;
+    default:
+        break;
+    }
+    return reason ? reason : "";
+}
+
+void append_json_string(std::string& out, const char *s) {
+    out += '"';
+    for (; *s; ++s) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+std::string record_json(const error_record& r) {
+    std::string out = "{\"code\":";
+    append_json_string(out, code_names[r.code < MLDSA_ERR_CODE_COUNT ? r.code : 0]);
+    out += ",\"context\":";
+    append_json_string(out, r.context ? r.context : "");
+    char numbers[96];
+    snprintf(numbers, sizeof(numbers), ",\"detail\":%lu,\"reason\":", r.detail);
+    out += numbers;
+    append_json_string(out, reason_for(r));
+    snprintf(numbers, sizeof(numbers), ",\"thread\":%u,\"time_ms\":%llu}", r.thread_id,
+             (unsigned long long) (r.time_ns / 1000000));
+    out += numbers;
+    return out;
+}
+
+} // namespace
+
+void record_error(mldsa_error_code code, unsigned long detail, const char *context) {
+    uint64_t now = wall_clock_ns();
+    totals[code < MLDSA_ERR_CODE_COUNT ? code : 0].fetch_add(1, std::memory_order_relaxed);
+    last_error_code = code;
+    last_error_detail = detail;
+
+    error_ring *ring = thread_ring();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= ring_capacity) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        ring->records[head & (ring_capacity - 1)] = error_record{now, detail, context, static_cast<uint32_t>(code), ring->thread_id};
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+    maybe_print_summary(now);
+}
+
+void handle_openssl_error(const char* context) {
+    unsigned long err_code = ERR_get_error();
+    // Only the first error is kept; leaving the rest queued would grow the queue on every failure.
+    ERR_clear_error();
+    record_error(MLDSA_ERR_OPENSSL, err_code, context);
+}
+
+int take_last_error(unsigned long *detail) {
+    int code = last_error_code;
+    if (detail) *detail = last_error_detail;
+    last_error_code = 0;
+    last_error_detail = 0;
+    return code;
+}
+
+long mldsa_drain_errors(char *out, size_t out_size) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    // Drop counts are only consumed once the report is known to fit.
+    std::vector<uint64_t> ring_dropped(all_rings.size());
+    uint64_t dropped = 0;
+    for (size_t i = 0; i < all_rings.size(); ++i) {
+        ring_dropped[i] = all_rings[i]->dropped.load(std::memory_order_relaxed);
+        dropped += ring_dropped[i];
+    }
+    std::string text = "{\"dropped\":" + std::to_string(dropped) + ",\"totals\":{";
+    for (int code = 1; code < MLDSA_ERR_CODE_COUNT; ++code) {
+        text += (code > 1 ? ",\"" : "\"") + std::string(code_names[code]) + "\":" +
+                std::to_string(totals[code].load(std::memory_order_relaxed));
+    }
+    text += "},\"errors\":[";
+    const char closing[] = "]}";
+    if (!out || text.size() + sizeof(closing) > out_size) {
+        return -1;
+    }
+    for (size_t i = 0; i < all_rings.size(); ++i) {
+        all_rings[i]->dropped.fetch_sub(ring_dropped[i], std::memory_order_relaxed);
+    }
+
+    bool first = true;
+    bool full = false;
+    for (error_ring *ring : all_rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            std::string record = record_json(ring->records[tail & (ring_capacity - 1)]);
+            if (text.size() + record.size() + 1 + sizeof(closing) > out_size) {
+                full = true;
+                break;
+            }
+            if (!first) text += ',';
+            text += record;
+            first = false;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        if (full) break;
+    }
+    text += closing;
+    memcpy(out, text.c_str(), text.size() + 1);
+    return static_cast<long>(text.size());
+}
+
+void mldsa_set_error_summary_interval(unsigned seconds) {
+    summary_interval_ns.store(static_cast<uint64_t>(seconds) * 1000 * 1000 * 1000, std::memory_order_relaxed);
+}
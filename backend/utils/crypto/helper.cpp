@@ -1,6 +1,13 @@
 #include "mldsa_lib.h"
 #include <iostream>
 #include <fstream>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef __EMSCRIPTEN__
+#include <sys/mman.h>
+#endif
 #include "openssl/bio.h"
 #include <openssl/evp.h>
 #include <openssl/pem.h>
@@ -8,19 +15,69 @@
 using BIO_ptr = ossl_unique_ptr<BIO, BIO_free_all>;
 using EVP_PKEY_ptr = ossl_unique_ptr<EVP_PKEY, EVP_PKEY_free>;
 // ------------------------------ File I/O Helpers ---------------------------
-bool read_file_bytes(const std::string& file_path, std::vector<unsigned char>& data) {
-    std::ifstream file(file_path, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file for reading: " << file_path << std::endl;
-        return false;
+mapped_file::mapped_file(const std::string& file_path) {
+    int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "open file for reading");
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "stat file");
+        close(fd);
+        return;
+    }
+#ifndef __EMSCRIPTEN__
+    // MEMFS/NODEFS emulate mmap with a copy, so WASM builds always take the buffered path.
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t length = static_cast<size_t>(st.st_size);
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            close(fd);
+            mapping_ = mapping;
+            data_ = static_cast<const unsigned char*>(mapping);
+            size_ = length;
+            ok_ = true;
+            return;
+        }
+    }
+#endif
+    // Buffered fallback: non-regular files report no useful size, so read until EOF.
+    if (S_ISREG(st.st_mode)) {
+        buffer_.reserve(static_cast<size_t>(st.st_size));
+    }
+    unsigned char chunk[64 * 1024];
+    for (;;) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            record_error(MLDSA_ERR_FILE_IO, errno, "read file");
+            close(fd);
+            return;
+        }
+        if (n == 0) break;
+        buffer_.insert(buffer_.end(), chunk, chunk + n);
+    }
+    close(fd);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    ok_ = true;
+}
+
+mapped_file::~mapped_file() {
+#ifndef __EMSCRIPTEN__
+    if (mapping_) {
+        munmap(mapping_, size_);
     }
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    data.resize(size);
-    if (!file.read(reinterpret_cast<char*>(data.data()), size)) {
-        std::cerr << "Error: Failed to read file: " << file_path << std::endl;
+#endif
+}
+
+bool read_file_bytes(const std::string& file_path, std::vector<unsigned char>& data) {
+    mapped_file file(file_path);
+    if (!file.ok()) {
         return false;
     }
+    data.assign(file.data(), file.data() + file.size());
     return true;
 }
 
@@ -34,11 +91,11 @@ void freeMemory(void* ptr) {
 bool write_file_bytes(const std::string& file_path, const std::vector<unsigned char>& data) {
     std::ofstream file(file_path, std::ios::binary);
     if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file for writing: " << file_path << std::endl;
+        record_error(MLDSA_ERR_FILE_IO, errno, "open file for writing");
         return false;
     }
     if (!file.write(reinterpret_cast<const char*>(data.data()), data.size())) {
-        std::cerr << "Error: Failed to write to file: " << file_path << std::endl;
+        record_error(MLDSA_ERR_FILE_IO, errno, "write file");
         return false;
     }
     return true;
@@ -46,28 +103,13 @@ bool write_file_bytes(const std::string& file_path, const std::vector<unsigned c
 
 // --- Base64 Helper ---
 std::string base64_encode(const std::vector<unsigned char>& input) {
-    BIO_ptr b64(BIO_new(BIO_f_base64()), BIO_free_all);
-    BIO_ptr bmem(BIO_new(BIO_s_mem()), BIO_free_all);
-    BIO_set_flags(b64.get(), BIO_FLAGS_BASE64_NO_NL); // No newlines in output
-    BIO_push(b64.get(), bmem.get());
-
-    if (BIO_write(b64.get(), input.data(), input.size()) <= 0) {
-        handle_openssl_error("BIO_write for base64 encode");
+    // Encoded straight into the string by the vector codec (codec.cpp); +1 for its terminator.
+    std::string result((input.size() + 2) / 3 * 4 + 1, '\0');
+    long len = mldsa_base64_encode(input.data(), input.size(), &result[0], result.size());
+    if (len < 0) {
         return "";
     }
-    if (BIO_flush(b64.get()) != 1) {
-        handle_openssl_error("BIO_flush for base64 encode");
-        return "";
-    }
-
-    BUF_MEM* bptr = nullptr;
-    BIO_get_mem_ptr(bmem.get(), &bptr);
-    if (!bptr || !bptr->data || bptr->length == 0) {
-        handle_openssl_error("BIO_get_mem_ptr for base64 encode");
-        return "";
-    }
-
-    std::string result(bptr->data, bptr->length);
+    result.resize(static_cast<size_t>(len));
     return result;
 }
 
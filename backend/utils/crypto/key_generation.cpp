@@ -10,6 +10,12 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
 #include <openssl/x509v3.h>
 using BIO_ptr = ossl_unique_ptr<BIO, BIO_free_all>;
 using EVP_PKEY_ptr = ossl_unique_ptr<EVP_PKEY, EVP_PKEY_free>;
@@ -21,15 +27,9 @@ using ASN1_INTEGER_ptr = ossl_unique_ptr<ASN1_INTEGER, ASN1_INTEGER_free>;
 
 
 
-void handle_openssl_error(const char* context) {
-    std::cerr << "OpenSSL Error in " << context << ":\n";
-    int err_code = ERR_get_error();
-    std::cerr << "Error Code: " << err_code << "\n";    
-    std::cerr << "Error String: " << ERR_reason_error_string(err_code) << "\n";
-}
-
 // =============================== KEY GENERATION FUNCTIONS ===============================
 bool generate_mldsa65_keypair(char *private_key, char *public_key) {
+  stats_call_timer call(stats_call::generate_keypair);
   EVP_PKEY_CTX_ptr pctx(EVP_PKEY_CTX_new_id(EVP_PKEY_ML_DSA_65, NULL), EVP_PKEY_CTX_free);
   if(!pctx){
     handle_openssl_error("new EVP_PKEY_CTX failed");
@@ -40,21 +40,24 @@ bool generate_mldsa65_keypair(char *private_key, char *public_key) {
     return false;
   }
   EVP_PKEY* pkey_raw = NULL;
+  stats_phase_timer keygen_timer(stats_phase::keygen);
   if(EVP_PKEY_keygen(pctx.get(), &pkey_raw) <= 0) {
     handle_openssl_error("EVP_PKEY_keygen failed");
     return false;
   }
   EVP_PKEY_ptr pkey(pkey_raw, EVP_PKEY_free);
+  keygen_timer.stop();
 
   // Extracting the public and private keys to buffers
   size_t pub_keylen = ml_dsa_65_public_key_size;
   size_t priv_keylen = ml_dsa_65_private_key_size;
+  stats_phase_timer copy_timer(stats_phase::output_copy);
   if(!EVP_PKEY_get_raw_public_key(pkey.get(), (unsigned char*) public_key, &pub_keylen) ||
      !EVP_PKEY_get_raw_private_key(pkey.get(), (unsigned char*) private_key, &priv_keylen)) {
     handle_openssl_error("EVP_PKEY_get_raw_public_key failed");
     return false;
   }
-  return true;
+  return call.done(true);
 }
 
 // return true out_csr_buf_size
@@ -66,12 +69,15 @@ int  generate_csr(
     char* out_csr_buf,
     size_t out_csr_buf_size
 ) {
+    stats_call_timer call(stats_call::generate_csr);
     std::vector<std::string> subject_info;
     for (int i = 0; i < subject_info_count; ++i) {
         subject_info.push_back(subject_info_vec[i]);
     }
+    stats_phase_timer import_timer(stats_phase::key_import);
     EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_private_key(EVP_PKEY_ML_DSA_65, NULL, (unsigned char*)private_key_chr, ml_dsa_65_private_key_size), EVP_PKEY_free);
     EVP_PKEY_ptr pubkey(EVP_PKEY_new_raw_public_key(EVP_PKEY_ML_DSA_65, NULL, (unsigned char*)public_key_chr, ml_dsa_65_public_key_size), EVP_PKEY_free);
+    import_timer.stop();
     if (!pkey) {
         return false;
     }
@@ -96,7 +102,7 @@ int  generate_csr(
     for (const auto& entry : subject_info) {
         size_t eq_pos = entry.find("=");
         if (eq_pos == std::string::npos || eq_pos == 0 || eq_pos == entry.length() - 1) {
-            std::cerr << "Error: Invalid subject entry format: " << entry << std::endl;
+            record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "subject entry is not key=value");
             return false;
         }
         std::string key = entry.substr(0, eq_pos);
@@ -124,19 +130,23 @@ int  generate_csr(
         handle_openssl_error("EVP_sha256");
         return false;
     }
+    stats_phase_timer sign_timer(stats_phase::sign);
     if (X509_REQ_sign(req.get(), pkey.get(), NULL) <= 0) {
         handle_openssl_error("X509_REQ_sign");
         return false;
     }
+    sign_timer.stop();
 
     // Write CSR to memory buffer 
     BIO_ptr mem(BIO_new(BIO_s_mem()), BIO_free_all);
     if (!mem) return false;
 
+    stats_phase_timer encode_timer(stats_phase::encode);
     if (!PEM_write_bio_X509_REQ(mem.get(), req.get())) {
         BIO_free(mem.get());
         return false;
     }
+    encode_timer.stop();
 
     char* data = nullptr;
     long len = BIO_get_mem_data(mem.get(), &data);
@@ -147,38 +157,22 @@ int  generate_csr(
     if ((size_t)len >= out_csr_buf_size) {
         return false;
     }
+    stats_phase_timer copy_timer(stats_phase::output_copy);
     memcpy(out_csr_buf, data, len);
     out_csr_buf[len] = '\0'; 
+    copy_timer.stop();
 
-    return len;
+    return call.done(len);
 }
 
 
 X509_REQ_ptr load_csr(const std::string& csr_path) {
-    // Read the file into a std::string
-    std::ifstream file(csr_path, std::ios::binary);
-    if (!file) {
-        std::cerr << "Failed to open CSR file: " << csr_path << std::endl;
-        return X509_REQ_ptr(nullptr, X509_REQ_free);
-    }
-
-    std::string pem((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-    // Create a memory BIO with the contents
-    BIO_ptr csr_bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())), BIO_free_all);
-    if (!csr_bio) {
-        handle_openssl_error("BIO_new_mem_buf for loading CSR");
-        return X509_REQ_ptr(nullptr, X509_REQ_free);
-    }
-
-    // Parse the CSR from the BIO
-    X509_REQ* req_raw = PEM_read_bio_X509_REQ(csr_bio.get(), nullptr, nullptr, nullptr);
-    if (!req_raw) {
-        handle_openssl_error("PEM_read_bio_X509_REQ");
+    // Map the file and parse it in place (PEM or DER)
+    mapped_file file(csr_path);
+    if (!file.ok()) {
         return X509_REQ_ptr(nullptr, X509_REQ_free);
     }
-
-    return X509_REQ_ptr(req_raw, X509_REQ_free);
+    return read_x509_req(file.chars(), file.size());
 }
 
 
@@ -191,24 +185,22 @@ int generate_self_signed_certificate(
     size_t out_cert_buf_size,
     int days
 ) {
-    // Load CSR from buffer
-    BIO_ptr csr_bio(BIO_new_mem_buf(csr_buf, static_cast<int>(csr_buf_len)), BIO_free_all);
-    if (!csr_bio) {
-        handle_openssl_error("BIO_new_mem_buf for CSR");
-        return false;
-    }
-    X509_REQ* req_raw = PEM_read_bio_X509_REQ(csr_bio.get(), nullptr, nullptr, nullptr);
-    if (!req_raw) {
-        handle_openssl_error("PEM_read_bio_X509_REQ");
+    stats_call_timer call(stats_call::generate_self_signed_certificate);
+    // Every OpenSSL object below is released together when the scope ends.
+    issuance_arena_scope arena_scope;
+    // Load CSR from buffer (PEM or DER)
+    X509_REQ_ptr req = read_x509_req(csr_buf, csr_buf_len);
+    if (!req) {
         return false;
     }
-    X509_REQ_ptr req(req_raw, X509_REQ_free);
 
+    stats_phase_timer import_timer(stats_phase::key_import);
     EVP_PKEY_ptr ca_pkey(EVP_PKEY_new_raw_private_key(EVP_PKEY_ML_DSA_65, NULL, (unsigned char*)private_key, ml_dsa_65_private_key_size), EVP_PKEY_free);
     if (!ca_pkey) {
         handle_openssl_error("EVP_PKEY_new_raw_private_key");
         return false;
     }
+    import_timer.stop();
 
     // Verify CSR signature
     EVP_PKEY* req_pubkey_raw = X509_REQ_get_pubkey(req.get());
@@ -218,10 +210,12 @@ int generate_self_signed_certificate(
     }
     EVP_PKEY_ptr req_pubkey(req_pubkey_raw, EVP_PKEY_free);
 
+    stats_phase_timer verify_timer(stats_phase::verify);
     if (X509_REQ_verify(req.get(), req_pubkey.get()) != 1) {
         handle_openssl_error("X509_REQ_verify failed (CSR signature invalid or key mismatch)");
         return false;
     }
+    verify_timer.stop();
 
     X509_ptr cert(X509_new(), X509_free);
     if (!cert) {
@@ -236,13 +230,7 @@ int generate_self_signed_certificate(
     }
 
     // Set serial number
-    ASN1_INTEGER_ptr serial(ASN1_INTEGER_new(), ASN1_INTEGER_free);
-    if (!serial || !ASN1_INTEGER_set(serial.get(), 1L)) {
-        handle_openssl_error("ASN1_INTEGER_set or new");
-        return false;
-    }
-    if (X509_set_serialNumber(cert.get(), serial.get()) != 1) {
-        handle_openssl_error("X509_set_serialNumber");
+    if (!assign_certificate_serial(cert.get())) {
         return false;
     }
 
@@ -288,18 +276,22 @@ int generate_self_signed_certificate(
         return false;
     }
     // Sign the certificate with the CA private key (self-signed)
+    stats_phase_timer sign_timer(stats_phase::sign);
     if (X509_sign(cert.get(), ca_pkey.get(), NULL) <= 0) {
         handle_openssl_error("X509_sign");
         return false;
     }
+    sign_timer.stop();
 
     // Write certificate to memory buffer (PEM)
     BIO_ptr mem(BIO_new(BIO_s_mem()), BIO_free_all);
     if (!mem) return false;
 
+    stats_phase_timer encode_timer(stats_phase::encode);
     if (!PEM_write_bio_X509(mem.get(), cert.get())) {
         return false;
     }
+    encode_timer.stop();
 
     char* data = nullptr;
     long len = BIO_get_mem_data(mem.get(), &data);
@@ -310,105 +302,227 @@ int generate_self_signed_certificate(
     if ((size_t)len >= out_cert_buf_size) {
         return false;
     }
+    stats_phase_timer copy_timer(stats_phase::output_copy);
     memcpy(out_cert_buf, data, len);
     out_cert_buf[len] = '\0'; 
+    copy_timer.stop();
 
-    return len;
+    return call.done(len);
 }
 
 
-int sign_certificate(
-    const char* csr_buf,
-    size_t csr_buf_len,
-    const char* ca_cert_buf,
-    size_t ca_cert_buf_len,
-    const char* ca_privkey_buf,
-    size_t ca_privkey_len,
-    char* out_cert_buf,
-    size_t out_cert_buf_size,
-    int days_valid
-) {
-    // Load CSR from buffer
-    BIO_ptr csr_bio(BIO_new_mem_buf(csr_buf, static_cast<int>(csr_buf_len)), BIO_free_all);
-    if (!csr_bio) {
-        handle_openssl_error("BIO_new_mem_buf for CSR");
-        return 0;
-    }
-    X509_REQ* csr_raw = PEM_read_bio_X509_REQ(csr_bio.get(), nullptr, nullptr, nullptr);
-    if (!csr_raw) {
-        handle_openssl_error("PEM_read_bio_X509_REQ");
-        return 0;
-    }
-    X509_REQ_ptr csr(csr_raw, X509_REQ_free);
-
-    // Load CA certificate from buffer
-    BIO_ptr ca_cert_bio(BIO_new_mem_buf(ca_cert_buf, static_cast<int>(ca_cert_buf_len)), BIO_free_all);
-    if (!ca_cert_bio) {
-        handle_openssl_error("BIO_new_mem_buf for CA cert");
-        return 0;
-    }
-    X509* ca_cert_raw = PEM_read_bio_X509(ca_cert_bio.get(), nullptr, nullptr, nullptr);
-    if (!ca_cert_raw) {
-        handle_openssl_error("PEM_read_bio_X509");
-        return 0;
-    }
-    X509_ptr ca_cert(ca_cert_raw, X509_free);
-
-    // Load CA private key from buffer
+// Raw ML-DSA-65 CA private key -> EVP_PKEY.
+static EVP_PKEY_ptr import_ca_private_key(const char* ca_privkey_buf, size_t ca_privkey_len) {
+    stats_phase_timer import_timer(stats_phase::key_import);
     EVP_PKEY_ptr ca_pkey(
         EVP_PKEY_new_raw_private_key(EVP_PKEY_ML_DSA_65, nullptr, (unsigned char*) ca_privkey_buf, ca_privkey_len),
         EVP_PKEY_free);
     if (!ca_pkey) {
         handle_openssl_error("EVP_PKEY_new_raw_private_key");
-        return 0;
     }
+    return ca_pkey;
+}
 
+// Builds and signs one certificate for csr under an already parsed CA.
+static X509_ptr issue_certificate(X509_REQ* csr, X509* ca_cert, EVP_PKEY* ca_pkey, int days_valid) {
     // Create new certificate
     X509_ptr cert(X509_new(), X509_free);
-    if (!cert) return 0;
+    if (!cert) return X509_ptr(nullptr, X509_free);
 
     X509_set_version(cert.get(), 2);  // X.509v3
-    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    if (!assign_certificate_serial(cert.get())) {
+        return X509_ptr(nullptr, X509_free);
+    }
     X509_gmtime_adj(X509_get_notBefore(cert.get()), 0);
     X509_gmtime_adj(X509_get_notAfter(cert.get()), 60 * 60 * 24 * days_valid);
 
     // Set subject and public key from CSR
-    X509_set_subject_name(cert.get(), X509_REQ_get_subject_name(csr.get()));
-    EVP_PKEY_ptr req_pubkey(X509_REQ_get_pubkey(csr.get()), EVP_PKEY_free);
+    X509_set_subject_name(cert.get(), X509_REQ_get_subject_name(csr));
+    EVP_PKEY_ptr req_pubkey(X509_REQ_get_pubkey(csr), EVP_PKEY_free);
     if (!req_pubkey) {
         handle_openssl_error("Extracting public key from CSR");
-        return 0;
+        return X509_ptr(nullptr, X509_free);
     }
     X509_set_pubkey(cert.get(), req_pubkey.get());
 
     // Set issuer from CA certificate
-    X509_set_issuer_name(cert.get(), X509_get_subject_name(ca_cert.get()));
+    X509_set_issuer_name(cert.get(), X509_get_subject_name(ca_cert));
 
     // Sign with CA private key (digest may be ignored for ML-DSA)
-    if (!X509_sign(cert.get(), ca_pkey.get(), nullptr)) {
+    stats_phase_timer sign_timer(stats_phase::sign);
+    if (!X509_sign(cert.get(), ca_pkey, nullptr)) {
         handle_openssl_error("X509_sign");
+        return X509_ptr(nullptr, X509_free);
+    }
+    return cert;
+}
+
+static int sign_certificate_as(
+    const char* csr_buf,
+    size_t csr_buf_len,
+    const char* ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char* ca_privkey_buf,
+    size_t ca_privkey_len,
+    char* out_cert_buf,
+    size_t out_cert_buf_size,
+    int days_valid,
+    bool der_output
+) {
+    stats_call_timer call(stats_call::sign_certificate);
+    // Every OpenSSL object below is released together when the scope ends.
+    issuance_arena_scope arena_scope;
+    // Load CSR and CA certificate from buffers (PEM or DER)
+    X509_REQ_ptr csr = read_x509_req(csr_buf, csr_buf_len);
+    if (!csr) {
+        return 0;
+    }
+    X509_ptr ca_cert = read_x509(ca_cert_buf, ca_cert_buf_len);
+    if (!ca_cert) {
         return 0;
     }
 
-    // Write signed certificate to output buffer
-    BIO_ptr mem(BIO_new(BIO_s_mem()), BIO_free_all);
-    if (!mem) return 0;
+    // Load CA private key from buffer
+    EVP_PKEY_ptr ca_pkey = import_ca_private_key(ca_privkey_buf, ca_privkey_len);
+    if (!ca_pkey) {
+        return 0;
+    }
 
-    if (!PEM_write_bio_X509(mem.get(), cert.get())) {
+    X509_ptr cert = issue_certificate(csr.get(), ca_cert.get(), ca_pkey.get(), days_valid);
+    if (!cert) {
         return 0;
     }
 
-    char* data = nullptr;
-    long len = BIO_get_mem_data(mem.get(), &data);
+    // Write signed certificate to output buffer
+    return call.done(write_x509(cert.get(), der_output, out_cert_buf, out_cert_buf_size));
+}
 
-    if (!data || len <= 0) return 0;
+int sign_certificate(
+    const char* csr_buf,
+    size_t csr_buf_len,
+    const char* ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char* ca_privkey_buf,
+    size_t ca_privkey_len,
+    char* out_cert_buf,
+    size_t out_cert_buf_size,
+    int days_valid
+) {
+    return sign_certificate_as(csr_buf, csr_buf_len, ca_cert_buf, ca_cert_buf_len, ca_privkey_buf, ca_privkey_len,
+                               out_cert_buf, out_cert_buf_size, days_valid, false);
+}
 
-    // Copy to output buffer
-    if ((size_t)len >= out_cert_buf_size) {
-        return 0;
+int sign_certificate_der(
+    const char* csr_buf,
+    size_t csr_buf_len,
+    const char* ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char* ca_privkey_buf,
+    size_t ca_privkey_len,
+    char* out_cert_buf,
+    size_t out_cert_buf_size,
+    int days_valid
+) {
+    return sign_certificate_as(csr_buf, csr_buf_len, ca_cert_buf, ca_cert_buf_len, ca_privkey_buf, ca_privkey_len,
+                               out_cert_buf, out_cert_buf_size, days_valid, true);
+}
+
+// Returns the number of certificates issued, -1 on invalid arguments or an unusable CA
+long sign_certificates_batch(
+    const char **csr_bufs,
+    const size_t *csr_lens,
+    size_t csr_count,
+    const char *ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char *ca_privkey_buf,
+    size_t ca_privkey_len,
+    int days_valid,
+    bool der_output,
+    char *out_buf,
+    size_t out_buf_size,
+    size_t *out_lens,
+    int *out_status,
+    int thread_count
+) {
+    stats_call_timer call(stats_call::sign_certificates_batch);
+    if (csr_count > 0 && (!csr_bufs || !csr_lens || !out_buf || !out_lens || !out_status)) {
+        return -1;
     }
-    memcpy(out_cert_buf, data, len);
-    out_cert_buf[len] = '\0';
 
-    return static_cast<size_t>(len);
+    // The CA is parsed and its key imported once for the whole batch.
+    X509_ptr ca_cert = read_x509(ca_cert_buf, ca_cert_buf_len);
+    if (!ca_cert) {
+        return -1;
+    }
+    EVP_PKEY_ptr ca_pkey = import_ca_private_key(ca_privkey_buf, ca_privkey_len);
+    if (!ca_pkey) {
+        return -1;
+    }
+
+    // Items are encoded into their own buffers in parallel, then packed in order.
+    std::vector<std::string> encoded(csr_count);
+    auto issue_item = [&](size_t i) {
+        issuance_arena_scope arena_scope;
+        X509_REQ_ptr csr = read_x509_req(csr_bufs[i], csr_lens[i]);
+        if (!csr) {
+            out_status[i] = MLDSA_ISSUE_BAD_CSR;
+            return;
+        }
+        X509_ptr cert = issue_certificate(csr.get(), ca_cert.get(), ca_pkey.get(), days_valid);
+        char scratch[mldsa_arena_pem_capacity];
+        int len = cert ? write_x509(cert.get(), der_output, scratch, sizeof(scratch)) : 0;
+        if (len <= 0) {
+            out_status[i] = MLDSA_ISSUE_SIGN_FAILED;
+            return;
+        }
+        encoded[i].assign(scratch, static_cast<size_t>(len));
+        out_status[i] = MLDSA_ISSUE_OK;
+    };
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    size_t workers = thread_count > 0 ? static_cast<size_t>(thread_count) : std::thread::hardware_concurrency();
+    workers = std::max<size_t>(1, std::min(workers, csr_count));
+    if (workers > 1) {
+        // The CA certificate and key are only read; X509_sign uses its own EVP_MD_CTX per call.
+        std::atomic<size_t> next_item{0};
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t w = 0; w < workers; ++w) {
+            pool.emplace_back([&] {
+                for (size_t i = next_item.fetch_add(1); i < csr_count; i = next_item.fetch_add(1)) {
+                    issue_item(i);
+                }
+            });
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    } else
+#endif
+    {
+        (void) thread_count;
+        for (size_t i = 0; i < csr_count; ++i) {
+            issue_item(i);
+        }
+    }
+
+    stats_phase_timer copy_timer(stats_phase::output_copy);
+    size_t offset = 0;
+    long issued = 0;
+    for (size_t i = 0; i < csr_count; ++i) {
+        out_lens[i] = 0;
+        if (out_status[i] != MLDSA_ISSUE_OK) {
+            continue;
+        }
+        if (encoded[i].size() > out_buf_size - offset) {
+            out_status[i] = MLDSA_ISSUE_NO_SPACE;
+            continue;
+        }
+        memcpy(out_buf + offset, encoded[i].data(), encoded[i].size());
+        out_lens[i] = encoded[i].size();
+        offset += encoded[i].size();
+        ++issued;
+    }
+    copy_timer.stop();
+    return call.done(issued, true);
 }
@@ -0,0 +1,41 @@
+#include "mldsa_lib.h"
+
+// src/key_handle.cpp
+#include <new>
+#include <openssl/evp.h>
+#include <openssl/err.h>
+
+// --- Key Handle Implementations ---
+
+mldsa_key_handle* load_mldsa65_private_key(const char *private_key) {
+    if (!private_key) {
+        return nullptr;
+    }
+    stats_phase_timer import_timer(stats_phase::key_import);
+    EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_private_key_ex(NULL, "ML-DSA-65", NULL, (const unsigned char*) private_key, ml_dsa_65_private_key_size), EVP_PKEY_free);
+    import_timer.stop();
+    if (!pkey) {
+        handle_openssl_error("EVP_PKEY_new_raw_private_key_ex for key handle");
+        return nullptr;
+    }
+    return new (std::nothrow) mldsa_key_handle{std::move(pkey), true};
+}
+
+mldsa_key_handle* load_mldsa65_public_key(const char *public_key) {
+    if (!public_key) {
+        return nullptr;
+    }
+    stats_phase_timer import_timer(stats_phase::key_import);
+    EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_public_key_ex(NULL, "ML-DSA-65", NULL, (const unsigned char*) public_key, ml_dsa_65_public_key_size), EVP_PKEY_free);
+    import_timer.stop();
+    if (!pkey) {
+        handle_openssl_error("EVP_PKEY_new_raw_public_key_ex for key handle");
+        return nullptr;
+    }
+    return new (std::nothrow) mldsa_key_handle{std::move(pkey), false};
+}
+
+void free_mldsa65_key_handle(mldsa_key_handle *handle) {
+    // EVP_PKEY_free cleanses the private key material.
+    delete handle;
+}
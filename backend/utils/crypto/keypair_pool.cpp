@@ -0,0 +1,193 @@
+#include "mldsa_lib.h"
+
+// src/keypair_pool.cpp
+// Pre-generated ML-DSA-65 keypairs for registration bursts. Keygen is the slowest ML-DSA
+// operation, so background threads keep a pool topped up to a high-water mark and
+// onboarding takes a ready keypair instead of generating one inline.
+//
+// Secret material lives only in one fixed slot array allocated at start (never
+// reallocated, so no stale copies), locked into RAM where the platform allows it, and
+// every slot and scratch buffer is cleansed as soon as its key leaves or the pool stops.
+//
+// WASM builds without pthreads have no refill threads; the caller tops the pool up from
+// idle time with mldsa_keypair_pool_refill instead.
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include <openssl/crypto.h>
+#ifndef __EMSCRIPTEN__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+struct pooled_keypair {
+    unsigned char private_key[ml_dsa_65_private_key_size];
+    unsigned char public_key[ml_dsa_65_public_key_size];
+};
+
+std::mutex pool_mutex;
+std::condition_variable refill_cv;
+std::condition_variable idle_cv; // signalled when the last in-flight keygen finishes
+pooled_keypair *slots = nullptr;
+size_t capacity = 0;
+size_t count = 0;
+size_t generating = 0; // keys being generated outside the lock, so refills do not overshoot
+bool running = false;
+bool stopping = false;
+std::vector<std::thread> refill_threads;
+
+// Generates one keypair outside the lock and stores it if there is still room.
+// Returns false when the pool is full or stopping, or keygen failed.
+bool generate_into_pool() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!running || stopping || count + generating >= capacity) {
+            return false;
+        }
+        ++generating;
+    }
+    pooled_keypair scratch;
+    bool ok = generate_mldsa65_keypair(reinterpret_cast<char*>(scratch.private_key),
+                                       reinterpret_cast<char*>(scratch.public_key));
+    bool stored = false;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        --generating;
+        if (ok && running && !stopping && count < capacity) {
+            memcpy(&slots[count++], &scratch, sizeof(scratch));
+            stored = true;
+        }
+        if (generating == 0) {
+            idle_cv.notify_all();
+        }
+    }
+    OPENSSL_cleanse(&scratch, sizeof(scratch));
+    return stored;
+}
+
+void refill_loop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex);
+            refill_cv.wait(lock, [] { return stopping || count + generating < capacity; });
+            if (stopping) {
+                return;
+            }
+        }
+        if (!generate_into_pool()) {
+            // Keygen failing (or a lost race for the last slot): back off instead of spinning.
+            std::unique_lock<std::mutex> lock(pool_mutex);
+            refill_cv.wait_for(lock, std::chrono::milliseconds(100), [] { return stopping; });
+        }
+    }
+}
+
+// Stops the refill threads and cleanses whatever is left when the process exits.
+// atexit handlers run in reverse order, so registering this after OPENSSL_init_crypto
+// makes it run before OpenSSL's own cleanup, while keygen can still finish safely.
+void stop_at_exit() {
+    mldsa_keypair_pool_stop();
+}
+
+} // namespace
+
+bool mldsa_keypair_pool_start(size_t high_water, int thread_count) {
+    static std::once_flag exit_hook;
+    std::call_once(exit_hook, [] {
+        OPENSSL_init_crypto(0, nullptr);
+        atexit(stop_at_exit);
+    });
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    if (running || stopping || high_water == 0) {
+        return false;
+    }
+    slots = new (std::nothrow) pooled_keypair[high_water];
+    if (!slots) {
+        return false;
+    }
+#ifndef __EMSCRIPTEN__
+    // Best effort: keep pooled private keys out of swap.
+    mlock(slots, high_water * sizeof(pooled_keypair));
+#endif
+    capacity = high_water;
+    count = 0;
+    running = true;
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    for (int i = 0; i < thread_count; ++i) {
+        refill_threads.emplace_back(refill_loop);
+    }
+#else
+    (void) thread_count;
+#endif
+    return true;
+}
+
+int mldsa_keypair_pool_take(char *private_key, char *public_key) {
+    if (!private_key || !public_key) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (running && count > 0) {
+            pooled_keypair& slot = slots[--count];
+            memcpy(private_key, slot.private_key, sizeof(slot.private_key));
+            memcpy(public_key, slot.public_key, sizeof(slot.public_key));
+            OPENSSL_cleanse(&slot, sizeof(slot));
+            refill_cv.notify_one();
+            return 1;
+        }
+    }
+    // Pool drained (or not started): fall back to inline keygen rather than fail the registration.
+    return generate_mldsa65_keypair(private_key, public_key) ? 2 : 0;
+}
+
+size_t mldsa_keypair_pool_refill(size_t max_keys) {
+    size_t generated = 0;
+    while (generated < max_keys && generate_into_pool()) {
+        ++generated;
+    }
+    return generated;
+}
+
+size_t mldsa_keypair_pool_size(void) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    return count;
+}
+
+void mldsa_keypair_pool_stop(void) {
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!running || stopping) {
+            return;
+        }
+        stopping = true;
+        threads.swap(refill_threads);
+    }
+    refill_cv.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    // An mldsa_keypair_pool_refill call may still be generating; it must finish before the
+    // slots go away and before a restart can see its count.
+    idle_cv.wait(lock, [] { return generating == 0; });
+    // Unused keys must not outlive the pool.
+    OPENSSL_cleanse(slots, capacity * sizeof(pooled_keypair));
+#ifndef __EMSCRIPTEN__
+    munlock(slots, capacity * sizeof(pooled_keypair));
+#endif
+    delete[] slots;
+    slots = nullptr;
+    capacity = 0;
+    count = 0;
+    running = false;
+    stopping = false;
+}
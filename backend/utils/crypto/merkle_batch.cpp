@@ -0,0 +1,263 @@
+#include "mldsa_lib.h"
+
+// src/merkle_batch.cpp
+// Batch signing: one ML-DSA-65 signature over a SHA-256 Merkle tree of many documents.
+//
+// The tree follows RFC 6962: leaf = H(0x00 || SHA-256(document)), node = H(0x01 || left || right),
+// and an unpaired node at the end of a level moves up unchanged. The signature covers
+//   "mldsa-merkle-v1" || leaf count (u32 BE) || root
+// so it cannot be confused with an ordinary document signature or with a tree of another size.
+//
+// Each document gets an inclusion proof (big-endian):
+//   [0..1]   'M' 'P'
+//   [2]      version
+//   [3..6]   leaf index
+//   [7..10]  leaf count
+//   [11]     path length n
+//   n * 32   sibling hashes, leaf level first
+// A proof is 12 + 32 * ceil(log2(count)) bytes (300 bytes for 512 documents) and is checked
+// together with the batch's single shared signature.
+#include <array>
+#include <cstring>
+#include <vector>
+#include <openssl/evp.h>
+
+namespace {
+
+using merkle_hash = std::array<unsigned char, 32>;
+
+constexpr unsigned char root_tag[] = {'m', 'l', 'd', 's', 'a', '-', 'm', 'e', 'r', 'k', 'l', 'e', '-', 'v', '1'};
+constexpr size_t root_message_size = sizeof(root_tag) + 4 + 32;
+constexpr unsigned char proof_magic[2] = {'M', 'P'};
+constexpr unsigned char proof_version = 1;
+constexpr size_t proof_header_size = 12;
+constexpr size_t max_path_length = 32;
+
+void put_u32(unsigned char *out, uint32_t v) {
+    out[0] = static_cast<unsigned char>(v >> 24);
+    out[1] = static_cast<unsigned char>(v >> 16);
+    out[2] = static_cast<unsigned char>(v >> 8);
+    out[3] = static_cast<unsigned char>(v);
+}
+
+uint32_t get_u32(const unsigned char *in) {
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+}
+
+bool leaf_hash(const char *doc, size_t doc_len, merkle_hash& out) {
+    unsigned char input[33];
+    input[0] = 0x00;
+    if (EVP_Digest(doc, doc_len, input + 1, nullptr, EVP_sha256(), nullptr) != 1 ||
+        EVP_Digest(input, sizeof(input), out.data(), nullptr, EVP_sha256(), nullptr) != 1) {
+        handle_openssl_error("EVP_Digest for Merkle leaf");
+        return false;
+    }
+    return true;
+}
+
+bool node_hash(const merkle_hash& left, const merkle_hash& right, merkle_hash& out) {
+    unsigned char input[65];
+    input[0] = 0x01;
+    memcpy(input + 1, left.data(), 32);
+    memcpy(input + 33, right.data(), 32);
+    if (EVP_Digest(input, sizeof(input), out.data(), nullptr, EVP_sha256(), nullptr) != 1) {
+        handle_openssl_error("EVP_Digest for Merkle node");
+        return false;
+    }
+    return true;
+}
+
+void root_message(uint32_t leaf_count, const merkle_hash& root, unsigned char *out) {
+    memcpy(out, root_tag, sizeof(root_tag));
+    put_u32(out + sizeof(root_tag), leaf_count);
+    memcpy(out + sizeof(root_tag) + 4, root.data(), root.size());
+}
+
+size_t path_length(size_t leaf_count) {
+    size_t length = 0;
+    for (size_t width = leaf_count; width > 1; width = (width + 1) / 2) {
+        ++length;
+    }
+    return length;
+}
+
+// Recomputes the root from a document and its proof (RFC 9162 section 2.1.3.2).
+bool root_from_proof(const char *doc, size_t doc_len, const unsigned char *proof, size_t proof_len,
+                     uint32_t& leaf_count, merkle_hash& root) {
+    if (!proof || proof_len < proof_header_size || memcmp(proof, proof_magic, sizeof(proof_magic)) != 0 ||
+        proof[2] != proof_version) {
+        return false;
+    }
+    uint32_t index = get_u32(proof + 3);
+    leaf_count = get_u32(proof + 7);
+    size_t path_len = proof[11];
+    if (index >= leaf_count || path_len > max_path_length || proof_len != proof_header_size + path_len * 32) {
+        return false;
+    }
+    if (!leaf_hash(doc, doc_len, root)) {
+        return false;
+    }
+    uint32_t fn = index;
+    uint32_t sn = leaf_count - 1;
+    merkle_hash sibling;
+    for (size_t i = 0; i < path_len; ++i) {
+        if (sn == 0) {
+            return false;
+        }
+        memcpy(sibling.data(), proof + proof_header_size + i * 32, 32);
+        bool ok;
+        if ((fn & 1) || fn == sn) {
+            ok = node_hash(sibling, root, root);
+            // Skip the levels where this node had no sibling and moved up unchanged.
+            while (!(fn & 1) && fn != 0) {
+                fn >>= 1;
+                sn >>= 1;
+            }
+        } else {
+            ok = node_hash(root, sibling, root);
+        }
+        if (!ok) {
+            return false;
+        }
+        fn >>= 1;
+        sn >>= 1;
+    }
+    return sn == 0;
+}
+
+} // namespace
+
+long mldsa_merkle_sign_batch(
+    const char *private_key,
+    const char **doc_bufs,
+    const size_t *doc_lens,
+    size_t doc_count,
+    unsigned char *signature_buf,
+    size_t signature_buf_size,
+    unsigned char *proofs_out,
+    size_t proofs_out_size,
+    size_t *proof_lens
+) {
+    stats_call_timer call(stats_call::merkle_sign_batch);
+    if (!private_key || !doc_bufs || !doc_lens || doc_count == 0 || doc_count > UINT32_MAX ||
+        !signature_buf || !proofs_out || !proof_lens) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, doc_count, "mldsa_merkle_sign_batch");
+        return -1;
+    }
+    size_t path_len = path_length(doc_count);
+    size_t proof_size = proof_header_size + path_len * 32;
+    if (proofs_out_size / proof_size < doc_count) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, proofs_out_size, "mldsa_merkle_sign_batch proof buffer");
+        return -1;
+    }
+
+    // levels[0] holds the leaves, levels.back() the root.
+    std::vector<std::vector<merkle_hash>> levels(1);
+    levels[0].resize(doc_count);
+    for (size_t i = 0; i < doc_count; ++i) {
+        if ((doc_lens[i] > 0 && !doc_bufs[i]) || !leaf_hash(doc_bufs[i], doc_lens[i], levels[0][i])) {
+            return -1;
+        }
+    }
+    while (levels.back().size() > 1) {
+        const std::vector<merkle_hash>& below = levels.back();
+        std::vector<merkle_hash> above((below.size() + 1) / 2);
+        for (size_t i = 0; i + 1 < below.size(); i += 2) {
+            if (!node_hash(below[i], below[i + 1], above[i / 2])) {
+                return -1;
+            }
+        }
+        if (below.size() % 2) {
+            above.back() = below.back();
+        }
+        levels.push_back(std::move(above));
+    }
+
+    unsigned char message[root_message_size];
+    root_message(static_cast<uint32_t>(doc_count), levels.back()[0], message);
+    int sig_len = sign_mldsa65(private_key, reinterpret_cast<const char*>(message), sizeof(message),
+                               signature_buf, signature_buf_size);
+    if (sig_len <= 0) {
+        return -1;
+    }
+
+    stats_phase_timer encode_timer(stats_phase::encode);
+    unsigned char *out = proofs_out;
+    for (size_t leaf = 0; leaf < doc_count; ++leaf) {
+        unsigned char *path = out + proof_header_size;
+        size_t written = 0;
+        size_t index = leaf;
+        for (size_t level = 0; level + 1 < levels.size(); ++level, index >>= 1) {
+            size_t sibling = index ^ 1;
+            if (sibling < levels[level].size()) {
+                memcpy(path + written * 32, levels[level][sibling].data(), 32);
+                ++written;
+            }
+        }
+        out[0] = proof_magic[0];
+        out[1] = proof_magic[1];
+        out[2] = proof_version;
+        put_u32(out + 3, static_cast<uint32_t>(leaf));
+        put_u32(out + 7, static_cast<uint32_t>(doc_count));
+        out[11] = static_cast<unsigned char>(written);
+        proof_lens[leaf] = proof_header_size + written * 32;
+        out += proof_lens[leaf];
+    }
+    encode_timer.stop();
+    return call.done(static_cast<long>(sig_len));
+}
+
+int mldsa_merkle_verify(
+    const char *public_key,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const unsigned char *proof,
+    size_t proof_len,
+    const char *doc_buf,
+    size_t doc_len
+) {
+    stats_call_timer call(stats_call::merkle_verify);
+    uint32_t leaf_count;
+    merkle_hash root;
+    if (!public_key || !signature_buf || (doc_len > 0 && !doc_buf) ||
+        !root_from_proof(doc_buf, doc_len, proof, proof_len, leaf_count, root)) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, proof_len, "malformed Merkle proof");
+        return -1;
+    }
+    unsigned char message[root_message_size];
+    root_message(leaf_count, root, message);
+    mldsa_key_handle *handle = load_mldsa65_public_key(public_key);
+    if (!handle) {
+        return -1;
+    }
+    bool valid = verify_mldsa65_with_handle(handle, signature_buf, signature_len,
+                                            reinterpret_cast<const char*>(message), sizeof(message));
+    free_mldsa65_key_handle(handle);
+    return call.done(valid ? 1 : 0);
+}
+
+int mldsa_merkle_verify_with_cert(
+    const char *cert_buf,
+    size_t cert_len,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const unsigned char *proof,
+    size_t proof_len,
+    const char *doc_buf,
+    size_t doc_len
+) {
+    stats_call_timer call(stats_call::merkle_verify);
+    uint32_t leaf_count;
+    merkle_hash root;
+    if (!cert_buf || !signature_buf || (doc_len > 0 && !doc_buf) ||
+        !root_from_proof(doc_buf, doc_len, proof, proof_len, leaf_count, root)) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, proof_len, "malformed Merkle proof");
+        return -1;
+    }
+    unsigned char message[root_message_size];
+    root_message(leaf_count, root, message);
+    // Goes through the verify key cache and the revocation index like any certificate verification.
+    bool valid = verify_signature_with_cert(cert_buf, cert_len, signature_buf, signature_len,
+                                            reinterpret_cast<const char*>(message), sizeof(message));
+    return call.done(valid ? 1 : 0);
+}
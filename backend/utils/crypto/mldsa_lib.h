@@ -3,6 +3,7 @@
 #define CRYPTO_LIB_H
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -20,8 +21,218 @@ using ossl_unique_ptr = std::unique_ptr<T, decltype(Func)>;
 using BIO_ptr = ossl_unique_ptr<BIO, BIO_free_all>;
 using EVP_PKEY_ptr = ossl_unique_ptr<EVP_PKEY, EVP_PKEY_free>;
 using X509_ptr = ossl_unique_ptr<X509, X509_free>;
+using X509_REQ_ptr = ossl_unique_ptr<X509_REQ, X509_REQ_free>;
 const int ml_dsa_65_public_key_size = 1952;
 const int ml_dsa_65_private_key_size = 4032;
+const int ml_dsa_65_signature_size = 3309;
+const size_t mldsa_status_token_size = 50; // see status_token.cpp
+const size_t mldsa_qr_fingerprint_size = 32; // SHA-256, see qr_payload.cpp
+const unsigned char mldsa_qr_payload_version = 1;
+
+/**
+ * @brief A parsed ML-DSA-65 key kept alive across calls.
+ * Created by load_mldsa65_private_key / load_mldsa65_public_key so the raw key
+ * is imported once per session instead of once per document.
+ */
+struct mldsa_key_handle {
+    EVP_PKEY_ptr pkey;
+    bool has_private;
+};
+
+/**
+ * @brief Reusable signing context bound to one private key (defined in signing.cpp).
+ */
+struct mldsa_sign_ctx;
+
+/**
+ * @brief Incremental ML-DSA-65 signer fed one chunk at a time (external mu, defined in signing.cpp).
+ */
+struct mldsa_sign_stream;
+
+/**
+ * @brief Scratch regions of an mldsa_arena, sized to ML-DSA-65 maxima.
+ * Key and signature regions are fixed; the others grow with mldsa_arena_reserve.
+ */
+enum mldsa_arena_region {
+    MLDSA_ARENA_PRIVATE_KEY = 0,
+    MLDSA_ARENA_PUBLIC_KEY = 1,
+    MLDSA_ARENA_SIGNATURE = 2,
+    MLDSA_ARENA_MESSAGE = 3,
+    MLDSA_ARENA_INPUT = 4,      // certificate or CSR input
+    MLDSA_ARENA_CA_INPUT = 5,   // CA certificate input
+    MLDSA_ARENA_OUTPUT = 6,     // PEM output (CSR or certificate)
+    MLDSA_ARENA_REGION_COUNT = 7
+};
+const size_t mldsa_arena_pem_capacity = 16 * 1024;
+
+/**
+ * @brief Caller-owned, reusable scratch memory for the exported functions (defined in arena.cpp).
+ */
+struct mldsa_arena;
+/**
+ * @brief Routes OpenSSL allocations on this thread into a per-request arena (see ossl_arena.cpp).
+ * Everything is freed in one shot when the scope ends. No-op unless mldsa_install_allocator_hooks succeeded.
+ */
+class issuance_arena_scope {
+public:
+    issuance_arena_scope();
+    ~issuance_arena_scope();
+    issuance_arena_scope(const issuance_arena_scope&) = delete;
+    issuance_arena_scope& operator=(const issuance_arena_scope&) = delete;
+};
+
+// --- Certificate Encoding (cert_format.cpp) ---
+// Certificate and CSR inputs may be PEM or DER; DER is detected by its leading SEQUENCE tag.
+bool is_der_encoded(const char *buf, size_t len);
+X509_ptr read_x509(const char *buf, size_t len);
+X509_REQ_ptr read_x509_req(const char *buf, size_t len);
+/**
+ * @brief Writes cert as DER or NUL-terminated PEM.
+ * @return Bytes written (excluding the PEM terminator), 0 if out_buf is too small or encoding failed.
+ */
+int write_x509(X509 *cert, bool der, char *out_buf, size_t out_buf_size);
+
+// --- Serial Numbers (serial.cpp) ---
+/**
+ * @brief Sets a fresh unique serial (see mldsa_serial_next) on cert.
+ */
+bool assign_certificate_serial(X509 *cert);
+
+// --- Revocation (revocation.cpp) ---
+/**
+ * @brief Identifies a certificate in the revocation index: issuer name hash plus serial.
+ */
+struct revocation_ref {
+    unsigned long issuer_hash = 0;
+    uint8_t serial_len = 0; // 0 when the serial is not indexable (never reported revoked)
+    unsigned char serial[32];
+};
+bool make_revocation_ref(X509 *cert, revocation_ref& ref);
+/**
+ * @brief Looks ref up in the loaded revocation index. Takes no lock and never waits on a CRL reload.
+ */
+bool is_revoked(const revocation_ref& ref);
+bool certificate_is_revoked(X509 *cert);
+
+// --- QR Payloads (qr_payload.cpp) ---
+/**
+ * @brief A parsed QR payload. Every pointer aims into the scanned buffer; nothing is copied.
+ */
+struct qr_payload_view {
+    unsigned char version;
+    const unsigned char *fingerprint; // mldsa_qr_fingerprint_size bytes
+    const char *message;
+    size_t message_len;
+    const unsigned char *signature;
+    size_t signature_len;
+};
+bool parse_qr_payload(const unsigned char *payload, size_t payload_len, qr_payload_view& view);
+/**
+ * @brief Walks the fields of a message built by mldsa_qr_message_encode, in place.
+ */
+struct qr_field_cursor {
+    const unsigned char *pos;
+    const unsigned char *end;
+    size_t remaining;
+};
+bool open_qr_fields(const char *message, size_t message_len, qr_field_cursor& cursor);
+bool next_qr_field(qr_field_cursor& cursor, const char *&data, size_t& len);
+
+// --- Stats (stats.cpp) ---
+// Lock-free call counters and latency histograms, exported by mldsa_stats_export.
+enum class stats_phase : int {
+    parse,        // PEM / DER certificate and CSR parsing
+    key_import,   // raw ML-DSA-65 key -> EVP_PKEY
+    keygen,
+    sign,
+    verify,
+    encode,       // certificate / CSR serialization
+    output_copy,  // copying results into caller buffers
+    count
+};
+
+enum class stats_call : int {
+    generate_keypair,
+    generate_csr,
+    generate_self_signed_certificate,
+    sign_certificate,
+    sign_certificates_batch,
+    sign,
+    sign_with_handle,
+    sign_with_ctx,
+    sign_stream,
+    verify,
+    verify_with_handle,
+    verify_with_cert,
+    verify_batch,
+    verify_certificate_issued_by_ca,
+    merkle_sign_batch,
+    merkle_verify,
+    count
+};
+
+/**
+ * @brief Monotonic nanoseconds, or 0 when stats are disabled (timers then record nothing).
+ */
+uint64_t stats_clock_ns();
+void stats_record_phase(stats_phase phase, uint64_t start_ns);
+void stats_record_call(stats_call call, uint64_t start_ns, bool ok);
+
+/**
+ * @brief Times one phase from construction until stop() or the end of the scope.
+ */
+class stats_phase_timer {
+public:
+    explicit stats_phase_timer(stats_phase phase) : phase_(phase), start_(stats_clock_ns()) {}
+    ~stats_phase_timer() { stop(); }
+    stats_phase_timer(const stats_phase_timer&) = delete;
+    stats_phase_timer& operator=(const stats_phase_timer&) = delete;
+
+    void stop() {
+        if (start_) stats_record_phase(phase_, start_);
+        start_ = 0;
+    }
+
+private:
+    stats_phase phase_;
+    uint64_t start_;
+};
+
+/**
+ * @brief Counts one exported call. Leaving the scope without done() records a failure,
+ * so only the success return needs touching: `return call.done(len);`.
+ */
+class stats_call_timer {
+public:
+    explicit stats_call_timer(stats_call call) : call_(call), start_(stats_clock_ns()) {}
+    ~stats_call_timer() { finish(false); }
+    stats_call_timer(const stats_call_timer&) = delete;
+    stats_call_timer& operator=(const stats_call_timer&) = delete;
+
+    /** @brief Records the call as succeeded when result is non-zero and passes it through. */
+    template<typename T>
+    T done(T result) {
+        finish(result != T{});
+        return result;
+    }
+
+    /** @brief Same, for results where zero can be a success (e.g. a count). */
+    template<typename T>
+    T done(T result, bool ok) {
+        finish(ok);
+        return result;
+    }
+
+private:
+    void finish(bool ok) {
+        if (start_) stats_record_call(call_, start_, ok);
+        start_ = 0;
+    }
+
+    stats_call call_;
+    uint64_t start_;
+};
+
 // --- Error Handling ---
 
 #ifdef __EMSCRIPTEN__
@@ -31,7 +242,33 @@ const int ml_dsa_65_private_key_size = 4032;
   #define EXPOSE_WASM
 #endif 
 
+/**
+ * @brief Failure classes recorded in the error rings (errors.cpp).
+ */
+enum mldsa_error_code {
+    MLDSA_ERR_OPENSSL = 1,            // detail: packed OpenSSL error code
+    MLDSA_ERR_INVALID_SIGNATURE = 2,  // signature did not verify
+    MLDSA_ERR_CERT_CHAIN = 3,         // detail: X509_V_ERR_* from chain verification
+    MLDSA_ERR_FILE_IO = 4,            // detail: errno
+    MLDSA_ERR_INVALID_ARGUMENT = 5,
+    MLDSA_ERR_CODE_COUNT = 6
+};
+
+/**
+ * @brief Records an error in the calling thread's ring instead of printing it.
+ * @param context Must be a string literal (or otherwise outlive the process): only the pointer is stored.
+ */
+void record_error(mldsa_error_code code, unsigned long detail, const char *context);
+/**
+ * @brief Records the first queued OpenSSL error under context and clears the rest of the queue.
+ */
 void handle_openssl_error(const char* context);
+/**
+ * @brief Returns the code of the last error recorded on the calling thread since the previous call
+ * (0 if none) and forgets it, so a caller can tell why a check it just ran failed.
+ * @param detail Receives that error's detail; may be NULL.
+ */
+int take_last_error(unsigned long *detail);
 X509_ptr load_certificate(const std::string& cert_path);
 // --- Helper Functions ---
 
@@ -44,6 +281,31 @@ X509_ptr load_certificate(const std::string& cert_path);
 bool read_file_bytes(const std::string& file_path, std::vector<unsigned char>& data);
 int read_file_char (const char *file_path, char* data);
 
+/**
+ * @brief Read-only view of a whole file, memory-mapped when it is a regular file.
+ * Pipes, character devices and other non-regular files (and WASM builds) fall back to a
+ * buffered read. data() stays valid for the lifetime of the object.
+ */
+class mapped_file {
+public:
+    explicit mapped_file(const std::string& file_path);
+    ~mapped_file();
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    bool ok() const { return ok_; }
+    const unsigned char* data() const { return data_; }
+    const char* chars() const { return reinterpret_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    bool ok_ = false;
+    const unsigned char *data_ = nullptr;
+    size_t size_ = 0;
+    void *mapping_ = nullptr;
+    std::vector<unsigned char> buffer_;
+};
+
 /**
  * @brief Writes a byte vector to a file.
  * @param file_path Path to the file.
@@ -102,6 +364,70 @@ EXPOSE_WASM int sign_certificate(
     size_t out_cert_buf_size,
     int days_valid
 );
+/**
+ * @brief Same as sign_certificate but writes the certificate as DER (no PEM terminator).
+ * Like every certificate entry point, the CSR and CA certificate may be PEM or DER.
+ * @return DER length on success, 0 on failure.
+ */
+EXPOSE_WASM int sign_certificate_der(
+    const char* csr_buf,
+    size_t csr_buf_len,
+    const char* ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char* ca_privkey_buf,
+    size_t ca_privkey_len,
+    char* out_cert_buf,
+    size_t out_cert_buf_size,
+    int days_valid
+);
+
+/**
+ * @brief Per-item status written by sign_certificates_batch.
+ */
+enum mldsa_issue_status {
+    MLDSA_ISSUE_OK = 0,
+    MLDSA_ISSUE_BAD_CSR = 1,      // CSR could not be parsed
+    MLDSA_ISSUE_SIGN_FAILED = 2,  // signing or encoding failed
+    MLDSA_ISSUE_NO_SPACE = 3      // issued, but did not fit in out_buf
+};
+
+/**
+ * @brief Issues one certificate per CSR under a single CA.
+ * The CA certificate is parsed and its private key imported once for the whole batch.
+ * In the native build the CSRs are spread across worker threads.
+ * Certificates are packed back to back into out_buf in input order, without PEM terminators.
+ * @param csr_bufs Per-item CSR buffers (PEM or DER).
+ * @param csr_lens Per-item CSR lengths.
+ * @param csr_count Number of CSRs.
+ * @param ca_cert_buf CA certificate (PEM or DER).
+ * @param ca_cert_buf_len Length of ca_cert_buf.
+ * @param ca_privkey_buf Raw CA private key.
+ * @param ca_privkey_len Length of ca_privkey_buf.
+ * @param days_valid Validity period of every certificate.
+ * @param der_output true for DER certificates, false for PEM.
+ * @param out_buf Packed output buffer.
+ * @param out_buf_size Size of out_buf.
+ * @param out_lens Per-item certificate length in out_buf, 0 unless the status is MLDSA_ISSUE_OK.
+ * @param out_status Per-item mldsa_issue_status.
+ * @param thread_count Worker threads to use, 0 for one per hardware thread. Ignored in WASM.
+ * @return number of certificates issued, -1 on invalid arguments or if the CA certificate or key is unusable.
+ */
+EXPOSE_WASM long sign_certificates_batch(
+    const char **csr_bufs,
+    const size_t *csr_lens,
+    size_t csr_count,
+    const char *ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char *ca_privkey_buf,
+    size_t ca_privkey_len,
+    int days_valid,
+    bool der_output,
+    char *out_buf,
+    size_t out_buf_size,
+    size_t *out_lens,
+    int *out_status,
+    int thread_count
+);
 /**
  * @brief Generates a Certificate Signing Request (CSR) using a private key.
  * @param private_key_char The private key buffer
@@ -167,6 +493,98 @@ EXPOSE_WASM int sign_mldsa65(
  * @return true if signature is valid, false otherwise (or on error).
  */
 EXPOSE_WASM bool verify_mldsa65(const char *public_key_chr, const char *signature_path, const char *message_chr, int message_len);
+// --- Key Handles ---
+
+/**
+ * @brief Imports a raw ML-DSA-65 private key once and returns a reusable handle.
+ * @param private_key The raw private key buffer (ml_dsa_65_private_key_size bytes).
+ * @return Handle on success, nullptr on failure. Release with free_mldsa65_key_handle.
+ */
+EXPOSE_WASM mldsa_key_handle* load_mldsa65_private_key(const char *private_key);
+
+/**
+ * @brief Imports a raw ML-DSA-65 public key once and returns a reusable handle.
+ * @param public_key The raw public key buffer (ml_dsa_65_public_key_size bytes).
+ * @return Handle on success, nullptr on failure. Release with free_mldsa65_key_handle.
+ */
+EXPOSE_WASM mldsa_key_handle* load_mldsa65_public_key(const char *public_key);
+EXPOSE_WASM void free_mldsa65_key_handle(mldsa_key_handle *handle);
+
+/**
+ * @brief Signs a message with a previously loaded private key handle.
+ * @return signature length on success, 0 on failure.
+ */
+EXPOSE_WASM int sign_mldsa65_with_handle(
+    mldsa_key_handle *handle,
+    const char *message,
+    size_t message_len,
+    unsigned char *signature_buf,
+    size_t signature_buf_size
+);
+
+/**
+ * @brief Creates a signing context that keeps an initialized EVP_PKEY_CTX for the key.
+ * The context holds its own reference to the key, so the handle may be freed first.
+ * A context must not be shared between threads.
+ * @param handle A private key handle.
+ * @return Context on success, nullptr on failure. Release with free_mldsa65_sign_ctx.
+ */
+EXPOSE_WASM mldsa_sign_ctx* new_mldsa65_sign_ctx(mldsa_key_handle *handle);
+
+/**
+ * @brief Signs a message with a signing context, skipping the signature size probe.
+ * @param signature_buf_size Must be at least ml_dsa_65_signature_size.
+ * @return signature length on success, 0 on failure.
+ */
+EXPOSE_WASM int sign_mldsa65_with_ctx(
+    mldsa_sign_ctx *ctx,
+    const char *message,
+    size_t message_len,
+    unsigned char *signature_buf,
+    size_t signature_buf_size
+);
+
+/**
+ * @brief Re-initializes a signing context, e.g. after a failed signature.
+ * @return true on success, false on failure.
+ */
+EXPOSE_WASM bool reset_mldsa65_sign_ctx(mldsa_sign_ctx *ctx);
+EXPOSE_WASM void free_mldsa65_sign_ctx(mldsa_sign_ctx *ctx);
+
+/**
+ * @brief Starts a streaming signature for messages too large to hold in memory.
+ * The message is hashed chunk by chunk into ML-DSA's mu, so memory use is constant;
+ * the result is a normal ML-DSA-65 signature that verify_mldsa65 accepts.
+ * @param handle Private key handle; the stream keeps its own reference.
+ * @return Stream on success, nullptr on failure. Release with free_mldsa65_sign_stream.
+ */
+EXPOSE_WASM mldsa_sign_stream* new_mldsa65_sign_stream(mldsa_key_handle *handle);
+
+/**
+ * @brief Feeds the next chunk of the message.
+ * @return true on success; after a failure the stream only recovers through final_mldsa65_sign_stream.
+ */
+EXPOSE_WASM bool update_mldsa65_sign_stream(mldsa_sign_stream *stream, const char *chunk, size_t chunk_len);
+
+/**
+ * @brief Signs everything fed so far and restarts the stream for the next message.
+ * @param signature_buf Output buffer of at least ml_dsa_65_signature_size bytes.
+ * @return signature length on success, 0 on failure.
+ */
+EXPOSE_WASM int final_mldsa65_sign_stream(mldsa_sign_stream *stream, unsigned char *signature_buf, size_t signature_buf_size);
+EXPOSE_WASM void free_mldsa65_sign_stream(mldsa_sign_stream *stream);
+
+/**
+ * @brief Verifies a signature with a previously loaded key handle (public or private).
+ * @return true if signature is valid, false otherwise (or on error).
+ */
+EXPOSE_WASM bool verify_mldsa65_with_handle(
+    mldsa_key_handle *handle,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const char *message_chr,
+    int message_len
+);
 // --- X.509 Operations ---
 
 /**
@@ -186,6 +604,551 @@ EXPOSE_WASM bool extract_pubkey_from_cert(const std::string& certificate_path, c
  * @return true if signature is valid, false otherwise (or on error).
  */
 EXPOSE_WASM bool verify_signature_with_cert(const char *certificate_buf, size_t certificate_len, const unsigned char *signature_buf, size_t signature_len, const char *message_chr, int message_len);
+
+/**
+ * @brief Verifies many signatures against a shared certificate table.
+ * Each certificate is parsed once. Item i is checked against certificate cert_indices[i].
+ * In the native build the items are spread across worker threads.
+ * @param certificate_bufs Array of certificate buffers (PEM or DER).
+ * @param certificate_lens Length of each certificate buffer.
+ * @param certificate_count Number of certificates in the table.
+ * @param cert_indices Per-item index into the certificate table.
+ * @param signature_bufs Per-item signature buffers.
+ * @param signature_lens Per-item signature lengths.
+ * @param message_bufs Per-item message buffers.
+ * @param message_lens Per-item message lengths. Items longer than INT32_MAX fail.
+ * @param item_count Number of items to verify.
+ * @param result_bitmap Output bitmap, bit (i % 8) of byte (i / 8) is set when item i is valid.
+ * @param result_bitmap_size Size of result_bitmap, at least (item_count + 7) / 8 bytes.
+ * @param thread_count Worker threads to use, 0 for one per hardware thread. Ignored in WASM.
+ * @return number of valid signatures, -1 on invalid arguments.
+ */
+EXPOSE_WASM int verify_signature_batch(
+    const char **certificate_bufs,
+    const size_t *certificate_lens,
+    size_t certificate_count,
+    const uint32_t *cert_indices,
+    const unsigned char **signature_bufs,
+    const size_t *signature_lens,
+    const char **message_bufs,
+    const size_t *message_lens,
+    size_t item_count,
+    unsigned char *result_bitmap,
+    size_t result_bitmap_size,
+    int thread_count
+);
+
+/**
+ * @brief Drops the cached CA trust stores used by verify_certificate_issued_by_ca.
+ * Call after a CA is rotated or revoked; the next verification rebuilds its store.
+ */
+EXPOSE_WASM void mldsa_clear_trust_store_cache(void);
+
+/**
+ * @brief Sets how many certificates' verify keys verify_signature_with_cert and
+ * verify_signature_batch keep cached (default 256). 0 disables the cache; shrinking evicts
+ * the least recently used entries.
+ */
+EXPOSE_WASM void mldsa_set_verify_key_cache_capacity(size_t capacity);
+
+/**
+ * @brief Reports verify key cache counters since startup.
+ * @param hits Lookups served from the cache.
+ * @param misses Lookups that had to parse the certificate.
+ * @param entries Certificates currently cached.
+ */
+EXPOSE_WASM void mldsa_get_verify_key_cache_stats(uint64_t *hits, uint64_t *misses, size_t *entries);
+// --- Scratch Arenas ---
+
+/**
+ * @brief Allocates one set of reusable scratch regions.
+ * Pass region pointers straight to the other exports instead of allocating per call.
+ * @param message_capacity Initial size of the message region.
+ * @return Arena on success, nullptr on failure. Release with mldsa_arena_free.
+ */
+EXPOSE_WASM mldsa_arena* mldsa_arena_new(size_t message_capacity);
+
+/**
+ * @brief Frees an arena; the private key region is cleansed first.
+ */
+EXPOSE_WASM void mldsa_arena_free(mldsa_arena *arena);
+
+/**
+ * @brief Returns the start of a region, or nullptr for an invalid region.
+ */
+EXPOSE_WASM unsigned char* mldsa_arena_region_ptr(mldsa_arena *arena, int region);
+EXPOSE_WASM size_t mldsa_arena_region_size(mldsa_arena *arena, int region);
+
+/**
+ * @brief Makes sure a growable region holds at least size bytes.
+ * Previous region pointers are invalid after a successful grow.
+ * @return The (possibly moved) region pointer, nullptr on failure or for fixed-size regions that are too small.
+ */
+EXPOSE_WASM unsigned char* mldsa_arena_reserve(mldsa_arena *arena, int region, size_t size);
+
+/**
+ * @brief Cleanses the private key region after use.
+ */
+EXPOSE_WASM void mldsa_arena_wipe_private_key(mldsa_arena *arena);
+// --- OpenSSL Allocation Arena ---
+
+/**
+ * @brief Installs the OpenSSL allocator hooks used by the issuance arena and allocation counters.
+ * Must run before any other call into OpenSSL, since OpenSSL rejects hooks after its first allocation.
+ * @return true if the hooks are active, false if OpenSSL had already allocated.
+ */
+EXPOSE_WASM bool mldsa_install_allocator_hooks(void);
+
+/**
+ * @brief Turns the per-request arena for sign_certificate / generate_self_signed_certificate on or off.
+ */
+EXPOSE_WASM void mldsa_set_issuance_arena_enabled(bool enabled);
+
+/**
+ * @brief Reports OpenSSL allocations made by the calling thread since it started (hooks must be installed).
+ * @param heap_allocs General heap allocations.
+ * @param arena_allocs Allocations served from an issuance arena.
+ */
+EXPOSE_WASM void mldsa_get_thread_allocation_counts(uint64_t *heap_allocs, uint64_t *arena_allocs);
+// --- Codecs (codec.cpp) ---
+
+/**
+ * @brief Names the vector kernels in use: "avx2", "ssse3", "simd128" or "scalar".
+ */
+EXPOSE_WASM const char* mldsa_codec_backend(void);
+
+/**
+ * @brief Base64-encodes src (standard alphabet, padded, no line breaks) and NUL-terminates.
+ * @param dst_size Must exceed 4 * ceil(src_len / 3).
+ * @return characters written (excluding the terminator), -1 on failure.
+ */
+EXPOSE_WASM long mldsa_base64_encode(const unsigned char *src, size_t src_len, char *dst, size_t dst_size);
+
+/**
+ * @brief Decodes base64, skipping ASCII whitespace; padding is optional.
+ * @return bytes written, -1 on invalid input or if dst is too small (3 * ceil(src_len / 4) always fits).
+ */
+EXPOSE_WASM long mldsa_base64_decode(const char *src, size_t src_len, unsigned char *dst, size_t dst_size);
+
+/**
+ * @brief Lower-case hex encoding, NUL-terminated.
+ * @param dst_size Must exceed 2 * src_len.
+ * @return characters written (excluding the terminator), -1 on failure.
+ */
+EXPOSE_WASM long mldsa_hex_encode(const unsigned char *src, size_t src_len, char *dst, size_t dst_size);
+
+/**
+ * @brief Decodes hex (either case).
+ * @return bytes written (src_len / 2), -1 on odd length, non-hex input or a short dst.
+ */
+EXPOSE_WASM long mldsa_hex_decode(const char *src, size_t src_len, unsigned char *dst, size_t dst_size);
+
+/**
+ * @brief Wraps DER in "-----BEGIN label-----" armor with 64-column lines, NUL-terminated.
+ * @return characters written (excluding the terminator), -1 if dst is too small.
+ */
+EXPOSE_WASM long mldsa_pem_armor(const char *label, const unsigned char *der, size_t der_len, char *dst, size_t dst_size);
+
+/**
+ * @brief Extracts the DER body of the first PEM block, ignoring any text around it.
+ * @param label Required label (e.g. "CERTIFICATE"), or nullptr to accept any.
+ * @return bytes written, -1 if no block is found, it is malformed or encrypted, or dst is too small.
+ */
+EXPOSE_WASM long mldsa_pem_dearmor(const char *pem, size_t pem_len, const char *label, unsigned char *dst, size_t dst_size);
+// --- Error Rings (errors.cpp) ---
+
+/**
+ * @brief Moves queued errors from every thread's ring into out as JSON:
+ * {"dropped":N,"totals":{...},"errors":[{"code","context","detail","reason","thread","time_ms"}]}.
+ * Records that do not fit stay queued for the next call.
+ * @return characters written (excluding the terminator), -1 if out cannot hold even an empty report.
+ */
+EXPOSE_WASM long mldsa_drain_errors(char *out, size_t out_size);
+
+/**
+ * @brief Sets how often (at most) a one-line error summary goes to stderr; 0 disables it. Default 60 s.
+ */
+EXPOSE_WASM void mldsa_set_error_summary_interval(unsigned seconds);
+
+// --- Stats (stats.cpp) ---
+
+/**
+ * @brief Serializes the call counters and latency histograms.
+ * @param format 0 for JSON, 1 for Prometheus text exposition format.
+ * @param out Output buffer, NUL-terminated on success.
+ * @param out_size Size of out.
+ * @return characters written (excluding the terminator), -1 if out is too small or format is unknown.
+ */
+EXPOSE_WASM long mldsa_stats_export(int format, char *out, size_t out_size);
+
+/**
+ * @brief Zeroes every counter and histogram.
+ */
+EXPOSE_WASM void mldsa_stats_reset(void);
+
+/**
+ * @brief Turns timing on or off (on by default). While off, instrumented calls skip the clock reads.
+ */
+EXPOSE_WASM void mldsa_set_stats_enabled(bool enabled);
+
+// --- Keypair Pool (keypair_pool.cpp) ---
+
+/**
+ * @brief Allocates a pool of high_water ML-DSA-65 keypairs and starts the refill threads.
+ * @param high_water Number of keypairs kept ready.
+ * @param thread_count Background refill threads. Ignored in WASM builds without pthreads,
+ *                     which must call mldsa_keypair_pool_refill instead.
+ * @return true on success, false if the pool is already running or allocation failed.
+ */
+EXPOSE_WASM bool mldsa_keypair_pool_start(size_t high_water, int thread_count);
+
+/**
+ * @brief Takes one keypair, falling back to inline generation when the pool is empty.
+ * @param private_key Output buffer (ml_dsa_65_private_key_size bytes).
+ * @param public_key Output buffer (ml_dsa_65_public_key_size bytes).
+ * @return 1 if served from the pool, 2 if generated inline, 0 on failure.
+ */
+EXPOSE_WASM int mldsa_keypair_pool_take(char *private_key, char *public_key);
+
+/**
+ * @brief Generates up to max_keys keypairs on the calling thread, stopping at the high-water mark.
+ * @return the number of keypairs added.
+ */
+EXPOSE_WASM size_t mldsa_keypair_pool_refill(size_t max_keys);
+
+/**
+ * @brief Number of keypairs currently ready.
+ */
+EXPOSE_WASM size_t mldsa_keypair_pool_size(void);
+
+/**
+ * @brief Joins the refill threads, waits for in-flight mldsa_keypair_pool_refill calls and
+ * cleanses every unused keypair. Also runs at process exit, ahead of OpenSSL's own cleanup.
+ */
+EXPOSE_WASM void mldsa_keypair_pool_stop(void);
+
+// --- Serial Numbers (serial.cpp) ---
+
+/**
+ * @brief Configures the certificate serial allocator. Call once at startup, before issuing.
+ * Without it, serials still never repeat within the process but the counter restarts at 0.
+ * @param node_id Identifies this issuing node (0..32767); must differ between nodes sharing a CA.
+ * @param state_path File holding the persisted counter high-water mark, or NULL to not persist.
+ *                   Created on first use; the counter resumes above the stored mark.
+ * @return true on success, false on an invalid node id or if the state file cannot be read or written.
+ */
+EXPOSE_WASM bool mldsa_serial_init(uint32_t node_id, const char *state_path);
+
+/**
+ * @brief Allocates the next serial: 15-bit node id, 48-bit counter, 64 random bits (16 bytes, big-endian).
+ * @return 16 on success, 0 if out is too small or the high-water mark could not be persisted.
+ */
+EXPOSE_WASM int mldsa_serial_next(unsigned char *out, size_t out_size);
+
+/**
+ * @brief Reads a certificate's serial number (PEM or DER), for indexing and revocation.
+ * @param out Receives the serial as minimal big-endian bytes (leading zeros dropped).
+ * @return serial length on success, -1 on a parse error or if out is too small.
+ */
+EXPOSE_WASM int mldsa_certificate_serial(const char *cert_buf, size_t cert_len, unsigned char *out, size_t out_size);
+
+// --- Revocation (revocation.cpp) ---
+
+/**
+ * @brief Verifies a CRL against its CA and loads its revoked serials into the revocation index.
+ * The new index replaces this issuer's previous entries (other issuers' entries are kept) and is
+ * swapped in without blocking concurrent verifications. From then on verify_certificate_issued_by_ca,
+ * verify_signature_with_cert and verify_signature_batch reject the revoked certificates.
+ * @param crl_buf The CRL (PEM or DER).
+ * @param ca_cert_buf The issuing CA certificate (PEM or DER); the CRL must be signed by it.
+ * @return number of serials loaded, -1 if the CRL cannot be parsed, is not signed by the CA,
+ *         or is older than the CRL already loaded for that CA.
+ */
+EXPOSE_WASM int mldsa_revocation_load_crl(const char *crl_buf, size_t crl_len, const char *ca_cert_buf, size_t ca_cert_len);
+
+/**
+ * @brief Checks a certificate (PEM or DER) against the revocation index.
+ * @return 1 if revoked, 0 if not, -1 on a parse error.
+ */
+EXPOSE_WASM int mldsa_revocation_check(const char *cert_buf, size_t cert_len);
+
+/**
+ * @brief Drops every loaded CRL.
+ */
+EXPOSE_WASM void mldsa_revocation_clear(void);
+
+/**
+ * @brief Issues a CRL revoking the given serials, signed by the CA.
+ * @param serials Per-entry serials as big-endian bytes (see mldsa_certificate_serial).
+ * @param serial_lens Length of each serial.
+ * @param serial_count Number of revoked serials.
+ * @param next_update_days Days until the CRL's nextUpdate.
+ * @param der_output true for DER, false for NUL-terminated PEM.
+ * @return CRL length (excluding the PEM terminator) on success, 0 on failure.
+ */
+EXPOSE_WASM int sign_crl(
+    const char *ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char *ca_privkey_buf,
+    size_t ca_privkey_len,
+    const unsigned char **serials,
+    const size_t *serial_lens,
+    size_t serial_count,
+    int next_update_days,
+    bool der_output,
+    char *out_buf,
+    size_t out_buf_size
+);
+
+// --- Status Tokens (status_token.cpp) ---
+
+/**
+ * @brief Verifies a signature for a QR status check, answering repeat checks from a TTL cache.
+ * A cache hit requires the same UUID, the same certificate, signature and message bytes and the
+ * same CA certificate (or none), and a valid entry is re-checked against the revocation index.
+ * A valid result is cached, and so is an invalid one once verification reached the signature or
+ * chain check. Any other failure (allocation, parsing) returns 0 with an already expired token
+ * and is not cached, so the next check verifies again.
+ * @param uuid Signature UUID the result is cached under (at most 256 bytes).
+ * @param cert_buf Signer certificate (PEM or DER).
+ * @param ca_cert_buf Optional CA certificate; when non-NULL the signer certificate must chain to it.
+ * @param signature_buf The ML-DSA-65 signature.
+ * @param message_buf The signed message.
+ * @param ttl_seconds How long the result and its token stay valid; 0 returns a token without caching.
+ * @param token_out Receives the MAC-signed status token (mldsa_status_token_size bytes).
+ * @return 1 if valid, 0 if invalid, -1 on invalid arguments.
+ */
+EXPOSE_WASM int mldsa_verify_status_cached(
+    const char *uuid,
+    size_t uuid_len,
+    const char *cert_buf,
+    size_t cert_len,
+    const char *ca_cert_buf,
+    size_t ca_cert_len,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const char *message_buf,
+    size_t message_len,
+    unsigned ttl_seconds,
+    unsigned char *token_out,
+    size_t token_out_size
+);
+
+/**
+ * @brief Checks a status token issued by mldsa_verify_status_cached against the content presented
+ * with it: one HMAC and one SHA-256, no verification. The certificate, CA certificate (or none),
+ * signature and message must be the bytes the token was issued for.
+ * Revocation is not consulted, so a token outlives a CRL that revokes its signer until it expires.
+ * @return the status it attests (1 valid, 0 invalid), -1 if it is malformed, forged, for another UUID
+ * or other content, or expired.
+ */
+EXPOSE_WASM int mldsa_status_token_check(
+    const char *uuid,
+    size_t uuid_len,
+    const char *cert_buf,
+    size_t cert_len,
+    const char *ca_cert_buf,
+    size_t ca_cert_len,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const char *message_buf,
+    size_t message_len,
+    const unsigned char *token,
+    size_t token_len
+);
+
+/**
+ * @brief Installs the status token MAC key (16..32 bytes) shared by every node answering the same
+ * QR codes. Without it each process uses a random key. Clears the status cache.
+ * @return false if the key length is out of range.
+ */
+EXPOSE_WASM bool mldsa_status_set_key(const unsigned char *key, size_t key_len);
+
+/**
+ * @brief Drops every cached status.
+ */
+EXPOSE_WASM void mldsa_status_cache_clear(void);
+
+/**
+ * @brief Sets how many UUIDs the status cache keeps (default 4096); shrinking evicts the least recently used.
+ */
+EXPOSE_WASM void mldsa_set_status_cache_capacity(size_t capacity);
+
+/**
+ * @brief Reads the status cache counters. Any pointer may be NULL.
+ */
+EXPOSE_WASM void mldsa_get_status_cache_stats(uint64_t *hits, uint64_t *misses, size_t *entries);
+
+// --- QR Payloads (qr_payload.cpp) ---
+
+/**
+ * @brief Packs message fields as a varint count followed by (varint length, bytes) per field.
+ * The result is what gets signed and carried as the payload message.
+ * @return Encoded length, -1 on invalid arguments or if out is too small.
+ */
+EXPOSE_WASM long mldsa_qr_message_encode(const char **fields, const size_t *field_lens, size_t field_count,
+                                         unsigned char *out, size_t out_size);
+
+/**
+ * @brief Locates the fields of an encoded message without copying them.
+ * @param offsets Receives each field's offset into message.
+ * @param lens Receives each field's length.
+ * @return Field count, -1 if the message is malformed or has more than max_fields fields.
+ */
+EXPOSE_WASM long mldsa_qr_message_fields(const char *message, size_t message_len, size_t *offsets, size_t *lens, size_t max_fields);
+
+/**
+ * @brief Builds a binary QR payload: version, signer certificate fingerprint, message and raw signature.
+ * @param cert_buf Signer certificate (PEM or DER); only its SHA-256 fingerprint is stored.
+ * @return Payload length, -1 on invalid arguments or if out is too small.
+ */
+EXPOSE_WASM long mldsa_qr_payload_encode(const char *cert_buf, size_t cert_len, const char *message_buf, size_t message_len,
+                                         const unsigned char *signature_buf, size_t signature_len,
+                                         unsigned char *out, size_t out_size);
+
+/**
+ * @brief Parses a QR payload.
+ * @param spans_out Receives message offset, message length, signature offset, signature length.
+ * @param fingerprint_out Optional; receives the certificate fingerprint (mldsa_qr_fingerprint_size bytes).
+ * @return Payload version, -1 if malformed.
+ */
+EXPOSE_WASM int mldsa_qr_payload_parse(const unsigned char *payload, size_t payload_len, size_t *spans_out, unsigned char *fingerprint_out);
+
+/**
+ * @brief Verifies a QR payload against the signer certificate, reading message and signature in place.
+ * @return 1 if valid, 0 if the fingerprint or signature does not match, -1 if the payload is malformed.
+ */
+EXPOSE_WASM int mldsa_qr_payload_verify(const unsigned char *payload, size_t payload_len, const char *cert_buf, size_t cert_len);
+
+/**
+ * @brief Splits a payload into at most 16 structured-append frames of at most max_frame_size bytes
+ * (4-byte frame header included). Frames are written back to back into out.
+ * @param frame_lens Receives each frame's length.
+ * @return Frame count, -1 if the payload needs more than 16 (or max_frame_count) frames or out is too small.
+ */
+EXPOSE_WASM long mldsa_qr_payload_split(const unsigned char *payload, size_t payload_len, size_t max_frame_size,
+                                        unsigned char *out, size_t out_size, size_t *frame_lens, size_t max_frame_count);
+
+/**
+ * @brief Reassembles a payload from every frame of one sequence, in any order.
+ * @return Payload length, -1 if frames are missing, duplicated, from different sequences or fail the parity check.
+ */
+EXPOSE_WASM long mldsa_qr_payload_join(const unsigned char **frames, const size_t *frame_lens, size_t frame_count,
+                                       unsigned char *out, size_t out_size);
+
+// --- Merkle Batch Signing (merkle_batch.cpp) ---
+
+/**
+ * @brief Signs many documents with one ML-DSA-65 signature over the root of a SHA-256 Merkle tree
+ * of their digests, and writes an inclusion proof per document.
+ * @param private_key The raw private key buffer (ml_dsa_65_private_key_size bytes).
+ * @param signature_buf Receives the batch signature (at least ml_dsa_65_signature_size bytes).
+ * @param proofs_out Receives the proofs back to back, in document order. Each proof is at most
+ *        12 + 32 * ceil(log2(doc_count)) bytes.
+ * @param proof_lens Receives each proof's length.
+ * @return Signature length on success, -1 on failure.
+ */
+EXPOSE_WASM long mldsa_merkle_sign_batch(
+    const char *private_key,
+    const char **doc_bufs,
+    const size_t *doc_lens,
+    size_t doc_count,
+    unsigned char *signature_buf,
+    size_t signature_buf_size,
+    unsigned char *proofs_out,
+    size_t proofs_out_size,
+    size_t *proof_lens
+);
+
+/**
+ * @brief Checks that a document is in a signed batch: recomputes the root from its proof and
+ * verifies the batch signature with a raw public key.
+ * @return 1 if valid, 0 if the signature does not match, -1 if the proof is malformed.
+ */
+EXPOSE_WASM int mldsa_merkle_verify(
+    const char *public_key,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const unsigned char *proof,
+    size_t proof_len,
+    const char *doc_buf,
+    size_t doc_len
+);
+
+/**
+ * @brief Same as mldsa_merkle_verify, with the signer certificate (PEM or DER); revoked certificates fail.
+ */
+EXPOSE_WASM int mldsa_merkle_verify_with_cert(
+    const char *cert_buf,
+    size_t cert_len,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const unsigned char *proof,
+    size_t proof_len,
+    const char *doc_buf,
+    size_t doc_len
+);
+
+// --- Signature Store (signature_store.cpp) ---
+
+/**
+ * @brief Opens (or creates) the append-only signature store in dir, replaying its segments into
+ * the in-memory index. Closes a store that is already open.
+ * @param segment_size Size of each mapped segment file; 0 for the default (64 MiB), at least 64 KiB.
+ * @return false if the directory or a segment cannot be opened.
+ */
+EXPOSE_WASM bool mldsa_sig_store_open(const char *dir, size_t segment_size);
+
+/**
+ * @brief Syncs and closes the store.
+ */
+EXPOSE_WASM void mldsa_sig_store_close(void);
+
+/**
+ * @brief Appends a signature record under key, replacing any earlier record for the key.
+ * @param durable When true, returns only after the record is on disk; concurrent durable puts share one sync.
+ * @return true on success.
+ */
+EXPOSE_WASM bool mldsa_sig_store_put(const char *key, size_t key_len, const char *message, size_t message_len,
+                                     const unsigned char *signature, size_t signature_len, bool durable);
+
+/**
+ * @brief Copies the record for key out of the mapped segment.
+ * @param message_len Optional; receives the stored message length (also when the buffers are too small).
+ * @param signature_len Optional; receives the stored signature length.
+ * @return 1 if found, 0 if not, -1 if an output buffer is too small.
+ */
+EXPOSE_WASM int mldsa_sig_store_get(const char *key, size_t key_len, char *message_out, size_t message_out_size, size_t *message_len,
+                                    unsigned char *signature_out, size_t signature_out_size, size_t *signature_len);
+
+/**
+ * @brief Verifies the stored signature over the stored message in place, without copying the record.
+ * @return 1 if valid, 0 if invalid, -1 if the key is not in the store.
+ */
+EXPOSE_WASM int mldsa_sig_store_verify_with_cert(const char *key, size_t key_len, const char *cert_buf, size_t cert_len);
+
+/**
+ * @brief Deletes the record for key (appends a tombstone).
+ * @return true if the key was present.
+ */
+EXPOSE_WASM bool mldsa_sig_store_delete(const char *key, size_t key_len);
+
+/**
+ * @brief Syncs every record appended so far.
+ */
+EXPOSE_WASM bool mldsa_sig_store_sync(void);
+
+/**
+ * @brief Rewrites the live records of sealed segments whose live fraction is at most max_live_ratio
+ * into the active segment and removes those segment files.
+ * @return Number of segments reclaimed, -1 on failure.
+ */
+EXPOSE_WASM long mldsa_sig_store_compact(double max_live_ratio);
+
+/**
+ * @brief Reads store counters. Any pointer may be NULL.
+ */
+EXPOSE_WASM void mldsa_sig_store_stats(uint64_t *records, uint64_t *segments, uint64_t *bytes, uint64_t *dead_bytes);
 } // Extern "C"
 #endif //CRYPTO_LIB_H
 //
\ No newline at end of file
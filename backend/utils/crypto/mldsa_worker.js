@@ -0,0 +1,29 @@
+/**
+ * @file mldsa_worker.js
+ * @description worker_threads entry point for MLDSAWorkerPool. Each worker owns one
+ * ML-DSA module instance and runs the pooled calls it is handed, one at a time.
+ */
+import { parentPort, workerData } from 'worker_threads';
+import { MLDSAWrapper } from './MLDSAWrapper.js';
+
+const POOLED_METHODS = new Set(['sign', 'verify', 'verifyWithCertificate', 'signCertificate']);
+
+const wrapper = new MLDSAWrapper(workerData.wasmPath, { backend: workerData.backend });
+await wrapper.initialize();
+
+parentPort.on('message', async ({ id, method, args }) => {
+  if (!POOLED_METHODS.has(method)) {
+    parentPort.postMessage({ id, error: `Unsupported pooled method: ${method}` });
+    return;
+  }
+  try {
+    const result = await wrapper[method](...args);
+    // Hand signatures and certificates back without copying them again.
+    const transfer = result instanceof Uint8Array ? [result.buffer] : [];
+    parentPort.postMessage({ id, result }, transfer);
+  } catch (error) {
+    parentPort.postMessage({ id, error: error.message });
+  }
+});
+
+parentPort.postMessage({ ready: true });
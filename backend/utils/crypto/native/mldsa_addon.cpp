@@ -0,0 +1,1282 @@
+// native/mldsa_addon.cpp
+// N-API bindings for the ML-DSA library. Built from the same sources as
+// mldsa_lib.wasm (see binding.gyp) so MLDSAWrapper can pick either backend.
+// Every function takes Buffers/Uint8Arrays (or strings) instead of heap
+// pointers and returns Buffers, but otherwise mirrors the C export of the
+// same name.
+#include "../mldsa_lib.h"
+#include <node_api.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t output_buf_size = 64 * 1024;
+
+struct byte_view {
+    const char *data = nullptr;
+    size_t len = 0;
+    std::string owned;
+};
+
+napi_value throw_error(napi_env env, const char *message) {
+    napi_throw_error(env, nullptr, message);
+    return nullptr;
+}
+
+bool get_args(napi_env env, napi_callback_info info, size_t expected, napi_value *argv) {
+    size_t argc = expected;
+    if (napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr) != napi_ok || argc < expected) {
+        napi_throw_type_error(env, nullptr, "Wrong number of arguments");
+        return false;
+    }
+    return true;
+}
+
+// Accepts a string (UTF-8) or any TypedArray/Buffer.
+bool get_bytes(napi_env env, napi_value value, byte_view& out) {
+    napi_valuetype type;
+    napi_typeof(env, value, &type);
+    if (type == napi_string) {
+        size_t len = 0;
+        napi_get_value_string_utf8(env, value, nullptr, 0, &len);
+        out.owned.resize(len + 1);
+        napi_get_value_string_utf8(env, value, out.owned.data(), len + 1, &len);
+        out.owned.resize(len);
+        out.data = out.owned.data();
+        out.len = len;
+        return true;
+    }
+    bool is_typed_array = false;
+    napi_is_typedarray(env, value, &is_typed_array);
+    if (is_typed_array) {
+        napi_typedarray_type array_type;
+        size_t length;
+        void *data;
+        napi_value array_buffer;
+        size_t byte_offset;
+        napi_get_typedarray_info(env, value, &array_type, &length, &data, &array_buffer, &byte_offset);
+        if (array_type != napi_uint8_array && array_type != napi_int8_array && array_type != napi_uint8_clamped_array) {
+            napi_throw_type_error(env, nullptr, "Expected a byte array");
+            return false;
+        }
+        out.data = static_cast<const char*>(data);
+        out.len = length;
+        return true;
+    }
+    napi_throw_type_error(env, nullptr, "Expected a string, Buffer or Uint8Array");
+    return false;
+}
+
+bool get_key(napi_env env, napi_value value, size_t expected_size, byte_view& out) {
+    if (!get_bytes(env, value, out)) {
+        return false;
+    }
+    if (out.len != expected_size) {
+        napi_throw_range_error(env, nullptr, "Invalid ML-DSA-65 key size");
+        return false;
+    }
+    return true;
+}
+
+int32_t get_int(napi_env env, napi_value value, int32_t fallback) {
+    int32_t result;
+    if (napi_get_value_int32(env, value, &result) != napi_ok) {
+        return fallback;
+    }
+    return result;
+}
+
+napi_value make_buffer(napi_env env, const void *data, size_t len) {
+    napi_value result;
+    napi_create_buffer_copy(env, len, data, nullptr, &result);
+    return result;
+}
+
+napi_value make_bool(napi_env env, bool value) {
+    napi_value result;
+    napi_get_boolean(env, value, &result);
+    return result;
+}
+
+// Reads an array of byte inputs; ptrs/lens point into views, which keep copies alive.
+bool get_byte_array(napi_env env, napi_value value, const char *name, std::vector<byte_view>& views,
+                    std::vector<const char*>& ptrs, std::vector<size_t>& lens) {
+    uint32_t count = 0;
+    if (napi_get_array_length(env, value, &count) != napi_ok) {
+        std::string message = std::string(name) + " must be an array";
+        napi_throw_type_error(env, nullptr, message.c_str());
+        return false;
+    }
+    views.resize(count);
+    ptrs.resize(count);
+    lens.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value entry;
+        napi_get_element(env, value, i, &entry);
+        if (!get_bytes(env, entry, views[i])) return false;
+        ptrs[i] = views[i].data;
+        lens[i] = views[i].len;
+    }
+    return true;
+}
+
+// Key handles, signing contexts and signing streams reach JS as tagged externals.
+// The free_* calls release them explicitly; the finalizer only reclaims ones JS dropped.
+struct native_handle {
+    void *ptr;
+    void (*release)(void *);
+};
+
+constexpr napi_type_tag key_handle_tag = {0x6d6c647361686e64ULL, 0x4b4559484e444c31ULL};
+constexpr napi_type_tag sign_ctx_tag = {0x6d6c647361686e64ULL, 0x5349474e43545831ULL};
+constexpr napi_type_tag sign_stream_tag = {0x6d6c647361686e64ULL, 0x53545245414d5f31ULL};
+
+void release_handle(native_handle *handle) {
+    if (handle->ptr) {
+        handle->release(handle->ptr);
+        handle->ptr = nullptr;
+    }
+}
+
+void finalize_handle(napi_env, void *data, void *) {
+    auto *handle = static_cast<native_handle*>(data);
+    release_handle(handle);
+    delete handle;
+}
+
+napi_value make_handle(napi_env env, const napi_type_tag& tag, void *ptr, void (*release)(void *)) {
+    napi_value result;
+    auto *handle = new native_handle{ptr, release};
+    if (napi_create_external(env, handle, finalize_handle, nullptr, &result) != napi_ok) {
+        release_handle(handle);
+        delete handle;
+        return throw_error(env, "Failed to wrap native handle");
+    }
+    napi_type_tag_object(env, result, &tag);
+    return result;
+}
+
+// Returns the wrapper behind an external carrying the given tag, or nullptr after throwing.
+native_handle* get_handle(napi_env env, napi_value value, const napi_type_tag& tag) {
+    bool tagged = false;
+    void *data = nullptr;
+    if (napi_check_object_type_tag(env, value, &tag, &tagged) != napi_ok || !tagged ||
+        napi_get_value_external(env, value, &data) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "Expected a handle of the right kind");
+        return nullptr;
+    }
+    return static_cast<native_handle*>(data);
+}
+
+template <typename T>
+T* get_live_handle(napi_env env, napi_value value, const napi_type_tag& tag) {
+    native_handle *handle = get_handle(env, value, tag);
+    if (handle && !handle->ptr) {
+        napi_throw_error(env, nullptr, "Handle has already been freed");
+        return nullptr;
+    }
+    return handle ? static_cast<T*>(handle->ptr) : nullptr;
+}
+
+napi_value free_handle(napi_env env, napi_callback_info info, const napi_type_tag& tag) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    native_handle *handle = get_handle(env, argv[0], tag);
+    if (handle) release_handle(handle);
+    return nullptr;
+}
+
+// generate_mldsa65_keypair() -> { privateKey, publicKey }
+napi_value generate_keypair(napi_env env, napi_callback_info) {
+    std::vector<char> private_key(ml_dsa_65_private_key_size);
+    std::vector<char> public_key(ml_dsa_65_public_key_size);
+    if (!generate_mldsa65_keypair(private_key.data(), public_key.data())) {
+        return throw_error(env, "Key generation failed");
+    }
+    napi_value result;
+    napi_create_object(env, &result);
+    napi_set_named_property(env, result, "privateKey", make_buffer(env, private_key.data(), private_key.size()));
+    napi_set_named_property(env, result, "publicKey", make_buffer(env, public_key.data(), public_key.size()));
+    return result;
+}
+
+// generate_csr(privateKey, publicKey, subjectInfo[]) -> Buffer (PEM)
+napi_value generate_csr_native(napi_env env, napi_callback_info info) {
+    napi_value argv[3];
+    if (!get_args(env, info, 3, argv)) return nullptr;
+    byte_view private_key, public_key;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, private_key) ||
+        !get_key(env, argv[1], ml_dsa_65_public_key_size, public_key)) {
+        return nullptr;
+    }
+
+    uint32_t subject_count = 0;
+    if (napi_get_array_length(env, argv[2], &subject_count) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "subjectInfo must be an array of strings");
+        return nullptr;
+    }
+    std::vector<byte_view> subject(subject_count);
+    std::vector<char*> subject_ptrs(subject_count);
+    for (uint32_t i = 0; i < subject_count; ++i) {
+        napi_value entry;
+        napi_get_element(env, argv[2], i, &entry);
+        if (!get_bytes(env, entry, subject[i])) return nullptr;
+        // generate_csr expects NUL-terminated strings.
+        if (subject[i].owned.empty()) subject[i].owned.assign(subject[i].data, subject[i].len);
+        subject_ptrs[i] = subject[i].owned.data();
+    }
+
+    std::vector<char> private_copy(private_key.data, private_key.data + private_key.len);
+    std::vector<char> public_copy(public_key.data, public_key.data + public_key.len);
+    std::vector<char> out(output_buf_size);
+    int len = generate_csr(private_copy.data(), public_copy.data(), subject_ptrs.data(),
+                           static_cast<int>(subject_count), out.data(), out.size());
+    if (len <= 0) {
+        return throw_error(env, "CSR generation failed");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+// generate_self_signed_certificate(privateKey, csr, days) -> Buffer (PEM)
+napi_value generate_self_signed_certificate_native(napi_env env, napi_callback_info info) {
+    napi_value argv[3];
+    if (!get_args(env, info, 3, argv)) return nullptr;
+    byte_view private_key, csr;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, private_key) || !get_bytes(env, argv[1], csr)) {
+        return nullptr;
+    }
+    std::vector<char> private_copy(private_key.data, private_key.data + private_key.len);
+    std::vector<char> out(output_buf_size);
+    int len = generate_self_signed_certificate(csr.data, csr.len, private_copy.data(), out.data(), out.size(),
+                                               get_int(env, argv[2], 365));
+    if (len <= 0) {
+        return throw_error(env, "Self-signed certificate generation failed");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+napi_value sign_certificate_common(napi_env env, napi_callback_info info, bool der_output) {
+    napi_value argv[4];
+    if (!get_args(env, info, 4, argv)) return nullptr;
+    byte_view ca_private_key, csr, ca_cert;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, ca_private_key) ||
+        !get_bytes(env, argv[1], csr) || !get_bytes(env, argv[2], ca_cert)) {
+        return nullptr;
+    }
+    std::vector<char> out(output_buf_size);
+    auto sign = der_output ? sign_certificate_der : sign_certificate;
+    int len = sign(csr.data, csr.len, ca_cert.data, ca_cert.len, ca_private_key.data, ca_private_key.len,
+                   out.data(), out.size(), get_int(env, argv[3], 365));
+    if (len <= 0) {
+        return throw_error(env, "Certificate signing failed");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+// sign_certificate(caPrivateKey, csr, caCert, days) -> Buffer (PEM)
+napi_value sign_certificate_native(napi_env env, napi_callback_info info) {
+    return sign_certificate_common(env, info, false);
+}
+
+// sign_certificate_der(caPrivateKey, csr, caCert, days) -> Buffer (DER)
+napi_value sign_certificate_der_native(napi_env env, napi_callback_info info) {
+    return sign_certificate_common(env, info, true);
+}
+
+// sign_certificates_batch(caPrivateKey, csrs[], caCert, days, der, threads) -> [{ status, certificate }]
+// certificate is null unless status is MLDSA_ISSUE_OK.
+napi_value sign_certificates_batch_native(napi_env env, napi_callback_info info) {
+    napi_value argv[6];
+    if (!get_args(env, info, 6, argv)) return nullptr;
+    byte_view ca_private_key, ca_cert;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, ca_private_key) || !get_bytes(env, argv[2], ca_cert)) {
+        return nullptr;
+    }
+    uint32_t csr_count = 0;
+    if (napi_get_array_length(env, argv[1], &csr_count) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "csrs must be an array");
+        return nullptr;
+    }
+    std::vector<byte_view> csrs(csr_count);
+    std::vector<const char*> csr_ptrs(csr_count);
+    std::vector<size_t> csr_lens(csr_count);
+    for (uint32_t i = 0; i < csr_count; ++i) {
+        napi_value entry;
+        napi_get_element(env, argv[1], i, &entry);
+        if (!get_bytes(env, entry, csrs[i])) return nullptr;
+        csr_ptrs[i] = csrs[i].data;
+        csr_lens[i] = csrs[i].len;
+    }
+    bool der_output = false;
+    napi_get_value_bool(env, argv[4], &der_output);
+
+    std::vector<char> out(std::max<size_t>(1, csr_count) * mldsa_arena_pem_capacity);
+    std::vector<size_t> lens(csr_count);
+    std::vector<int> status(csr_count);
+    long issued = sign_certificates_batch(csr_ptrs.data(), csr_lens.data(), csr_count, ca_cert.data, ca_cert.len,
+                                          ca_private_key.data, ca_private_key.len, get_int(env, argv[3], 365),
+                                          der_output, out.data(), out.size(), lens.data(), status.data(),
+                                          get_int(env, argv[5], 0));
+    if (issued < 0) {
+        return throw_error(env, "Batch certificate signing failed");
+    }
+
+    napi_value result;
+    napi_create_array_with_length(env, csr_count, &result);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < csr_count; ++i) {
+        napi_value item, item_status, certificate;
+        napi_create_object(env, &item);
+        napi_create_int32(env, status[i], &item_status);
+        if (status[i] == MLDSA_ISSUE_OK) {
+            certificate = make_buffer(env, out.data() + offset, lens[i]);
+            offset += lens[i];
+        } else {
+            napi_get_null(env, &certificate);
+        }
+        napi_set_named_property(env, item, "status", item_status);
+        napi_set_named_property(env, item, "certificate", certificate);
+        napi_set_element(env, result, i, item);
+    }
+    return result;
+}
+
+// sign_mldsa65(privateKey, message) -> Buffer
+napi_value sign_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view private_key, message;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, private_key) || !get_bytes(env, argv[1], message)) {
+        return nullptr;
+    }
+    unsigned char signature[ml_dsa_65_signature_size];
+    int len = sign_mldsa65(private_key.data, message.data, message.len, signature, sizeof(signature));
+    if (len <= 0) {
+        return throw_error(env, "Signing failed");
+    }
+    return make_buffer(env, signature, len);
+}
+
+// verify_mldsa65(publicKey, signature, message) -> boolean
+// Takes the signature bytes directly instead of a virtual FS path.
+napi_value verify_native(napi_env env, napi_callback_info info) {
+    napi_value argv[3];
+    if (!get_args(env, info, 3, argv)) return nullptr;
+    byte_view public_key, signature, message;
+    if (!get_key(env, argv[0], ml_dsa_65_public_key_size, public_key) ||
+        !get_bytes(env, argv[1], signature) || !get_bytes(env, argv[2], message)) {
+        return nullptr;
+    }
+    mldsa_key_handle *handle = load_mldsa65_public_key(public_key.data);
+    if (!handle) {
+        return make_bool(env, false);
+    }
+    bool valid = verify_mldsa65_with_handle(handle, reinterpret_cast<const unsigned char*>(signature.data),
+                                            signature.len, message.data, static_cast<int>(message.len));
+    free_mldsa65_key_handle(handle);
+    return make_bool(env, valid);
+}
+
+// verify_signature_with_cert(cert, signature, message) -> boolean
+napi_value verify_signature_with_cert_native(napi_env env, napi_callback_info info) {
+    napi_value argv[3];
+    if (!get_args(env, info, 3, argv)) return nullptr;
+    byte_view cert, signature, message;
+    if (!get_bytes(env, argv[0], cert) || !get_bytes(env, argv[1], signature) || !get_bytes(env, argv[2], message)) {
+        return nullptr;
+    }
+    return make_bool(env, verify_signature_with_cert(cert.data, cert.len,
+                                                     reinterpret_cast<const unsigned char*>(signature.data), signature.len,
+                                                     message.data, static_cast<int>(message.len)));
+}
+
+// verify_certificate_issued_by_ca(cert, caCert) -> boolean
+napi_value verify_certificate_issued_by_ca_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view cert, ca_cert;
+    if (!get_bytes(env, argv[0], cert) || !get_bytes(env, argv[1], ca_cert)) {
+        return nullptr;
+    }
+    return make_bool(env, verify_certificate_issued_by_ca(cert.data, cert.len, ca_cert.data, ca_cert.len));
+}
+
+napi_value load_key_common(napi_env env, napi_callback_info info, bool private_key) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view key;
+    if (!get_key(env, argv[0], private_key ? ml_dsa_65_private_key_size : ml_dsa_65_public_key_size, key)) {
+        return nullptr;
+    }
+    mldsa_key_handle *handle = private_key ? load_mldsa65_private_key(key.data) : load_mldsa65_public_key(key.data);
+    if (!handle) {
+        return throw_error(env, "Key import failed");
+    }
+    return make_handle(env, key_handle_tag, handle,
+                       [](void *ptr) { free_mldsa65_key_handle(static_cast<mldsa_key_handle*>(ptr)); });
+}
+
+// load_mldsa65_private_key(privateKey) -> key handle
+napi_value load_private_key_native(napi_env env, napi_callback_info info) {
+    return load_key_common(env, info, true);
+}
+
+// load_mldsa65_public_key(publicKey) -> key handle
+napi_value load_public_key_native(napi_env env, napi_callback_info info) {
+    return load_key_common(env, info, false);
+}
+
+// free_mldsa65_key_handle(handle)
+napi_value free_key_handle_native(napi_env env, napi_callback_info info) {
+    return free_handle(env, info, key_handle_tag);
+}
+
+// sign_mldsa65_with_handle(handle, message) -> Buffer
+napi_value sign_with_handle_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    auto *handle = get_live_handle<mldsa_key_handle>(env, argv[0], key_handle_tag);
+    byte_view message;
+    if (!handle || !get_bytes(env, argv[1], message)) return nullptr;
+    unsigned char signature[ml_dsa_65_signature_size];
+    int len = sign_mldsa65_with_handle(handle, message.data, message.len, signature, sizeof(signature));
+    if (len <= 0) {
+        return throw_error(env, "Signing failed");
+    }
+    return make_buffer(env, signature, len);
+}
+
+// verify_mldsa65_with_handle(handle, signature, message) -> boolean
+napi_value verify_with_handle_native(napi_env env, napi_callback_info info) {
+    napi_value argv[3];
+    if (!get_args(env, info, 3, argv)) return nullptr;
+    auto *handle = get_live_handle<mldsa_key_handle>(env, argv[0], key_handle_tag);
+    byte_view signature, message;
+    if (!handle || !get_bytes(env, argv[1], signature) || !get_bytes(env, argv[2], message)) {
+        return nullptr;
+    }
+    if (message.len > INT32_MAX) {
+        return make_bool(env, false);
+    }
+    return make_bool(env, verify_mldsa65_with_handle(handle, reinterpret_cast<const unsigned char*>(signature.data),
+                                                     signature.len, message.data, static_cast<int>(message.len)));
+}
+
+// new_mldsa65_sign_ctx(handle) -> signing context
+napi_value new_sign_ctx_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    auto *handle = get_live_handle<mldsa_key_handle>(env, argv[0], key_handle_tag);
+    if (!handle) return nullptr;
+    mldsa_sign_ctx *ctx = new_mldsa65_sign_ctx(handle);
+    if (!ctx) {
+        return throw_error(env, "Failed to create signing context");
+    }
+    return make_handle(env, sign_ctx_tag, ctx, [](void *ptr) { free_mldsa65_sign_ctx(static_cast<mldsa_sign_ctx*>(ptr)); });
+}
+
+// sign_mldsa65_with_ctx(ctx, message) -> Buffer
+napi_value sign_with_ctx_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    auto *ctx = get_live_handle<mldsa_sign_ctx>(env, argv[0], sign_ctx_tag);
+    byte_view message;
+    if (!ctx || !get_bytes(env, argv[1], message)) return nullptr;
+    unsigned char signature[ml_dsa_65_signature_size];
+    int len = sign_mldsa65_with_ctx(ctx, message.data, message.len, signature, sizeof(signature));
+    if (len <= 0) {
+        return throw_error(env, "Signing failed");
+    }
+    return make_buffer(env, signature, len);
+}
+
+// free_mldsa65_sign_ctx(ctx)
+napi_value free_sign_ctx_native(napi_env env, napi_callback_info info) {
+    return free_handle(env, info, sign_ctx_tag);
+}
+
+// new_mldsa65_sign_stream(handle) -> signing stream
+napi_value new_sign_stream_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    auto *handle = get_live_handle<mldsa_key_handle>(env, argv[0], key_handle_tag);
+    if (!handle) return nullptr;
+    mldsa_sign_stream *stream = new_mldsa65_sign_stream(handle);
+    if (!stream) {
+        return throw_error(env, "Failed to start streaming signature");
+    }
+    return make_handle(env, sign_stream_tag, stream,
+                       [](void *ptr) { free_mldsa65_sign_stream(static_cast<mldsa_sign_stream*>(ptr)); });
+}
+
+// update_mldsa65_sign_stream(stream, chunk) -> boolean
+napi_value update_sign_stream_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    auto *stream = get_live_handle<mldsa_sign_stream>(env, argv[0], sign_stream_tag);
+    byte_view chunk;
+    if (!stream || !get_bytes(env, argv[1], chunk)) return nullptr;
+    return make_bool(env, update_mldsa65_sign_stream(stream, chunk.data, chunk.len));
+}
+
+// final_mldsa65_sign_stream(stream) -> Buffer
+napi_value final_sign_stream_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    auto *stream = get_live_handle<mldsa_sign_stream>(env, argv[0], sign_stream_tag);
+    if (!stream) return nullptr;
+    unsigned char signature[ml_dsa_65_signature_size];
+    int len = final_mldsa65_sign_stream(stream, signature, sizeof(signature));
+    if (len <= 0) {
+        return throw_error(env, "Streaming signature failed");
+    }
+    return make_buffer(env, signature, len);
+}
+
+// free_mldsa65_sign_stream(stream)
+napi_value free_sign_stream_native(napi_env env, napi_callback_info info) {
+    return free_handle(env, info, sign_stream_tag);
+}
+
+// verify_signature_batch(certificates[], certIndices[], signatures[], messages[], threads) -> boolean[]
+// Items run on the library's worker threads; the call returns once every item is checked.
+napi_value verify_signature_batch_native(napi_env env, napi_callback_info info) {
+    napi_value argv[5];
+    if (!get_args(env, info, 5, argv)) return nullptr;
+    std::vector<byte_view> certs, signatures, messages;
+    std::vector<const char*> cert_ptrs, signature_ptrs, message_ptrs;
+    std::vector<size_t> cert_lens, signature_lens, message_lens;
+    if (!get_byte_array(env, argv[0], "certificates", certs, cert_ptrs, cert_lens) ||
+        !get_byte_array(env, argv[2], "signatures", signatures, signature_ptrs, signature_lens) ||
+        !get_byte_array(env, argv[3], "messages", messages, message_ptrs, message_lens)) {
+        return nullptr;
+    }
+    uint32_t item_count = 0;
+    napi_get_array_length(env, argv[1], &item_count);
+    if (item_count != signatures.size() || item_count != messages.size()) {
+        napi_throw_range_error(env, nullptr, "certIndices, signatures and messages must have the same length");
+        return nullptr;
+    }
+    std::vector<uint32_t> indices(item_count);
+    for (uint32_t i = 0; i < item_count; ++i) {
+        napi_value entry;
+        napi_get_element(env, argv[1], i, &entry);
+        if (napi_get_value_uint32(env, entry, &indices[i]) != napi_ok) {
+            napi_throw_type_error(env, nullptr, "certIndices must be an array of numbers");
+            return nullptr;
+        }
+    }
+    std::vector<const unsigned char*> signature_bufs(item_count);
+    for (uint32_t i = 0; i < item_count; ++i) {
+        signature_bufs[i] = reinterpret_cast<const unsigned char*>(signature_ptrs[i]);
+    }
+    std::vector<unsigned char> bitmap(std::max<size_t>(1, (item_count + 7) / 8));
+    int valid = verify_signature_batch(cert_ptrs.data(), cert_lens.data(), cert_ptrs.size(), indices.data(),
+                                       signature_bufs.data(), signature_lens.data(),
+                                       message_ptrs.data(), message_lens.data(), item_count,
+                                       bitmap.data(), bitmap.size(), get_int(env, argv[4], 0));
+    if (valid < 0) {
+        return throw_error(env, "Batch signature verification failed");
+    }
+    napi_value result;
+    napi_create_array_with_length(env, item_count, &result);
+    for (uint32_t i = 0; i < item_count; ++i) {
+        napi_set_element(env, result, i, make_bool(env, bitmap[i / 8] & (1u << (i % 8))));
+    }
+    return result;
+}
+
+// mldsa_clear_trust_store_cache()
+napi_value clear_trust_store_cache_native(napi_env, napi_callback_info) {
+    mldsa_clear_trust_store_cache();
+    return nullptr;
+}
+
+// mldsa_set_verify_key_cache_capacity(capacity)
+napi_value set_verify_key_cache_capacity_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    mldsa_set_verify_key_cache_capacity(static_cast<size_t>(std::max(0, get_int(env, argv[0], 0))));
+    return nullptr;
+}
+
+// mldsa_get_verify_key_cache_stats() -> { hits, misses, entries }
+napi_value verify_key_cache_stats_native(napi_env env, napi_callback_info) {
+    uint64_t hits = 0, misses = 0;
+    size_t entries = 0;
+    mldsa_get_verify_key_cache_stats(&hits, &misses, &entries);
+    napi_value result, value;
+    napi_create_object(env, &result);
+    napi_create_double(env, static_cast<double>(hits), &value);
+    napi_set_named_property(env, result, "hits", value);
+    napi_create_double(env, static_cast<double>(misses), &value);
+    napi_set_named_property(env, result, "misses", value);
+    napi_create_double(env, static_cast<double>(entries), &value);
+    napi_set_named_property(env, result, "entries", value);
+    return result;
+}
+
+// mldsa_get_thread_allocation_counts() -> { heap, arena } for the calling (main JS) thread
+napi_value thread_allocation_counts_native(napi_env env, napi_callback_info) {
+    uint64_t heap = 0, arena = 0;
+    mldsa_get_thread_allocation_counts(&heap, &arena);
+    napi_value result, value;
+    napi_create_object(env, &result);
+    napi_create_double(env, static_cast<double>(heap), &value);
+    napi_set_named_property(env, result, "heap", value);
+    napi_create_double(env, static_cast<double>(arena), &value);
+    napi_set_named_property(env, result, "arena", value);
+    return result;
+}
+
+// stats_export(format) -> string (0 = JSON, 1 = Prometheus text)
+napi_value stats_export_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    std::vector<char> out(256 * 1024);
+    long len = mldsa_stats_export(get_int(env, argv[0], 0), out.data(), out.size());
+    if (len < 0) {
+        return throw_error(env, "Stats export failed");
+    }
+    napi_value result;
+    napi_create_string_utf8(env, out.data(), static_cast<size_t>(len), &result);
+    return result;
+}
+
+// drain_errors() -> string (JSON report, see mldsa_drain_errors)
+napi_value drain_errors_native(napi_env env, napi_callback_info) {
+    std::vector<char> out(output_buf_size);
+    long len = mldsa_drain_errors(out.data(), out.size());
+    if (len < 0) {
+        return throw_error(env, "Error drain failed");
+    }
+    napi_value result;
+    napi_create_string_utf8(env, out.data(), static_cast<size_t>(len), &result);
+    return result;
+}
+
+// set_error_summary_interval(seconds) -> undefined
+napi_value set_error_summary_interval_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    int32_t seconds = get_int(env, argv[0], 60);
+    mldsa_set_error_summary_interval(seconds > 0 ? static_cast<unsigned>(seconds) : 0);
+    return nullptr;
+}
+
+// stats_reset() -> undefined
+napi_value stats_reset_native(napi_env, napi_callback_info) {
+    mldsa_stats_reset();
+    return nullptr;
+}
+
+// keypair_pool_start(highWater, threads) -> boolean
+napi_value keypair_pool_start_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    int32_t high_water = get_int(env, argv[0], 0);
+    int32_t threads = get_int(env, argv[1], 1);
+    return make_bool(env, high_water > 0 &&
+                     mldsa_keypair_pool_start(static_cast<size_t>(high_water), threads > 0 ? threads : 0));
+}
+
+// keypair_pool_take() -> { privateKey, publicKey, pooled }
+napi_value keypair_pool_take_native(napi_env env, napi_callback_info) {
+    std::vector<char> private_key(ml_dsa_65_private_key_size);
+    std::vector<char> public_key(ml_dsa_65_public_key_size);
+    int source = mldsa_keypair_pool_take(private_key.data(), public_key.data());
+    if (!source) {
+        return throw_error(env, "Key generation failed");
+    }
+    napi_value result;
+    napi_create_object(env, &result);
+    napi_set_named_property(env, result, "privateKey", make_buffer(env, private_key.data(), private_key.size()));
+    napi_set_named_property(env, result, "publicKey", make_buffer(env, public_key.data(), public_key.size()));
+    napi_set_named_property(env, result, "pooled", make_bool(env, source == 1));
+    return result;
+}
+
+// keypair_pool_size() -> number
+napi_value keypair_pool_size_native(napi_env env, napi_callback_info) {
+    napi_value result;
+    napi_create_uint32(env, static_cast<uint32_t>(mldsa_keypair_pool_size()), &result);
+    return result;
+}
+
+// keypair_pool_stop() -> undefined
+napi_value keypair_pool_stop_native(napi_env, napi_callback_info) {
+    mldsa_keypair_pool_stop();
+    return nullptr;
+}
+
+// serial_init(nodeId, statePath | null) -> boolean
+napi_value serial_init_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    napi_valuetype path_type;
+    napi_typeof(env, argv[1], &path_type);
+    byte_view path;
+    if (path_type != napi_null && path_type != napi_undefined) {
+        if (!get_bytes(env, argv[1], path)) return nullptr;
+        if (path.owned.empty()) path.owned.assign(path.data, path.len);
+    }
+    int32_t node_id = get_int(env, argv[0], -1);
+    return make_bool(env, node_id >= 0 &&
+                     mldsa_serial_init(static_cast<uint32_t>(node_id), path.owned.empty() ? nullptr : path.owned.c_str()));
+}
+
+// certificate_serial(cert) -> Buffer (big-endian serial)
+napi_value certificate_serial_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view cert;
+    if (!get_bytes(env, argv[0], cert)) return nullptr;
+    unsigned char serial[64];
+    int len = mldsa_certificate_serial(cert.data, cert.len, serial, sizeof(serial));
+    if (len < 0) {
+        return throw_error(env, "Reading certificate serial failed");
+    }
+    return make_buffer(env, serial, len);
+}
+
+// revocation_load_crl(crl, caCert) -> number of serials loaded
+napi_value revocation_load_crl_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view crl, ca_cert;
+    if (!get_bytes(env, argv[0], crl) || !get_bytes(env, argv[1], ca_cert)) return nullptr;
+    int loaded = mldsa_revocation_load_crl(crl.data, crl.len, ca_cert.data, ca_cert.len);
+    if (loaded < 0) {
+        return throw_error(env, "Loading CRL failed");
+    }
+    napi_value result;
+    napi_create_int32(env, loaded, &result);
+    return result;
+}
+
+// revocation_check(cert) -> boolean
+napi_value revocation_check_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view cert;
+    if (!get_bytes(env, argv[0], cert)) return nullptr;
+    int revoked = mldsa_revocation_check(cert.data, cert.len);
+    if (revoked < 0) {
+        return throw_error(env, "Reading certificate failed");
+    }
+    return make_bool(env, revoked == 1);
+}
+
+// revocation_clear() -> undefined
+napi_value revocation_clear_native(napi_env, napi_callback_info) {
+    mldsa_revocation_clear();
+    return nullptr;
+}
+
+// sign_crl(caPrivateKey, caCert, serials[], nextUpdateDays, der) -> Buffer
+napi_value sign_crl_native(napi_env env, napi_callback_info info) {
+    napi_value argv[5];
+    if (!get_args(env, info, 5, argv)) return nullptr;
+    byte_view ca_private_key, ca_cert;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, ca_private_key) || !get_bytes(env, argv[1], ca_cert)) {
+        return nullptr;
+    }
+    uint32_t serial_count = 0;
+    if (napi_get_array_length(env, argv[2], &serial_count) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "serials must be an array");
+        return nullptr;
+    }
+    std::vector<byte_view> serials(serial_count);
+    std::vector<const unsigned char*> serial_ptrs(serial_count);
+    std::vector<size_t> serial_lens(serial_count);
+    for (uint32_t i = 0; i < serial_count; ++i) {
+        napi_value entry;
+        napi_get_element(env, argv[2], i, &entry);
+        if (!get_bytes(env, entry, serials[i])) return nullptr;
+        serial_ptrs[i] = reinterpret_cast<const unsigned char*>(serials[i].data);
+        serial_lens[i] = serials[i].len;
+    }
+    bool der_output = false;
+    napi_get_value_bool(env, argv[4], &der_output);
+    // Each revoked entry takes well under 64 bytes once encoded.
+    std::vector<char> out(output_buf_size + static_cast<size_t>(serial_count) * 128);
+    int len = sign_crl(ca_cert.data, ca_cert.len, ca_private_key.data, ca_private_key.len, serial_ptrs.data(),
+                       serial_lens.data(), serial_count, get_int(env, argv[3], 7), der_output, out.data(), out.size());
+    if (len <= 0) {
+        return throw_error(env, "CRL signing failed");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+// verify_status_cached(uuid, cert, caCert | null, signature, message, ttlSeconds) -> { valid, token }
+napi_value verify_status_cached_native(napi_env env, napi_callback_info info) {
+    napi_value argv[6];
+    if (!get_args(env, info, 6, argv)) return nullptr;
+    byte_view uuid, cert, ca_cert, signature, message;
+    if (!get_bytes(env, argv[0], uuid) || !get_bytes(env, argv[1], cert) ||
+        !get_bytes(env, argv[3], signature) || !get_bytes(env, argv[4], message)) {
+        return nullptr;
+    }
+    napi_valuetype ca_type;
+    napi_typeof(env, argv[2], &ca_type);
+    if (ca_type != napi_null && ca_type != napi_undefined && !get_bytes(env, argv[2], ca_cert)) {
+        return nullptr;
+    }
+    int32_t ttl = get_int(env, argv[5], 300);
+    unsigned char token[mldsa_status_token_size];
+    int status = mldsa_verify_status_cached(uuid.data, uuid.len, cert.data, cert.len, ca_cert.data, ca_cert.len,
+                                            reinterpret_cast<const unsigned char*>(signature.data), signature.len,
+                                            message.data, message.len, ttl > 0 ? static_cast<unsigned>(ttl) : 0,
+                                            token, sizeof(token));
+    if (status < 0) {
+        return throw_error(env, "Status verification failed");
+    }
+    napi_value result;
+    napi_create_object(env, &result);
+    napi_set_named_property(env, result, "valid", make_bool(env, status == 1));
+    napi_set_named_property(env, result, "token", make_buffer(env, token, sizeof(token)));
+    return result;
+}
+
+// status_token_check(uuid, cert, caCert | null, signature, message, token) -> 1 valid, 0 invalid,
+// -1 bad or expired token, or a token for other content
+napi_value status_token_check_native(napi_env env, napi_callback_info info) {
+    napi_value argv[6];
+    if (!get_args(env, info, 6, argv)) return nullptr;
+    byte_view uuid, cert, ca_cert, signature, message, token;
+    if (!get_bytes(env, argv[0], uuid) || !get_bytes(env, argv[1], cert) ||
+        !get_bytes(env, argv[3], signature) || !get_bytes(env, argv[4], message) || !get_bytes(env, argv[5], token)) {
+        return nullptr;
+    }
+    napi_valuetype ca_type;
+    napi_typeof(env, argv[2], &ca_type);
+    if (ca_type != napi_null && ca_type != napi_undefined && !get_bytes(env, argv[2], ca_cert)) {
+        return nullptr;
+    }
+    napi_value result;
+    napi_create_int32(env, mldsa_status_token_check(uuid.data, uuid.len, cert.data, cert.len, ca_cert.data, ca_cert.len,
+                                                    reinterpret_cast<const unsigned char*>(signature.data), signature.len,
+                                                    message.data, message.len,
+                                                    reinterpret_cast<const unsigned char*>(token.data), token.len), &result);
+    return result;
+}
+
+// status_set_key(key) -> boolean
+napi_value status_set_key_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view key;
+    if (!get_bytes(env, argv[0], key)) return nullptr;
+    return make_bool(env, mldsa_status_set_key(reinterpret_cast<const unsigned char*>(key.data), key.len));
+}
+
+// status_cache_clear() -> undefined
+napi_value status_cache_clear_native(napi_env, napi_callback_info) {
+    mldsa_status_cache_clear();
+    return nullptr;
+}
+
+// qr_message_encode(fields[]) -> Buffer
+napi_value qr_message_encode_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    std::vector<byte_view> fields;
+    std::vector<const char*> ptrs;
+    std::vector<size_t> lens;
+    if (!get_byte_array(env, argv[0], "fields", fields, ptrs, lens)) return nullptr;
+    size_t total = 10;
+    for (size_t len : lens) total += 10 + len;
+    std::vector<unsigned char> out(total);
+    long len = mldsa_qr_message_encode(ptrs.data(), lens.data(), ptrs.size(), out.data(), out.size());
+    if (len < 0) {
+        return throw_error(env, "QR message encoding failed");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+// qr_message_fields(message) -> [[offset, length], ...] | null
+napi_value qr_message_fields_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view message;
+    if (!get_bytes(env, argv[0], message)) return nullptr;
+    // Every field takes at least one byte, so the message length bounds the count.
+    std::vector<size_t> offsets(message.len + 1), lens(message.len + 1);
+    long count = mldsa_qr_message_fields(message.data, message.len, offsets.data(), lens.data(), offsets.size());
+    napi_value result;
+    if (count < 0) {
+        napi_get_null(env, &result);
+        return result;
+    }
+    napi_create_array_with_length(env, count, &result);
+    for (long i = 0; i < count; ++i) {
+        napi_value pair, offset, length;
+        napi_create_array_with_length(env, 2, &pair);
+        napi_create_double(env, static_cast<double>(offsets[i]), &offset);
+        napi_create_double(env, static_cast<double>(lens[i]), &length);
+        napi_set_element(env, pair, 0, offset);
+        napi_set_element(env, pair, 1, length);
+        napi_set_element(env, result, i, pair);
+    }
+    return result;
+}
+
+// qr_payload_encode(cert, message, signature) -> Buffer
+napi_value qr_payload_encode_native(napi_env env, napi_callback_info info) {
+    napi_value argv[3];
+    if (!get_args(env, info, 3, argv)) return nullptr;
+    byte_view cert, message, signature;
+    if (!get_bytes(env, argv[0], cert) || !get_bytes(env, argv[1], message) || !get_bytes(env, argv[2], signature)) {
+        return nullptr;
+    }
+    std::vector<unsigned char> out(3 + mldsa_qr_fingerprint_size + 20 + message.len + signature.len);
+    long len = mldsa_qr_payload_encode(cert.data, cert.len, message.data, message.len,
+                                       reinterpret_cast<const unsigned char*>(signature.data), signature.len,
+                                       out.data(), out.size());
+    if (len < 0) {
+        return throw_error(env, "QR payload encoding failed");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+// qr_payload_parse(payload) -> { version, fingerprint, messageOffset, messageLength, signatureOffset, signatureLength } | null
+napi_value qr_payload_parse_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view payload;
+    if (!get_bytes(env, argv[0], payload)) return nullptr;
+    size_t spans[4];
+    unsigned char fingerprint[mldsa_qr_fingerprint_size];
+    int version = mldsa_qr_payload_parse(reinterpret_cast<const unsigned char*>(payload.data), payload.len, spans, fingerprint);
+    napi_value result;
+    if (version < 0) {
+        napi_get_null(env, &result);
+        return result;
+    }
+    const char *names[4] = {"messageOffset", "messageLength", "signatureOffset", "signatureLength"};
+    napi_value value;
+    napi_create_object(env, &result);
+    napi_create_int32(env, version, &value);
+    napi_set_named_property(env, result, "version", value);
+    napi_set_named_property(env, result, "fingerprint", make_buffer(env, fingerprint, sizeof(fingerprint)));
+    for (int i = 0; i < 4; ++i) {
+        napi_create_double(env, static_cast<double>(spans[i]), &value);
+        napi_set_named_property(env, result, names[i], value);
+    }
+    return result;
+}
+
+// qr_payload_verify(payload, cert) -> 1 valid, 0 invalid, -1 malformed
+napi_value qr_payload_verify_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view payload, cert;
+    if (!get_bytes(env, argv[0], payload) || !get_bytes(env, argv[1], cert)) return nullptr;
+    napi_value result;
+    napi_create_int32(env, mldsa_qr_payload_verify(reinterpret_cast<const unsigned char*>(payload.data), payload.len,
+                                                   cert.data, cert.len), &result);
+    return result;
+}
+
+// qr_payload_split(payload, maxFrameSize) -> Buffer[]
+napi_value qr_payload_split_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view payload;
+    if (!get_bytes(env, argv[0], payload)) return nullptr;
+    int32_t max_frame_size = get_int(env, argv[1], 2953);
+    size_t frame_lens[16];
+    std::vector<unsigned char> out(payload.len + 16 * 4);
+    long count = max_frame_size > 0
+        ? mldsa_qr_payload_split(reinterpret_cast<const unsigned char*>(payload.data), payload.len, max_frame_size,
+                                 out.data(), out.size(), frame_lens, 16)
+        : -1;
+    if (count < 0) {
+        return throw_error(env, "QR payload does not fit 16 frames of the given size");
+    }
+    napi_value result;
+    napi_create_array_with_length(env, count, &result);
+    size_t offset = 0;
+    for (long i = 0; i < count; ++i) {
+        napi_set_element(env, result, i, make_buffer(env, out.data() + offset, frame_lens[i]));
+        offset += frame_lens[i];
+    }
+    return result;
+}
+
+// qr_payload_join(frames[]) -> Buffer
+napi_value qr_payload_join_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    std::vector<byte_view> frames;
+    std::vector<const char*> ptrs;
+    std::vector<size_t> lens;
+    if (!get_byte_array(env, argv[0], "frames", frames, ptrs, lens)) return nullptr;
+    size_t total = 0;
+    for (size_t len : lens) total += len;
+    std::vector<unsigned char> out(std::max<size_t>(1, total));
+    long len = mldsa_qr_payload_join(reinterpret_cast<const unsigned char**>(ptrs.data()), lens.data(), ptrs.size(),
+                                     out.data(), out.size());
+    if (len < 0) {
+        return throw_error(env, "QR frames are incomplete or corrupt");
+    }
+    return make_buffer(env, out.data(), len);
+}
+
+// merkle_sign_batch(privateKey, documents[]) -> { signature, proofs[] }
+napi_value merkle_sign_batch_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view private_key;
+    if (!get_key(env, argv[0], ml_dsa_65_private_key_size, private_key)) return nullptr;
+    std::vector<byte_view> documents;
+    std::vector<const char*> ptrs;
+    std::vector<size_t> lens;
+    if (!get_byte_array(env, argv[1], "documents", documents, ptrs, lens)) return nullptr;
+    size_t depth = 0;
+    for (size_t width = ptrs.size(); width > 1; width = (width + 1) / 2) ++depth;
+    std::vector<unsigned char> signature(ml_dsa_65_signature_size);
+    std::vector<unsigned char> proofs(std::max<size_t>(1, ptrs.size() * (12 + 32 * depth)));
+    std::vector<size_t> proof_lens(ptrs.size());
+    long sig_len = mldsa_merkle_sign_batch(private_key.data, ptrs.data(), lens.data(), ptrs.size(),
+                                           signature.data(), signature.size(), proofs.data(), proofs.size(),
+                                           proof_lens.data());
+    if (sig_len < 0) {
+        return throw_error(env, "Merkle batch signing failed");
+    }
+    napi_value result, proof_array;
+    napi_create_object(env, &result);
+    napi_create_array_with_length(env, ptrs.size(), &proof_array);
+    size_t offset = 0;
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+        napi_set_element(env, proof_array, i, make_buffer(env, proofs.data() + offset, proof_lens[i]));
+        offset += proof_lens[i];
+    }
+    napi_set_named_property(env, result, "signature", make_buffer(env, signature.data(), sig_len));
+    napi_set_named_property(env, result, "proofs", proof_array);
+    return result;
+}
+
+// merkle_verify(publicKey, signature, proof, document) -> 1 valid, 0 invalid, -1 malformed proof
+napi_value merkle_verify_native(napi_env env, napi_callback_info info) {
+    napi_value argv[4];
+    if (!get_args(env, info, 4, argv)) return nullptr;
+    byte_view public_key, signature, proof, document;
+    if (!get_key(env, argv[0], ml_dsa_65_public_key_size, public_key) || !get_bytes(env, argv[1], signature) ||
+        !get_bytes(env, argv[2], proof) || !get_bytes(env, argv[3], document)) {
+        return nullptr;
+    }
+    napi_value result;
+    napi_create_int32(env, mldsa_merkle_verify(public_key.data, reinterpret_cast<const unsigned char*>(signature.data),
+                                               signature.len, reinterpret_cast<const unsigned char*>(proof.data),
+                                               proof.len, document.data, document.len), &result);
+    return result;
+}
+
+// merkle_verify_with_cert(cert, signature, proof, document) -> 1 valid, 0 invalid, -1 malformed proof
+napi_value merkle_verify_with_cert_native(napi_env env, napi_callback_info info) {
+    napi_value argv[4];
+    if (!get_args(env, info, 4, argv)) return nullptr;
+    byte_view cert, signature, proof, document;
+    if (!get_bytes(env, argv[0], cert) || !get_bytes(env, argv[1], signature) ||
+        !get_bytes(env, argv[2], proof) || !get_bytes(env, argv[3], document)) {
+        return nullptr;
+    }
+    napi_value result;
+    napi_create_int32(env, mldsa_merkle_verify_with_cert(cert.data, cert.len,
+                                                         reinterpret_cast<const unsigned char*>(signature.data), signature.len,
+                                                         reinterpret_cast<const unsigned char*>(proof.data), proof.len,
+                                                         document.data, document.len), &result);
+    return result;
+}
+
+// sig_store_open(dir, segmentSize) -> boolean
+napi_value sig_store_open_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view dir;
+    if (!get_bytes(env, argv[0], dir)) return nullptr;
+    if (dir.owned.empty()) dir.owned.assign(dir.data, dir.len);
+    int32_t segment_size = get_int(env, argv[1], 0);
+    return make_bool(env, segment_size >= 0 && mldsa_sig_store_open(dir.owned.c_str(), static_cast<size_t>(segment_size)));
+}
+
+// sig_store_close() -> undefined
+napi_value sig_store_close_native(napi_env, napi_callback_info) {
+    mldsa_sig_store_close();
+    return nullptr;
+}
+
+// sig_store_put(key, message, signature, durable) -> boolean
+napi_value sig_store_put_native(napi_env env, napi_callback_info info) {
+    napi_value argv[4];
+    if (!get_args(env, info, 4, argv)) return nullptr;
+    byte_view key, message, signature;
+    if (!get_bytes(env, argv[0], key) || !get_bytes(env, argv[1], message) || !get_bytes(env, argv[2], signature)) {
+        return nullptr;
+    }
+    bool durable = true;
+    napi_get_value_bool(env, argv[3], &durable);
+    return make_bool(env, mldsa_sig_store_put(key.data, key.len, message.data, message.len,
+                                              reinterpret_cast<const unsigned char*>(signature.data), signature.len, durable));
+}
+
+// sig_store_get(key) -> { message, signature } | null
+napi_value sig_store_get_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view key;
+    if (!get_bytes(env, argv[0], key)) return nullptr;
+    std::vector<char> message(1024);
+    std::vector<unsigned char> signature(ml_dsa_65_signature_size);
+    size_t message_len = 0, signature_len = 0;
+    int found = mldsa_sig_store_get(key.data, key.len, message.data(), message.size(), &message_len,
+                                    signature.data(), signature.size(), &signature_len);
+    if (found < 0) {
+        // Larger than the first guess; the lengths now say how much to allocate.
+        message.resize(std::max<size_t>(1, message_len));
+        signature.resize(std::max<size_t>(1, signature_len));
+        found = mldsa_sig_store_get(key.data, key.len, message.data(), message.size(), &message_len,
+                                    signature.data(), signature.size(), &signature_len);
+    }
+    napi_value result;
+    if (found != 1) {
+        napi_get_null(env, &result);
+        return result;
+    }
+    napi_create_object(env, &result);
+    napi_set_named_property(env, result, "message", make_buffer(env, message.data(), message_len));
+    napi_set_named_property(env, result, "signature", make_buffer(env, signature.data(), signature_len));
+    return result;
+}
+
+// sig_store_verify_with_cert(key, cert) -> 1 valid, 0 invalid, -1 not stored
+napi_value sig_store_verify_with_cert_native(napi_env env, napi_callback_info info) {
+    napi_value argv[2];
+    if (!get_args(env, info, 2, argv)) return nullptr;
+    byte_view key, cert;
+    if (!get_bytes(env, argv[0], key) || !get_bytes(env, argv[1], cert)) return nullptr;
+    napi_value result;
+    napi_create_int32(env, mldsa_sig_store_verify_with_cert(key.data, key.len, cert.data, cert.len), &result);
+    return result;
+}
+
+// sig_store_delete(key) -> boolean
+napi_value sig_store_delete_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    byte_view key;
+    if (!get_bytes(env, argv[0], key)) return nullptr;
+    return make_bool(env, mldsa_sig_store_delete(key.data, key.len));
+}
+
+// sig_store_sync() -> boolean
+napi_value sig_store_sync_native(napi_env env, napi_callback_info) {
+    return make_bool(env, mldsa_sig_store_sync());
+}
+
+// sig_store_compact(maxLiveRatio) -> segments reclaimed, -1 on failure
+napi_value sig_store_compact_native(napi_env env, napi_callback_info info) {
+    napi_value argv[1];
+    if (!get_args(env, info, 1, argv)) return nullptr;
+    double ratio = 0.5;
+    napi_get_value_double(env, argv[0], &ratio);
+    napi_value result;
+    napi_create_double(env, static_cast<double>(mldsa_sig_store_compact(ratio)), &result);
+    return result;
+}
+
+// sig_store_stats() -> { records, segments, bytes, deadBytes }
+napi_value sig_store_stats_native(napi_env env, napi_callback_info) {
+    uint64_t values[4];
+    mldsa_sig_store_stats(&values[0], &values[1], &values[2], &values[3]);
+    const char *names[4] = {"records", "segments", "bytes", "deadBytes"};
+    napi_value result, value;
+    napi_create_object(env, &result);
+    for (int i = 0; i < 4; ++i) {
+        napi_create_double(env, static_cast<double>(values[i]), &value);
+        napi_set_named_property(env, result, names[i], value);
+    }
+    return result;
+}
+
+napi_value init(napi_env env, napi_value exports) {
+    // The addon links its own OpenSSL, so nothing has allocated through it yet.
+    mldsa_install_allocator_hooks();
+    constexpr napi_property_attributes method_attributes =
+        static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+    const napi_property_descriptor properties[] = {
+        {"generate_mldsa65_keypair", nullptr, generate_keypair, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"generate_csr", nullptr, generate_csr_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"generate_self_signed_certificate", nullptr, generate_self_signed_certificate_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_certificate", nullptr, sign_certificate_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_certificate_der", nullptr, sign_certificate_der_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_certificates_batch", nullptr, sign_certificates_batch_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_mldsa65", nullptr, sign_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_mldsa65", nullptr, verify_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_signature_with_cert", nullptr, verify_signature_with_cert_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_certificate_issued_by_ca", nullptr, verify_certificate_issued_by_ca_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"load_mldsa65_private_key", nullptr, load_private_key_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"load_mldsa65_public_key", nullptr, load_public_key_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"free_mldsa65_key_handle", nullptr, free_key_handle_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_mldsa65_with_handle", nullptr, sign_with_handle_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_mldsa65_with_handle", nullptr, verify_with_handle_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"new_mldsa65_sign_ctx", nullptr, new_sign_ctx_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_mldsa65_with_ctx", nullptr, sign_with_ctx_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"free_mldsa65_sign_ctx", nullptr, free_sign_ctx_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"new_mldsa65_sign_stream", nullptr, new_sign_stream_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"update_mldsa65_sign_stream", nullptr, update_sign_stream_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"final_mldsa65_sign_stream", nullptr, final_sign_stream_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"free_mldsa65_sign_stream", nullptr, free_sign_stream_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_signature_batch", nullptr, verify_signature_batch_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"clear_trust_store_cache", nullptr, clear_trust_store_cache_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"set_verify_key_cache_capacity", nullptr, set_verify_key_cache_capacity_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_key_cache_stats", nullptr, verify_key_cache_stats_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"thread_allocation_counts", nullptr, thread_allocation_counts_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"stats_export", nullptr, stats_export_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"stats_reset", nullptr, stats_reset_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"drain_errors", nullptr, drain_errors_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"set_error_summary_interval", nullptr, set_error_summary_interval_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"keypair_pool_start", nullptr, keypair_pool_start_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"keypair_pool_take", nullptr, keypair_pool_take_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"keypair_pool_size", nullptr, keypair_pool_size_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"keypair_pool_stop", nullptr, keypair_pool_stop_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"serial_init", nullptr, serial_init_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"certificate_serial", nullptr, certificate_serial_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"revocation_load_crl", nullptr, revocation_load_crl_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"revocation_check", nullptr, revocation_check_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"revocation_clear", nullptr, revocation_clear_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sign_crl", nullptr, sign_crl_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"verify_status_cached", nullptr, verify_status_cached_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"status_token_check", nullptr, status_token_check_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"status_set_key", nullptr, status_set_key_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"status_cache_clear", nullptr, status_cache_clear_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_message_encode", nullptr, qr_message_encode_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_message_fields", nullptr, qr_message_fields_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_payload_encode", nullptr, qr_payload_encode_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_payload_parse", nullptr, qr_payload_parse_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_payload_verify", nullptr, qr_payload_verify_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_payload_split", nullptr, qr_payload_split_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"qr_payload_join", nullptr, qr_payload_join_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"merkle_sign_batch", nullptr, merkle_sign_batch_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"merkle_verify", nullptr, merkle_verify_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"merkle_verify_with_cert", nullptr, merkle_verify_with_cert_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_open", nullptr, sig_store_open_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_close", nullptr, sig_store_close_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_put", nullptr, sig_store_put_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_get", nullptr, sig_store_get_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_verify_with_cert", nullptr, sig_store_verify_with_cert_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_delete", nullptr, sig_store_delete_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_sync", nullptr, sig_store_sync_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_compact", nullptr, sig_store_compact_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+        {"sig_store_stats", nullptr, sig_store_stats_native, nullptr, nullptr, nullptr, method_attributes, nullptr},
+    };
+    napi_define_properties(env, exports, sizeof(properties) / sizeof(properties[0]), properties);
+    return exports;
+}
+
+} // namespace
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, init)
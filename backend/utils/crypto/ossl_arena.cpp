@@ -0,0 +1,241 @@
+#include "mldsa_lib.h"
+
+// src/ossl_arena.cpp
+// Per-request bump arena for OpenSSL allocations made during certificate issuance.
+//
+// OpenSSL only accepts allocator hooks before its first allocation, and the hooks are
+// process wide. Once installed, every OpenSSL allocation carries a small header naming
+// the arena it came from (or none for the general heap), so frees and reallocs can be
+// routed correctly no matter which thread or scope releases the object.
+//
+// Inside an issuance_arena_scope, allocations on that thread are bump-allocated from a
+// thread-local arena and frees are no-ops. When the scope ends and nothing escaped, the
+// arena is reset in one shot. If OpenSSL kept something (lazy caches on first use), the
+// arena is retired instead and destroyed when the last escaped object is freed.
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <openssl/crypto.h>
+
+namespace {
+
+constexpr size_t chunk_size = 64 * 1024;
+constexpr size_t large_alloc_size = 16 * 1024;
+constexpr uint64_t retired_bit = 1ull << 63;
+
+struct issuance_arena;
+
+struct alignas(16) alloc_header {
+    size_t size;
+    issuance_arena *owner; // nullptr for general heap allocations
+};
+
+struct arena_chunk {
+    arena_chunk *next;
+    size_t capacity;
+    size_t used;
+    // payload follows, 16-byte aligned
+};
+
+constexpr size_t chunk_header_size = (sizeof(arena_chunk) + 15) & ~size_t(15);
+
+struct issuance_arena {
+    arena_chunk *chunks = nullptr;
+    // Live allocation count, with retired_bit set once the owning scope gave up on it.
+    std::atomic<uint64_t> state{0};
+};
+
+void destroy_arena(issuance_arena *arena);
+
+std::atomic<bool> hooks_installed{false};
+std::atomic<bool> arena_enabled{true};
+
+thread_local issuance_arena *cached_arena = nullptr;
+// Releases the idle cached arena when its thread exits.
+thread_local struct cached_arena_holder {
+    ~cached_arena_holder() {
+        if (cached_arena) {
+            destroy_arena(cached_arena);
+            cached_arena = nullptr;
+        }
+    }
+} cached_arena_cleanup;
+thread_local issuance_arena *active_arena = nullptr;
+thread_local int scope_depth = 0;
+thread_local uint64_t thread_heap_allocs = 0;
+thread_local uint64_t thread_arena_allocs = 0;
+
+arena_chunk* new_chunk(size_t min_payload) {
+    size_t capacity = min_payload > chunk_size ? min_payload : chunk_size;
+    arena_chunk *chunk = static_cast<arena_chunk*>(malloc(chunk_header_size + capacity));
+    if (!chunk) {
+        return nullptr;
+    }
+    chunk->next = nullptr;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    return chunk;
+}
+
+void free_chunks(arena_chunk *chunk) {
+    while (chunk) {
+        arena_chunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+void destroy_arena(issuance_arena *arena) {
+    free_chunks(arena->chunks);
+    delete arena;
+}
+
+// Keeps the first chunk and drops the rest.
+void reset_arena(issuance_arena *arena) {
+    if (arena->chunks) {
+        free_chunks(arena->chunks->next);
+        arena->chunks->next = nullptr;
+        arena->chunks->used = 0;
+    }
+    arena->state.store(0, std::memory_order_relaxed);
+}
+
+void* arena_bump(issuance_arena *arena, size_t total) {
+    total = (total + 15) & ~size_t(15);
+    arena_chunk *chunk = arena->chunks;
+    if (total >= large_alloc_size) {
+        // Large blocks get their own chunk behind the current one.
+        arena_chunk *large = new_chunk(total);
+        if (!large) return nullptr;
+        large->used = total;
+        if (chunk) {
+            large->next = chunk->next;
+            chunk->next = large;
+        } else {
+            arena->chunks = large;
+        }
+        return reinterpret_cast<unsigned char*>(large) + chunk_header_size;
+    }
+    if (!chunk || chunk->capacity - chunk->used < total) {
+        arena_chunk *fresh = new_chunk(total);
+        if (!fresh) return nullptr;
+        fresh->next = chunk;
+        arena->chunks = fresh;
+        chunk = fresh;
+    }
+    void *ptr = reinterpret_cast<unsigned char*>(chunk) + chunk_header_size + chunk->used;
+    chunk->used += total;
+    return ptr;
+}
+
+void* hooked_malloc(size_t num, const char *, int) {
+    size_t total = sizeof(alloc_header) + num;
+    issuance_arena *arena = active_arena;
+    alloc_header *header = nullptr;
+    if (arena) {
+        header = static_cast<alloc_header*>(arena_bump(arena, total));
+        if (header) {
+            arena->state.fetch_add(1, std::memory_order_relaxed);
+            ++thread_arena_allocs;
+        } else {
+            arena = nullptr;
+        }
+    }
+    if (!header) {
+        header = static_cast<alloc_header*>(malloc(total));
+        if (!header) return nullptr;
+        ++thread_heap_allocs;
+    }
+    header->size = num;
+    header->owner = arena;
+    return header + 1;
+}
+
+void hooked_free(void *addr, const char *, int) {
+    if (!addr) return;
+    alloc_header *header = static_cast<alloc_header*>(addr) - 1;
+    issuance_arena *owner = header->owner;
+    if (!owner) {
+        free(header);
+        return;
+    }
+    // Arena memory is reclaimed in bulk; only track liveness here.
+    uint64_t old = owner->state.fetch_sub(1, std::memory_order_acq_rel);
+    if (old == (retired_bit | 1)) {
+        destroy_arena(owner);
+    }
+}
+
+void* hooked_realloc(void *addr, size_t num, const char *file, int line) {
+    if (!addr) return hooked_malloc(num, file, line);
+    if (num == 0) {
+        hooked_free(addr, file, line);
+        return nullptr;
+    }
+    alloc_header *header = static_cast<alloc_header*>(addr) - 1;
+    if (!header->owner && !active_arena) {
+        alloc_header *grown = static_cast<alloc_header*>(realloc(header, sizeof(alloc_header) + num));
+        if (!grown) return nullptr;
+        grown->size = num;
+        ++thread_heap_allocs;
+        return grown + 1;
+    }
+    void *fresh = hooked_malloc(num, file, line);
+    if (!fresh) return nullptr;
+    memcpy(fresh, addr, header->size < num ? header->size : num);
+    hooked_free(addr, file, line);
+    return fresh;
+}
+
+} // namespace
+
+issuance_arena_scope::issuance_arena_scope() {
+    if (scope_depth++ > 0 || !hooks_installed.load(std::memory_order_relaxed) ||
+        !arena_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!cached_arena) {
+        cached_arena = new (std::nothrow) issuance_arena();
+    }
+    (void) &cached_arena_cleanup; // make sure this thread registers the cleanup
+    active_arena = cached_arena;
+}
+
+issuance_arena_scope::~issuance_arena_scope() {
+    if (--scope_depth > 0 || !active_arena) {
+        return;
+    }
+    issuance_arena *arena = active_arena;
+    active_arena = nullptr;
+    uint64_t old = arena->state.fetch_or(retired_bit, std::memory_order_acq_rel);
+    if ((old & ~retired_bit) == 0) {
+        // Nothing escaped: free everything in one shot and keep the arena for the next request.
+        reset_arena(arena);
+    } else {
+        // The last free of an escaped object destroys it (see hooked_free).
+        cached_arena = nullptr;
+    }
+}
+
+bool mldsa_install_allocator_hooks(void) {
+    if (hooks_installed.load()) {
+        return true;
+    }
+    if (CRYPTO_set_mem_functions(hooked_malloc, hooked_realloc, hooked_free) != 1) {
+        // OpenSSL has already allocated; keep using its default allocator.
+        return false;
+    }
+    hooks_installed.store(true);
+    return true;
+}
+
+void mldsa_set_issuance_arena_enabled(bool enabled) {
+    arena_enabled.store(enabled);
+}
+
+void mldsa_get_thread_allocation_counts(uint64_t *heap_allocs, uint64_t *arena_allocs) {
+    if (heap_allocs) *heap_allocs = thread_heap_allocs;
+    if (arena_allocs) *arena_allocs = thread_arena_allocs;
+}
@@ -0,0 +1,328 @@
+#include "mldsa_lib.h"
+
+// src/qr_payload.cpp
+// Binary QR payload carrying a signed message and its raw ML-DSA-65 signature.
+//
+// The text format (`applicant#<json>##<base64 signature>##`) spends 4/3 bytes per signature
+// byte; QR byte mode carries raw bytes, so the payload packs everything as-is:
+//
+//   [0..1]   'M' 'Q'
+//   [2]      version
+//   [3..34]  SHA-256 of the signer certificate (DER), picks the certificate to verify with
+//   varint   message length, then the signed message bytes
+//   varint   signature length, then the signature bytes
+//
+// A message built by mldsa_qr_message_encode is a varint field count followed by
+// (varint length, bytes) per field, so structured data needs no JSON or escaping.
+// Varints are unsigned LEB128.
+//
+// A 3309-byte signature does not fit one QR symbol (version 40-L holds 2953 bytes), so
+// mldsa_qr_payload_split cuts a payload into at most 16 frames that mirror QR structured
+// append: 'M' 'S', (index << 4 | total - 1), parity (XOR of every payload byte).
+// Encoders with structured-append support can copy index/total/parity into the symbol
+// header; the in-band frame header lets any scanner reassemble with mldsa_qr_payload_join.
+#include <algorithm>
+#include <cstring>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+namespace {
+
+constexpr unsigned char payload_magic[2] = {'M', 'Q'};
+constexpr unsigned char frame_magic[2] = {'M', 'S'};
+constexpr size_t frame_header_size = 4;
+constexpr size_t max_frames = 16;
+
+size_t varint_size(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+unsigned char *put_varint(unsigned char *out, uint64_t v) {
+    while (v >= 0x80) {
+        *out++ = static_cast<unsigned char>(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(v);
+    return out;
+}
+
+// Reads a varint from [pos, end); fails on truncated input.
+bool get_varint(const unsigned char *&pos, const unsigned char *end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        unsigned char byte = *pos++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads a varint length and the span it covers.
+bool get_span(const unsigned char *&pos, const unsigned char *end, const unsigned char *&data, size_t& len) {
+    uint64_t v;
+    if (!get_varint(pos, end, v) || v > static_cast<uint64_t>(end - pos)) {
+        return false;
+    }
+    data = pos;
+    len = static_cast<size_t>(v);
+    pos += len;
+    return true;
+}
+
+// SHA-256 of the certificate's DER. DER input is hashed as-is; PEM is parsed first.
+bool certificate_fingerprint(const char *cert_buf, size_t cert_len, unsigned char *out) {
+    if (is_der_encoded(cert_buf, cert_len)) {
+        if (EVP_Digest(cert_buf, cert_len, out, nullptr, EVP_sha256(), nullptr) != 1) {
+            handle_openssl_error("EVP_Digest for certificate fingerprint");
+            return false;
+        }
+        return true;
+    }
+    X509_ptr cert = read_x509(cert_buf, cert_len);
+    unsigned int len = 0;
+    if (!cert || X509_digest(cert.get(), EVP_sha256(), out, &len) != 1) {
+        handle_openssl_error("X509_digest for certificate fingerprint");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool parse_qr_payload(const unsigned char *payload, size_t payload_len, qr_payload_view& view) {
+    if (!payload || payload_len < 3 + mldsa_qr_fingerprint_size ||
+        memcmp(payload, payload_magic, sizeof(payload_magic)) != 0 || payload[2] != mldsa_qr_payload_version) {
+        return false;
+    }
+    const unsigned char *pos = payload + 3;
+    const unsigned char *end = payload + payload_len;
+    view.version = payload[2];
+    view.fingerprint = pos;
+    pos += mldsa_qr_fingerprint_size;
+    const unsigned char *message;
+    if (!get_span(pos, end, message, view.message_len) ||
+        !get_span(pos, end, view.signature, view.signature_len) || pos != end) {
+        return false;
+    }
+    view.message = reinterpret_cast<const char*>(message);
+    return true;
+}
+
+bool next_qr_field(qr_field_cursor& cursor, const char *&data, size_t& len) {
+    if (cursor.remaining == 0) {
+        return false;
+    }
+    const unsigned char *field;
+    if (!get_span(cursor.pos, cursor.end, field, len)) {
+        cursor.remaining = 0;
+        return false;
+    }
+    --cursor.remaining;
+    data = reinterpret_cast<const char*>(field);
+    return true;
+}
+
+bool open_qr_fields(const char *message, size_t message_len, qr_field_cursor& cursor) {
+    cursor.pos = reinterpret_cast<const unsigned char*>(message);
+    cursor.end = cursor.pos + message_len;
+    uint64_t count;
+    if (!message || !get_varint(cursor.pos, cursor.end, count) || count > message_len) {
+        cursor.remaining = 0;
+        return false;
+    }
+    cursor.remaining = static_cast<size_t>(count);
+    return true;
+}
+
+long mldsa_qr_message_encode(const char **fields, const size_t *field_lens, size_t field_count,
+                             unsigned char *out, size_t out_size) {
+    if (field_count > 0 && (!fields || !field_lens)) {
+        return -1;
+    }
+    size_t total = varint_size(field_count);
+    for (size_t i = 0; i < field_count; ++i) {
+        if (field_lens[i] > 0 && !fields[i]) {
+            return -1;
+        }
+        total += varint_size(field_lens[i]) + field_lens[i];
+    }
+    if (!out || total > out_size) {
+        return -1;
+    }
+    unsigned char *pos = put_varint(out, field_count);
+    for (size_t i = 0; i < field_count; ++i) {
+        pos = put_varint(pos, field_lens[i]);
+        if (field_lens[i] > 0) {
+            memcpy(pos, fields[i], field_lens[i]);
+        }
+        pos += field_lens[i];
+    }
+    return static_cast<long>(total);
+}
+
+long mldsa_qr_message_fields(const char *message, size_t message_len, size_t *offsets, size_t *lens, size_t max_fields) {
+    qr_field_cursor cursor;
+    if (!open_qr_fields(message, message_len, cursor) || cursor.remaining > max_fields ||
+        (cursor.remaining > 0 && (!offsets || !lens))) {
+        return -1;
+    }
+    size_t count = cursor.remaining;
+    const char *data;
+    size_t len;
+    for (size_t i = 0; i < count; ++i) {
+        if (!next_qr_field(cursor, data, len)) {
+            return -1;
+        }
+        offsets[i] = static_cast<size_t>(data - message);
+        lens[i] = len;
+    }
+    return reinterpret_cast<const char*>(cursor.pos) == message + message_len ? static_cast<long>(count) : -1;
+}
+
+long mldsa_qr_payload_encode(const char *cert_buf, size_t cert_len, const char *message_buf, size_t message_len,
+                             const unsigned char *signature_buf, size_t signature_len,
+                             unsigned char *out, size_t out_size) {
+    if (!cert_buf || (message_len > 0 && !message_buf) || !signature_buf || signature_len == 0) {
+        return -1;
+    }
+    size_t total = 3 + mldsa_qr_fingerprint_size + varint_size(message_len) + message_len +
+                   varint_size(signature_len) + signature_len;
+    if (!out || total > out_size) {
+        return -1;
+    }
+    if (!certificate_fingerprint(cert_buf, cert_len, out + 3)) {
+        return -1;
+    }
+    memcpy(out, payload_magic, sizeof(payload_magic));
+    out[2] = mldsa_qr_payload_version;
+    unsigned char *pos = put_varint(out + 3 + mldsa_qr_fingerprint_size, message_len);
+    if (message_len > 0) {
+        memcpy(pos, message_buf, message_len);
+    }
+    pos = put_varint(pos + message_len, signature_len);
+    memcpy(pos, signature_buf, signature_len);
+    return static_cast<long>(total);
+}
+
+int mldsa_qr_payload_parse(const unsigned char *payload, size_t payload_len, size_t *spans_out, unsigned char *fingerprint_out) {
+    qr_payload_view view;
+    if (!spans_out || !parse_qr_payload(payload, payload_len, view)) {
+        return -1;
+    }
+    spans_out[0] = static_cast<size_t>(reinterpret_cast<const unsigned char*>(view.message) - payload);
+    spans_out[1] = view.message_len;
+    spans_out[2] = static_cast<size_t>(view.signature - payload);
+    spans_out[3] = view.signature_len;
+    if (fingerprint_out) {
+        memcpy(fingerprint_out, view.fingerprint, mldsa_qr_fingerprint_size);
+    }
+    return view.version;
+}
+
+int mldsa_qr_payload_verify(const unsigned char *payload, size_t payload_len, const char *cert_buf, size_t cert_len) {
+    qr_payload_view view;
+    if (!cert_buf || !parse_qr_payload(payload, payload_len, view)) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "malformed QR payload");
+        return -1;
+    }
+    unsigned char fingerprint[mldsa_qr_fingerprint_size];
+    if (!certificate_fingerprint(cert_buf, cert_len, fingerprint)) {
+        return -1;
+    }
+    // A payload signed under another certificate is a plain mismatch, not a bad signature.
+    if (CRYPTO_memcmp(fingerprint, view.fingerprint, sizeof(fingerprint)) != 0) {
+        record_error(MLDSA_ERR_CERT_CHAIN, 0, "QR payload certificate fingerprint mismatch");
+        return 0;
+    }
+    if (view.message_len > INT32_MAX) {
+        return 0;
+    }
+    // Message and signature are verified in place, straight out of the scanned bytes.
+    return verify_signature_with_cert(cert_buf, cert_len, view.signature, view.signature_len,
+                                      view.message, static_cast<int>(view.message_len)) ? 1 : 0;
+}
+
+long mldsa_qr_payload_split(const unsigned char *payload, size_t payload_len, size_t max_frame_size,
+                            unsigned char *out, size_t out_size, size_t *frame_lens, size_t max_frame_count) {
+    if (!payload || payload_len == 0 || max_frame_size <= frame_header_size || !frame_lens) {
+        return -1;
+    }
+    size_t chunk = max_frame_size - frame_header_size;
+    size_t count = (payload_len + chunk - 1) / chunk;
+    if (count > max_frames || count > max_frame_count || !out || payload_len + count * frame_header_size > out_size) {
+        return -1;
+    }
+    // Spread bytes evenly so the symbols come out the same QR version.
+    size_t base = payload_len / count;
+    size_t extra = payload_len % count;
+    unsigned char parity = 0;
+    for (size_t i = 0; i < payload_len; ++i) {
+        parity ^= payload[i];
+    }
+    unsigned char *pos = out;
+    const unsigned char *src = payload;
+    for (size_t i = 0; i < count; ++i) {
+        size_t len = base + (i < extra ? 1 : 0);
+        pos[0] = frame_magic[0];
+        pos[1] = frame_magic[1];
+        pos[2] = static_cast<unsigned char>((i << 4) | (count - 1));
+        pos[3] = parity;
+        memcpy(pos + frame_header_size, src, len);
+        frame_lens[i] = len + frame_header_size;
+        pos += frame_lens[i];
+        src += len;
+    }
+    return static_cast<long>(count);
+}
+
+long mldsa_qr_payload_join(const unsigned char **frames, const size_t *frame_lens, size_t frame_count,
+                           unsigned char *out, size_t out_size) {
+    if (!frames || !frame_lens || frame_count == 0 || frame_count > max_frames || !out) {
+        return -1;
+    }
+    // Frames may arrive in scan order; place each by its index.
+    size_t ordered[max_frames]; // frame index -> position in frames, frame_count when unseen
+    std::fill(ordered, ordered + max_frames, frame_count);
+    size_t total = 0;
+    unsigned char parity = 0;
+    for (size_t i = 0; i < frame_count; ++i) {
+        const unsigned char *frame = frames[i];
+        if (!frame || frame_lens[i] <= frame_header_size ||
+            frame[0] != frame_magic[0] || frame[1] != frame_magic[1]) {
+            return -1;
+        }
+        size_t index = frame[2] >> 4;
+        size_t count = (frame[2] & 0x0f) + 1u;
+        if (count != frame_count || index >= count || ordered[index] != frame_count ||
+            (i > 0 && frame[3] != frames[0][3])) {
+            return -1; // mixed sequences, duplicates or a missing frame
+        }
+        ordered[index] = i;
+        total += frame_lens[i] - frame_header_size;
+    }
+    if (total > out_size) {
+        return -1;
+    }
+    unsigned char *pos = out;
+    for (size_t index = 0; index < frame_count; ++index) {
+        size_t i = ordered[index];
+        size_t len = frame_lens[i] - frame_header_size;
+        memcpy(pos, frames[i] + frame_header_size, len);
+        for (size_t j = 0; j < len; ++j) {
+            parity ^= pos[j];
+        }
+        pos += len;
+    }
+    if (parity != frames[0][3]) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "QR structured append parity mismatch");
+        return -1;
+    }
+    return static_cast<long>(total);
+}
@@ -0,0 +1,393 @@
+#include "mldsa_lib.h"
+
+// src/revocation.cpp
+// In-memory revocation index consulted by the certificate verification paths.
+//
+// The index is built from signed CRLs: a sorted array of (issuer name hash, serial) keys
+// behind a blocked Bloom filter. Almost every lookup is for a certificate that is not
+// revoked, and those are answered by one 64-byte block of the filter; only filter hits
+// (revoked serials plus ~1% false positives) go on to the binary search.
+//
+// The index is immutable once published. Loading a CRL builds a new index (keeping the
+// entries of other issuers) and swaps the pointer in, RCU style: readers only bump a
+// reader counter for the current epoch, never take a lock and never wait. The writer
+// flips the epoch twice after the swap, waiting each time for the previous parity's
+// readers to leave, after which no reader can still hold the old index and it is freed.
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <openssl/asn1.h>
+#include <openssl/bn.h>
+#include <openssl/x509.h>
+
+using X509_CRL_ptr = ossl_unique_ptr<X509_CRL, X509_CRL_free>;
+
+namespace {
+
+constexpr int bloom_bits_per_entry = 10;
+constexpr int bloom_probes = 6;     // 9-bit offsets taken from one 64-bit hash
+constexpr int bloom_block_bits = 512;
+
+struct alignas(64) bloom_block {
+    uint64_t words[bloom_block_bits / 64];
+};
+
+struct revoked_entry {
+    unsigned long issuer_hash;
+    uint8_t serial_len;
+    unsigned char serial[sizeof(revocation_ref::serial)];
+};
+
+bool entry_less(const revoked_entry& a, const revoked_entry& b) {
+    if (a.issuer_hash != b.issuer_hash) return a.issuer_hash < b.issuer_hash;
+    if (a.serial_len != b.serial_len) return a.serial_len < b.serial_len;
+    return memcmp(a.serial, b.serial, a.serial_len) < 0;
+}
+
+struct issuer_crl {
+    unsigned long issuer_hash;
+    time_t this_update;
+};
+
+struct revocation_index {
+    std::vector<revoked_entry> entries; // sorted by entry_less
+    std::vector<bloom_block> bloom;
+    std::vector<issuer_crl> crls;       // one per issuer whose CRL is loaded
+};
+
+// FNV-1a over the key, then a murmur3 finalizer so low-entropy serials (1, 2, 3...) spread.
+uint64_t entry_hash(unsigned long issuer_hash, const unsigned char *serial, size_t serial_len) {
+    uint64_t h = 0xcbf29ce484222325ull ^ issuer_hash;
+    for (size_t i = 0; i < serial_len; ++i) {
+        h = (h ^ serial[i]) * 0x100000001b3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+size_t bloom_block_index(size_t block_count, uint64_t h) {
+    return static_cast<size_t>(((h >> 32) * block_count) >> 32);
+}
+
+void bloom_insert(std::vector<bloom_block>& bloom, uint64_t h) {
+    bloom_block& block = bloom[bloom_block_index(bloom.size(), h)];
+    for (int i = 0; i < bloom_probes; ++i) {
+        unsigned bit = static_cast<unsigned>(h >> (9 * i)) & (bloom_block_bits - 1);
+        block.words[bit / 64] |= 1ull << (bit % 64);
+    }
+}
+
+bool bloom_maybe_contains(const std::vector<bloom_block>& bloom, uint64_t h) {
+    const bloom_block& block = bloom[bloom_block_index(bloom.size(), h)];
+    for (int i = 0; i < bloom_probes; ++i) {
+        unsigned bit = static_cast<unsigned>(h >> (9 * i)) & (bloom_block_bits - 1);
+        if (!(block.words[bit / 64] & (1ull << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// --- RCU ---
+struct alignas(64) reader_count {
+    std::atomic<uint64_t> value{0};
+};
+
+std::atomic<revocation_index*> current_index{nullptr};
+std::atomic<uint64_t> epoch{0};
+reader_count readers[2];
+std::mutex writer_mutex; // serializes publishers; readers never touch it
+
+class rcu_read_guard {
+public:
+    rcu_read_guard() : parity_(epoch.load() & 1) { readers[parity_].value.fetch_add(1); }
+    ~rcu_read_guard() { readers[parity_].value.fetch_sub(1, std::memory_order_release); }
+    rcu_read_guard(const rcu_read_guard&) = delete;
+    rcu_read_guard& operator=(const rcu_read_guard&) = delete;
+
+private:
+    uint64_t parity_;
+};
+
+// Publishes next and frees the previous index once no reader can hold it. Caller holds writer_mutex.
+void publish_index(revocation_index *next) {
+    revocation_index *old = current_index.exchange(next);
+    if (!old) {
+        return;
+    }
+    for (int flip = 0; flip < 2; ++flip) {
+        uint64_t parity = epoch.fetch_add(1) & 1;
+        while (readers[parity].value.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+    delete old;
+}
+
+bool serial_to_bytes(const ASN1_INTEGER *serial, uint8_t& len, unsigned char *out) {
+    using BIGNUM_ptr = ossl_unique_ptr<BIGNUM, BN_free>;
+    BIGNUM_ptr bn(ASN1_INTEGER_to_BN(serial, nullptr), BN_free);
+    if (!bn) {
+        handle_openssl_error("ASN1_INTEGER_to_BN for revocation");
+        return false;
+    }
+    int n = BN_num_bytes(bn.get());
+    if (n <= 0 || n > static_cast<int>(sizeof(revocation_ref::serial))) {
+        return false; // zero or oversized serials are not indexable
+    }
+    len = static_cast<uint8_t>(BN_bn2bin(bn.get(), out));
+    return true;
+}
+
+unsigned long name_hash(const X509_NAME *name) {
+    int ok = 0;
+    unsigned long hash = X509_NAME_hash_ex(name, nullptr, nullptr, &ok);
+    return ok ? hash : 0;
+}
+
+X509_CRL_ptr read_crl(const char *buf, size_t len) {
+    stats_phase_timer parse_timer(stats_phase::parse);
+    std::vector<unsigned char> der;
+    const unsigned char *p;
+    if (is_der_encoded(buf, len)) {
+        p = reinterpret_cast<const unsigned char*>(buf);
+    } else {
+        der.resize(len / 4 * 3 + 3);
+        long der_len = mldsa_pem_dearmor(buf, len, "X509 CRL", der.data(), der.size());
+        if (der_len <= 0) {
+            record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "CRL is neither DER nor PEM");
+            return X509_CRL_ptr(nullptr, X509_CRL_free);
+        }
+        der.resize(static_cast<size_t>(der_len));
+        p = der.data();
+        len = der.size();
+    }
+    X509_CRL_ptr crl(d2i_X509_CRL(nullptr, &p, static_cast<long>(len)), X509_CRL_free);
+    if (!crl) {
+        handle_openssl_error("d2i_X509_CRL");
+    }
+    return crl;
+}
+
+time_t asn1_time_to_time_t(const ASN1_TIME *t) {
+    struct tm tm_value;
+    if (!t || ASN1_TIME_to_tm(t, &tm_value) != 1) {
+        return 0;
+    }
+    return timegm(&tm_value);
+}
+
+} // namespace
+
+bool make_revocation_ref(X509 *cert, revocation_ref& ref) {
+    ref.issuer_hash = name_hash(X509_get_issuer_name(cert));
+    ref.serial_len = 0;
+    return serial_to_bytes(X509_get0_serialNumber(cert), ref.serial_len, ref.serial);
+}
+
+bool is_revoked(const revocation_ref& ref) {
+    if (ref.serial_len == 0 || !current_index.load(std::memory_order_relaxed)) {
+        return false; // nothing loaded: no shared counters touched
+    }
+    rcu_read_guard guard;
+    const revocation_index *index = current_index.load();
+    if (!index || index->entries.empty()) {
+        return false;
+    }
+    if (!bloom_maybe_contains(index->bloom, entry_hash(ref.issuer_hash, ref.serial, ref.serial_len))) {
+        return false;
+    }
+    revoked_entry key{ref.issuer_hash, ref.serial_len, {}};
+    memcpy(key.serial, ref.serial, ref.serial_len);
+    return std::binary_search(index->entries.begin(), index->entries.end(), key, entry_less);
+}
+
+bool certificate_is_revoked(X509 *cert) {
+    revocation_ref ref;
+    return make_revocation_ref(cert, ref) && is_revoked(ref);
+}
+
+int mldsa_revocation_load_crl(const char *crl_buf, size_t crl_len, const char *ca_cert_buf, size_t ca_cert_len) {
+    X509_CRL_ptr crl = read_crl(crl_buf, crl_len);
+    if (!crl) {
+        return -1;
+    }
+    X509_ptr ca_cert = read_x509(ca_cert_buf, ca_cert_len);
+    if (!ca_cert) {
+        return -1;
+    }
+    if (X509_NAME_cmp(X509_CRL_get_issuer(crl.get()), X509_get_subject_name(ca_cert.get())) != 0) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "CRL issuer does not match CA");
+        return -1;
+    }
+    stats_phase_timer verify_timer(stats_phase::verify);
+    if (X509_CRL_verify(crl.get(), X509_get0_pubkey(ca_cert.get())) != 1) {
+        handle_openssl_error("X509_CRL_verify");
+        return -1;
+    }
+    verify_timer.stop();
+
+    unsigned long issuer_hash = name_hash(X509_CRL_get_issuer(crl.get()));
+    time_t this_update = asn1_time_to_time_t(X509_CRL_get0_lastUpdate(crl.get()));
+    auto next = std::make_unique<revocation_index>();
+    STACK_OF(X509_REVOKED) *revoked = X509_CRL_get_REVOKED(crl.get());
+    int revoked_count = revoked ? sk_X509_REVOKED_num(revoked) : 0;
+    next->entries.reserve(static_cast<size_t>(revoked_count));
+    for (int i = 0; i < revoked_count; ++i) {
+        revoked_entry entry{issuer_hash, 0, {}};
+        if (serial_to_bytes(X509_REVOKED_get0_serialNumber(sk_X509_REVOKED_value(revoked, i)), entry.serial_len, entry.serial)) {
+            next->entries.push_back(entry);
+        }
+    }
+    int loaded = static_cast<int>(next->entries.size());
+
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    // Only the writer replaces the index, so it can read the current one without the guard.
+    const revocation_index *current = current_index.load();
+    if (current) {
+        for (const issuer_crl& c : current->crls) {
+            if (c.issuer_hash == issuer_hash && this_update < c.this_update) {
+                record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "CRL older than the loaded one");
+                return -1;
+            }
+        }
+        // A CRL replaces its own issuer's entries and leaves the other issuers alone.
+        for (const revoked_entry& e : current->entries) {
+            if (e.issuer_hash != issuer_hash) next->entries.push_back(e);
+        }
+        for (const issuer_crl& c : current->crls) {
+            if (c.issuer_hash != issuer_hash) next->crls.push_back(c);
+        }
+    }
+    next->crls.push_back(issuer_crl{issuer_hash, this_update});
+
+    std::sort(next->entries.begin(), next->entries.end(), entry_less);
+    next->entries.erase(std::unique(next->entries.begin(), next->entries.end(),
+                                    [](const revoked_entry& a, const revoked_entry& b) {
+                                        return !entry_less(a, b) && !entry_less(b, a);
+                                    }),
+                        next->entries.end());
+    size_t block_count = (next->entries.size() * bloom_bits_per_entry + bloom_block_bits - 1) / bloom_block_bits;
+    next->bloom.assign(std::max<size_t>(1, block_count), bloom_block{});
+    for (const revoked_entry& e : next->entries) {
+        bloom_insert(next->bloom, entry_hash(e.issuer_hash, e.serial, e.serial_len));
+    }
+    publish_index(next.release());
+    return loaded;
+}
+
+int mldsa_revocation_check(const char *cert_buf, size_t cert_len) {
+    X509_ptr cert = read_x509(cert_buf, cert_len);
+    if (!cert) {
+        return -1;
+    }
+    return certificate_is_revoked(cert.get()) ? 1 : 0;
+}
+
+void mldsa_revocation_clear(void) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    publish_index(nullptr);
+}
+
+int sign_crl(
+    const char *ca_cert_buf,
+    size_t ca_cert_buf_len,
+    const char *ca_privkey_buf,
+    size_t ca_privkey_len,
+    const unsigned char **serials,
+    const size_t *serial_lens,
+    size_t serial_count,
+    int next_update_days,
+    bool der_output,
+    char *out_buf,
+    size_t out_buf_size
+) {
+    if (serial_count > 0 && (!serials || !serial_lens)) {
+        return 0;
+    }
+    X509_ptr ca_cert = read_x509(ca_cert_buf, ca_cert_buf_len);
+    if (!ca_cert) {
+        return 0;
+    }
+    stats_phase_timer import_timer(stats_phase::key_import);
+    EVP_PKEY_ptr ca_pkey(
+        EVP_PKEY_new_raw_private_key(EVP_PKEY_ML_DSA_65, nullptr, (const unsigned char*) ca_privkey_buf, ca_privkey_len),
+        EVP_PKEY_free);
+    if (!ca_pkey) {
+        handle_openssl_error("EVP_PKEY_new_raw_private_key");
+        return 0;
+    }
+    import_timer.stop();
+
+    X509_CRL_ptr crl(X509_CRL_new(), X509_CRL_free);
+    if (!crl || X509_CRL_set_version(crl.get(), 1) != 1 ||  // v2
+        X509_CRL_set_issuer_name(crl.get(), X509_get_subject_name(ca_cert.get())) != 1) {
+        handle_openssl_error("X509_CRL_new / set issuer");
+        return 0;
+    }
+    using ASN1_TIME_ptr = ossl_unique_ptr<ASN1_TIME, ASN1_TIME_free>;
+    time_t now = time(nullptr);
+    ASN1_TIME_ptr this_update(ASN1_TIME_set(nullptr, now), ASN1_TIME_free);
+    ASN1_TIME_ptr next_update(X509_time_adj_ex(nullptr, next_update_days, 0, &now), ASN1_TIME_free);
+    if (!this_update || !next_update ||
+        X509_CRL_set1_lastUpdate(crl.get(), this_update.get()) != 1 ||
+        X509_CRL_set1_nextUpdate(crl.get(), next_update.get()) != 1) {
+        handle_openssl_error("X509_CRL_set1_lastUpdate / nextUpdate");
+        return 0;
+    }
+
+    using BIGNUM_ptr = ossl_unique_ptr<BIGNUM, BN_free>;
+    for (size_t i = 0; i < serial_count; ++i) {
+        BIGNUM_ptr bn(BN_bin2bn(serials[i], static_cast<int>(serial_lens[i]), nullptr), BN_free);
+        X509_REVOKED *entry = X509_REVOKED_new();
+        ASN1_INTEGER *serial = bn ? BN_to_ASN1_INTEGER(bn.get(), nullptr) : nullptr;
+        bool ok = entry && serial &&
+                  X509_REVOKED_set_serialNumber(entry, serial) == 1 &&
+                  X509_REVOKED_set_revocationDate(entry, this_update.get()) == 1 &&
+                  X509_CRL_add0_revoked(crl.get(), entry) == 1;
+        ASN1_INTEGER_free(serial);
+        if (!ok) {
+            handle_openssl_error("X509_CRL_add0_revoked");
+            X509_REVOKED_free(entry);
+            return 0;
+        }
+    }
+    X509_CRL_sort(crl.get());
+
+    stats_phase_timer sign_timer(stats_phase::sign);
+    if (!X509_CRL_sign(crl.get(), ca_pkey.get(), nullptr)) {
+        handle_openssl_error("X509_CRL_sign");
+        return 0;
+    }
+    sign_timer.stop();
+
+    stats_phase_timer encode_timer(stats_phase::encode);
+    int der_len = i2d_X509_CRL(crl.get(), nullptr);
+    if (der_len <= 0) {
+        handle_openssl_error("i2d_X509_CRL");
+        return 0;
+    }
+    std::vector<unsigned char> encoded(static_cast<size_t>(der_len));
+    unsigned char *p = encoded.data();
+    if (i2d_X509_CRL(crl.get(), &p) != der_len) {
+        handle_openssl_error("i2d_X509_CRL");
+        return 0;
+    }
+    if (der_output) {
+        if (encoded.size() > out_buf_size) {
+            return 0;
+        }
+        memcpy(out_buf, encoded.data(), encoded.size());
+        return der_len;
+    }
+    long pem_len = mldsa_pem_armor("X509 CRL", encoded.data(), encoded.size(), out_buf, out_buf_size);
+    return pem_len > 0 ? static_cast<int>(pem_len) : 0;
+}
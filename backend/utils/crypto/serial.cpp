@@ -0,0 +1,239 @@
+#include "mldsa_lib.h"
+
+// src/serial.cpp
+// Unique certificate serial numbers without a database round-trip.
+//
+// A serial is 16 bytes, big-endian: a 15-bit node id, a 48-bit counter and 64 random
+// bits (the top bit stays clear so the INTEGER is positive). The counter is what makes
+// serials unique on one node; the node id keeps nodes apart and the random bits make
+// serials unguessable and keep a misconfigured node id from colliding in practice.
+//
+// Threads take counters from a private block, so the common case touches no shared state.
+// Refilling a block is one fetch_add on the global counter. Before any block beyond the
+// persisted high-water mark is handed out, the mark is moved a window ahead and written to
+// the state file (the only locked path, once per serial_persist_window serials), so after
+// a restart the counter resumes above everything that could have been issued.
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <openssl/asn1.h>
+#include <openssl/bn.h>
+#include <openssl/rand.h>
+
+namespace {
+
+constexpr size_t serial_size = 16;
+constexpr uint64_t serial_block_size = 1024;
+constexpr uint64_t serial_persist_window = 1024 * serial_block_size;
+constexpr uint64_t counter_mask = (1ull << 48) - 1;
+
+std::atomic<uint32_t> node_id{0};
+std::atomic<uint64_t> next_counter{0};
+// Counters below this are covered by the state file; UINT64_MAX when not persisting.
+std::atomic<uint64_t> persisted_limit{UINT64_MAX};
+// Bumped by mldsa_serial_init so threads drop blocks taken under the old state.
+std::atomic<uint64_t> generation{0};
+
+std::mutex persist_mutex;
+std::string state_path;
+
+struct counter_block {
+    uint64_t next = 0;
+    uint64_t end = 0;
+    uint64_t generation = UINT64_MAX;
+};
+
+thread_local counter_block thread_block;
+
+#ifndef __EMSCRIPTEN__
+// Makes a rename in the state file's directory durable; without it a power loss can
+// bring back the old file even though the new one was fsynced.
+bool sync_state_dir() {
+    size_t slash = state_path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : state_path.substr(0, slash);
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "open serial state directory");
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    if (!ok) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "fsync serial state directory");
+    }
+    close(fd);
+    return ok;
+}
+#endif
+
+// Replaces the state file atomically (write + fsync + rename + directory fsync).
+// Caller holds persist_mutex.
+bool write_high_water(uint64_t limit) {
+    std::string tmp_path = state_path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "open serial state");
+        return false;
+    }
+    char text[32];
+    int len = snprintf(text, sizeof(text), "%llu\n", (unsigned long long) limit);
+    bool ok = write(fd, text, len) == len;
+#ifndef __EMSCRIPTEN__
+    ok = ok && fsync(fd) == 0;
+#endif
+    if (!ok) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "write serial state");
+    }
+    close(fd);
+    if (ok && rename(tmp_path.c_str(), state_path.c_str()) != 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "rename serial state");
+        ok = false;
+    }
+#ifndef __EMSCRIPTEN__
+    ok = ok && sync_state_dir();
+#endif
+    return ok;
+}
+
+bool read_high_water(uint64_t& value) {
+    FILE *file = fopen(state_path.c_str(), "r");
+    if (!file) {
+        if (errno == ENOENT) {
+            value = 0; // first start on this node
+            return true;
+        }
+        record_error(MLDSA_ERR_FILE_IO, errno, "open serial state");
+        return false;
+    }
+    unsigned long long stored = 0;
+    bool ok = fscanf(file, "%llu", &stored) == 1;
+    fclose(file);
+    if (!ok) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "corrupt serial state");
+        return false;
+    }
+    value = stored;
+    return true;
+}
+
+// Makes sure counters below end are covered by the state file before they are used.
+bool ensure_persisted(uint64_t end) {
+    if (end <= persisted_limit.load(std::memory_order_acquire)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(persist_mutex);
+    uint64_t limit = persisted_limit.load(std::memory_order_relaxed);
+    if (end <= limit) {
+        return true; // another thread moved the mark while we waited
+    }
+    uint64_t new_limit = end + serial_persist_window;
+    if (!write_high_water(new_limit)) {
+        return false;
+    }
+    persisted_limit.store(new_limit, std::memory_order_release);
+    return true;
+}
+
+bool next_counter_value(uint64_t& value) {
+    counter_block& block = thread_block;
+    uint64_t current_generation = generation.load(std::memory_order_acquire);
+    if (block.generation != current_generation || block.next == block.end) {
+        uint64_t start = next_counter.fetch_add(serial_block_size, std::memory_order_relaxed);
+        if (!ensure_persisted(start + serial_block_size)) {
+            return false;
+        }
+        block.next = start;
+        block.end = start + serial_block_size;
+        block.generation = current_generation;
+    }
+    value = block.next++;
+    return true;
+}
+
+} // namespace
+
+bool mldsa_serial_init(uint32_t node, const char *path) {
+    if (node > 0x7fff) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, node, "serial node id exceeds 15 bits");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(persist_mutex);
+    uint64_t start = 0;
+    uint64_t limit = UINT64_MAX;
+    if (path && *path) {
+        state_path = path;
+        // Everything up to the stored mark may have been issued before the restart.
+        if (!read_high_water(start)) {
+            return false;
+        }
+        limit = start + serial_persist_window;
+        if (!write_high_water(limit)) {
+            return false;
+        }
+    } else {
+        state_path.clear();
+    }
+    node_id.store(node, std::memory_order_relaxed);
+    next_counter.store(start, std::memory_order_relaxed);
+    persisted_limit.store(limit, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    return true;
+}
+
+int mldsa_serial_next(unsigned char *out, size_t out_size) {
+    if (!out || out_size < serial_size) {
+        return 0;
+    }
+    uint64_t counter;
+    if (!next_counter_value(counter)) {
+        return 0;
+    }
+    counter &= counter_mask;
+    uint32_t node = node_id.load(std::memory_order_relaxed);
+    out[0] = static_cast<unsigned char>((node >> 8) & 0x7f);
+    out[1] = static_cast<unsigned char>(node);
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<unsigned char>(counter >> (40 - 8 * i));
+    }
+    if (RAND_bytes(out + 8, 8) != 1) {
+        handle_openssl_error("RAND_bytes for serial");
+        return 0;
+    }
+    return static_cast<int>(serial_size);
+}
+
+bool assign_certificate_serial(X509 *cert) {
+    unsigned char serial[serial_size];
+    if (!mldsa_serial_next(serial, sizeof(serial))) {
+        return false;
+    }
+    using BIGNUM_ptr = ossl_unique_ptr<BIGNUM, BN_free>;
+    BIGNUM_ptr bn(BN_bin2bn(serial, sizeof(serial), nullptr), BN_free);
+    if (!bn || !BN_to_ASN1_INTEGER(bn.get(), X509_get_serialNumber(cert))) {
+        handle_openssl_error("BN_to_ASN1_INTEGER for serial");
+        return false;
+    }
+    return true;
+}
+
+int mldsa_certificate_serial(const char *cert_buf, size_t cert_len, unsigned char *out, size_t out_size) {
+    X509_ptr cert = read_x509(cert_buf, cert_len);
+    if (!cert) {
+        return -1;
+    }
+    using BIGNUM_ptr = ossl_unique_ptr<BIGNUM, BN_free>;
+    BIGNUM_ptr bn(ASN1_INTEGER_to_BN(X509_get0_serialNumber(cert.get()), nullptr), BN_free);
+    if (!bn) {
+        handle_openssl_error("ASN1_INTEGER_to_BN");
+        return -1;
+    }
+    int len = BN_num_bytes(bn.get());
+    if (!out || static_cast<size_t>(len) > out_size) {
+        return -1;
+    }
+    return BN_bn2bin(bn.get(), out);
+}
@@ -0,0 +1,612 @@
+#include "mldsa_lib.h"
+
+// src/signature_store.cpp
+// Append-only signature store: records live in memory-mapped segment files, found through
+// an in-memory hash index by key (the signature UUID).
+//
+// A directory holds seg-NNNNNN.log files, each pre-sized to the segment size and mapped
+// MAP_SHARED. Puts append one record to the newest (active) segment; a full segment is
+// synced, sealed and never written again. Reads copy straight out of the mapping under a
+// shared lock, so fetching a signature costs one hash lookup and one memcpy.
+//
+// Record layout (host byte order, the store is local to one node), 8-byte aligned:
+//   record_header, key, message, signature, zero padding
+// The checksum covers everything after it up to the end of the signature, so a record torn
+// by a crash is detected on open; recovery replays segments oldest first, stops each scan
+// at the first invalid record and truncates the active segment's tail there.
+//
+// Durability: mldsa_sig_store_put(..., durable = true) returns once the record is synced.
+// Concurrent durable puts share one msync (group commit): the first waiter syncs everything
+// written so far and wakes the rest. Non-durable puts reach disk on the next sync.
+//
+// Deletes append a tombstone. mldsa_sig_store_compact copies the live records of mostly-dead
+// sealed segments into the active segment and removes the old files. A tombstone is copied
+// forward only while its key is still deleted (a later put already supersedes it on replay)
+// and its segment is not the oldest, where nothing older is left for it to hide.
+// Segments are reference counted, so a reader or sync still holding a compacted segment keeps
+// it mapped. Creating and removing segment files also syncs the directory, so a crash cannot
+// lose a new segment that already holds durable records.
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t record_magic = 0x31524753; // "SGR1"
+constexpr uint8_t record_put = 0;
+constexpr uint8_t record_delete = 1;
+constexpr size_t max_key_len = 1024;
+constexpr size_t default_segment_size = 64 * 1024 * 1024;
+constexpr size_t min_segment_size = 64 * 1024;
+
+struct record_header {
+    uint32_t magic;
+    uint32_t total_len; // header + payload + padding
+    uint64_t checksum;  // FNV-1a over the rest of the header and the payload
+    uint16_t key_len;
+    uint8_t kind;
+    uint8_t reserved;
+    uint32_t message_len;
+    uint32_t signature_len;
+    uint32_t reserved2;
+};
+static_assert(sizeof(record_header) == 32, "record header layout");
+constexpr size_t checksum_offset = offsetof(record_header, key_len);
+
+struct segment {
+    uint32_t id = 0;
+    std::string path;
+    int fd = -1;
+    unsigned char *base = nullptr;
+    size_t capacity = 0;
+    size_t end = 0;        // bytes of valid records
+    size_t synced_end = 0; // bytes known to be on disk
+    size_t live_bytes = 0; // bytes of records the index still points at
+
+    ~segment() {
+        if (base) munmap(base, capacity);
+        if (fd >= 0) close(fd);
+    }
+};
+using segment_ptr = std::shared_ptr<segment>;
+
+struct record_location {
+    uint32_t segment_id;
+    uint32_t total_len;
+    size_t offset;
+};
+
+struct store_state {
+    std::string dir;
+    size_t segment_size = default_segment_size;
+    std::map<uint32_t, segment_ptr> segments; // by id, oldest first
+    segment_ptr active;
+    std::unordered_map<std::string, record_location> index;
+    uint64_t written_seq = 0; // bumped by every append
+};
+
+std::shared_mutex store_mutex;
+store_state *store = nullptr;
+
+// Group commit; lock order is store_mutex before sync_mutex.
+std::mutex sync_mutex;
+std::condition_variable sync_cv;
+bool sync_running = false;
+uint64_t synced_seq = 0;
+
+uint64_t fnv1a(const unsigned char *data, size_t len, uint64_t hash = 0xcbf29ce484222325ull) {
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+size_t padded(size_t len) {
+    return (len + 7) & ~size_t(7);
+}
+
+std::string segment_path(const std::string& dir, uint32_t id) {
+    char name[32];
+    snprintf(name, sizeof(name), "/seg-%06u.log", id);
+    return dir + name;
+}
+
+// Makes file creations and removals in the store directory durable.
+bool sync_dir(const std::string& dir) {
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "open signature store directory");
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    if (!ok) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "fsync signature store directory");
+    }
+    close(fd);
+    return ok;
+}
+
+bool sync_range(segment& seg, size_t from, size_t to) {
+    if (to <= from) {
+        return true;
+    }
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = from & ~(page - 1);
+    if (msync(seg.base + start, to - start, MS_SYNC) != 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "msync signature segment");
+        return false;
+    }
+    return true;
+}
+
+// Validates the record at offset; returns its header, or false at the end of the valid data.
+bool read_record(const segment& seg, size_t offset, record_header& header) {
+    if (seg.capacity - offset < sizeof(record_header)) {
+        return false;
+    }
+    memcpy(&header, seg.base + offset, sizeof(header));
+    size_t payload = size_t(header.key_len) + header.message_len + header.signature_len;
+    if (header.magic != record_magic || header.kind > record_delete || header.total_len < sizeof(header) + payload ||
+        header.total_len != padded(sizeof(header) + payload) || header.total_len > seg.capacity - offset) {
+        return false;
+    }
+    const unsigned char *start = seg.base + offset + checksum_offset;
+    return fnv1a(start, sizeof(header) - checksum_offset + payload) == header.checksum;
+}
+
+segment_ptr map_segment(const std::string& path, uint32_t id, size_t create_size) {
+    int flags = O_RDWR | O_CLOEXEC | (create_size ? O_CREAT | O_EXCL : 0);
+    auto seg = std::make_shared<segment>();
+    seg->id = id;
+    seg->path = path;
+    seg->fd = open(path.c_str(), flags, 0600);
+    if (seg->fd < 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "open signature segment");
+        return nullptr;
+    }
+    if (create_size && ftruncate(seg->fd, static_cast<off_t>(create_size)) != 0) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "size signature segment");
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(seg->fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(record_header))) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "stat signature segment");
+        return nullptr;
+    }
+    seg->capacity = static_cast<size_t>(st.st_size);
+    void *base = mmap(nullptr, seg->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, seg->fd, 0);
+    if (base == MAP_FAILED) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "mmap signature segment");
+        return nullptr;
+    }
+    seg->base = static_cast<unsigned char*>(base);
+    return seg;
+}
+
+// Must hold store_mutex exclusively.
+void apply_record(store_state& s, segment& seg, size_t offset, const record_header& header) {
+    std::string key(reinterpret_cast<const char*>(seg.base + offset + sizeof(header)), header.key_len);
+    auto it = s.index.find(key);
+    if (it != s.index.end()) {
+        auto old = s.segments.find(it->second.segment_id);
+        if (old != s.segments.end()) {
+            old->second->live_bytes -= it->second.total_len;
+        }
+        if (header.kind == record_delete) {
+            s.index.erase(it);
+        }
+    }
+    if (header.kind == record_put) {
+        s.index[key] = record_location{seg.id, header.total_len, offset};
+        seg.live_bytes += header.total_len;
+    }
+}
+
+// Must hold store_mutex exclusively. Seals the active segment (synced in full) and starts the next.
+bool roll_segment(store_state& s) {
+    uint32_t id = 0;
+    if (s.active) {
+        if (!sync_range(*s.active, s.active->synced_end, s.active->end)) {
+            return false;
+        }
+        s.active->synced_end = s.active->end;
+        id = s.active->id + 1;
+    }
+    segment_ptr seg = map_segment(segment_path(s.dir, id), id, s.segment_size);
+    if (!seg || !sync_dir(s.dir)) {
+        if (seg) unlink(seg->path.c_str());
+        return false;
+    }
+    s.segments[id] = seg;
+    s.active = seg;
+    return true;
+}
+
+// Must hold store_mutex exclusively. Appends one record; location_out receives where it went.
+bool append_record(store_state& s, uint8_t kind, const char *key, size_t key_len, const char *message, size_t message_len,
+                   const unsigned char *signature, size_t signature_len, record_location& location_out) {
+    size_t payload = key_len + message_len + signature_len;
+    size_t total = padded(sizeof(record_header) + payload);
+    if (total > UINT32_MAX || total > s.segment_size) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, total, "signature record larger than a segment");
+        return false;
+    }
+    if (s.active->capacity - s.active->end < total && !roll_segment(s)) {
+        return false;
+    }
+    segment& seg = *s.active;
+    unsigned char *out = seg.base + seg.end;
+    record_header header{};
+    header.magic = record_magic;
+    header.total_len = static_cast<uint32_t>(total);
+    header.key_len = static_cast<uint16_t>(key_len);
+    header.kind = kind;
+    header.message_len = static_cast<uint32_t>(message_len);
+    header.signature_len = static_cast<uint32_t>(signature_len);
+    unsigned char *pos = out + sizeof(header);
+    memcpy(pos, key, key_len);
+    if (message_len) memcpy(pos + key_len, message, message_len);
+    if (signature_len) memcpy(pos + key_len + message_len, signature, signature_len);
+    memset(pos + payload, 0, total - sizeof(header) - payload);
+    // The checksum covers header fields after it, so hash the header copy first, then the payload.
+    uint64_t hash = fnv1a(reinterpret_cast<const unsigned char*>(&header) + checksum_offset, sizeof(header) - checksum_offset);
+    header.checksum = fnv1a(pos, payload, hash);
+    memcpy(out, &header, sizeof(header));
+    location_out = record_location{seg.id, static_cast<uint32_t>(total), seg.end};
+    seg.end += total;
+    ++s.written_seq;
+    return true;
+}
+
+// Syncs everything appended up to seq, sharing the msync with concurrent callers.
+bool sync_through(uint64_t seq) {
+    std::unique_lock<std::mutex> lock(sync_mutex);
+    while (true) {
+        if (synced_seq >= seq) {
+            return true;
+        }
+        if (!sync_running) {
+            break;
+        }
+        sync_cv.wait(lock);
+    }
+    sync_running = true;
+    lock.unlock();
+
+    segment_ptr seg;
+    size_t from = 0, to = 0;
+    uint64_t target;
+    {
+        std::shared_lock<std::shared_mutex> store_lock(store_mutex);
+        if (!store) {
+            lock.lock();
+            sync_running = false;
+            sync_cv.notify_all();
+            return false;
+        }
+        // Sealed segments were synced when they were rolled; only the active tail is dirty.
+        seg = store->active;
+        target = store->written_seq;
+        from = seg->synced_end;
+        to = seg->end;
+    }
+    bool ok = sync_range(*seg, from, to);
+    if (ok) {
+        std::unique_lock<std::shared_mutex> store_lock(store_mutex);
+        seg->synced_end = std::max(seg->synced_end, to);
+    }
+
+    lock.lock();
+    sync_running = false;
+    if (ok) {
+        synced_seq = std::max(synced_seq, target);
+    }
+    sync_cv.notify_all();
+    return ok;
+}
+
+bool load_segments(store_state& s) {
+    DIR *dir = opendir(s.dir.c_str());
+    if (!dir) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "open signature store directory");
+        return false;
+    }
+    std::vector<uint32_t> ids;
+    while (dirent *entry = readdir(dir)) {
+        unsigned id;
+        int consumed = 0;
+        if (sscanf(entry->d_name, "seg-%u.log%n", &id, &consumed) == 1 &&
+            static_cast<size_t>(consumed) == strlen(entry->d_name)) {
+            ids.push_back(id);
+        }
+    }
+    closedir(dir);
+    std::sort(ids.begin(), ids.end());
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        segment_ptr seg = map_segment(segment_path(s.dir, ids[i]), ids[i], 0);
+        if (!seg) {
+            return false;
+        }
+        s.segments[seg->id] = seg;
+        record_header header;
+        while (read_record(*seg, seg->end, header)) {
+            apply_record(s, *seg, seg->end, header);
+            seg->end += header.total_len;
+        }
+        seg->synced_end = seg->end;
+        if (i + 1 == ids.size()) {
+            // Drop whatever a crash left past the last valid record before appending over it.
+            size_t capacity = seg->capacity;
+            munmap(seg->base, seg->capacity);
+            seg->base = nullptr;
+            if (ftruncate(seg->fd, static_cast<off_t>(seg->end)) != 0 ||
+                ftruncate(seg->fd, static_cast<off_t>(capacity)) != 0) {
+                record_error(MLDSA_ERR_FILE_IO, errno, "truncate signature segment");
+                return false;
+            }
+            void *base = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, seg->fd, 0);
+            if (base == MAP_FAILED) {
+                record_error(MLDSA_ERR_FILE_IO, errno, "mmap signature segment");
+                return false;
+            }
+            seg->base = static_cast<unsigned char*>(base);
+            s.active = seg;
+        }
+    }
+    return s.active || roll_segment(s);
+}
+
+} // namespace
+
+bool mldsa_sig_store_open(const char *dir, size_t segment_size) {
+    if (!dir || !*dir || (segment_size && segment_size < min_segment_size)) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, segment_size, "mldsa_sig_store_open");
+        return false;
+    }
+    mldsa_sig_store_close();
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) {
+        record_error(MLDSA_ERR_FILE_IO, errno, "create signature store directory");
+        return false;
+    }
+    auto state = std::make_unique<store_state>();
+    state->dir = dir;
+    state->segment_size = segment_size ? padded(segment_size) : default_segment_size;
+    if (!load_segments(*state)) {
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> lock(store_mutex);
+    store = state.release();
+    std::lock_guard<std::mutex> sync_lock(sync_mutex);
+    synced_seq = 0;
+    return true;
+}
+
+void mldsa_sig_store_close(void) {
+    {
+        std::shared_lock<std::shared_mutex> lock(store_mutex);
+        if (!store) {
+            return;
+        }
+    }
+    mldsa_sig_store_sync();
+    std::unique_lock<std::shared_mutex> lock(store_mutex);
+    // Segments still referenced by an in-flight sync stay mapped until it finishes.
+    delete store;
+    store = nullptr;
+}
+
+bool mldsa_sig_store_put(const char *key, size_t key_len, const char *message, size_t message_len,
+                         const unsigned char *signature, size_t signature_len, bool durable) {
+    if (!key || key_len == 0 || key_len > max_key_len || (message_len && !message) || !signature || signature_len == 0 ||
+        message_len > UINT32_MAX || signature_len > UINT32_MAX) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, key_len, "mldsa_sig_store_put");
+        return false;
+    }
+    uint64_t seq;
+    {
+        std::unique_lock<std::shared_mutex> lock(store_mutex);
+        if (!store) {
+            record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "signature store is not open");
+            return false;
+        }
+        record_location location;
+        if (!append_record(*store, record_put, key, key_len, message, message_len, signature, signature_len, location)) {
+            return false;
+        }
+        segment& seg = *store->active;
+        record_header header;
+        memcpy(&header, seg.base + location.offset, sizeof(header));
+        apply_record(*store, seg, location.offset, header);
+        seq = store->written_seq;
+    }
+    return !durable || sync_through(seq);
+}
+
+int mldsa_sig_store_get(const char *key, size_t key_len, char *message_out, size_t message_out_size, size_t *message_len,
+                        unsigned char *signature_out, size_t signature_out_size, size_t *signature_len) {
+    if (!key || key_len == 0) {
+        return 0;
+    }
+    std::shared_lock<std::shared_mutex> lock(store_mutex);
+    if (!store) {
+        return 0;
+    }
+    auto it = store->index.find(std::string(key, key_len));
+    if (it == store->index.end()) {
+        return 0;
+    }
+    const segment& seg = *store->segments.at(it->second.segment_id);
+    const unsigned char *record = seg.base + it->second.offset;
+    record_header header;
+    memcpy(&header, record, sizeof(header));
+    if (message_len) *message_len = header.message_len;
+    if (signature_len) *signature_len = header.signature_len;
+    if ((header.message_len && (!message_out || message_out_size < header.message_len)) ||
+        !signature_out || signature_out_size < header.signature_len) {
+        return -1;
+    }
+    const unsigned char *payload = record + sizeof(header) + header.key_len;
+    if (header.message_len) memcpy(message_out, payload, header.message_len);
+    memcpy(signature_out, payload + header.message_len, header.signature_len);
+    return 1;
+}
+
+int mldsa_sig_store_verify_with_cert(const char *key, size_t key_len, const char *cert_buf, size_t cert_len) {
+    if (!key || key_len == 0 || !cert_buf) {
+        return -1;
+    }
+    segment_ptr seg;
+    size_t offset;
+    {
+        std::shared_lock<std::shared_mutex> lock(store_mutex);
+        if (!store) {
+            return -1;
+        }
+        auto it = store->index.find(std::string(key, key_len));
+        if (it == store->index.end()) {
+            return -1;
+        }
+        seg = store->segments.at(it->second.segment_id);
+        offset = it->second.offset;
+    }
+    // Verified in place without the lock: records are never rewritten, and holding the segment
+    // keeps it mapped even if compaction removes it meanwhile, so puts are not held up.
+    const unsigned char *record = seg->base + offset;
+    record_header header;
+    memcpy(&header, record, sizeof(header));
+    const unsigned char *payload = record + sizeof(header) + header.key_len;
+    if (header.message_len > INT32_MAX) {
+        return 0;
+    }
+    return verify_signature_with_cert(cert_buf, cert_len, payload + header.message_len, header.signature_len,
+                                      reinterpret_cast<const char*>(payload), static_cast<int>(header.message_len)) ? 1 : 0;
+}
+
+bool mldsa_sig_store_delete(const char *key, size_t key_len) {
+    if (!key || key_len == 0 || key_len > max_key_len) {
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> lock(store_mutex);
+    if (!store || !store->index.count(std::string(key, key_len))) {
+        return false;
+    }
+    record_location location;
+    if (!append_record(*store, record_delete, key, key_len, nullptr, 0, nullptr, 0, location)) {
+        return false;
+    }
+    segment& seg = *store->active;
+    record_header header;
+    memcpy(&header, seg.base + location.offset, sizeof(header));
+    apply_record(*store, seg, location.offset, header);
+    return true;
+}
+
+bool mldsa_sig_store_sync(void) {
+    uint64_t seq;
+    {
+        std::shared_lock<std::shared_mutex> lock(store_mutex);
+        if (!store) {
+            return false;
+        }
+        seq = store->written_seq;
+    }
+    return sync_through(seq);
+}
+
+long mldsa_sig_store_compact(double max_live_ratio) {
+    std::vector<segment_ptr> victims;
+    {
+        std::shared_lock<std::shared_mutex> lock(store_mutex);
+        if (!store) {
+            return -1;
+        }
+        for (const auto& [id, seg] : store->segments) {
+            if (seg != store->active && seg->live_bytes <= max_live_ratio * seg->end) {
+                victims.push_back(seg);
+            }
+        }
+    }
+
+    long reclaimed = 0;
+    for (const segment_ptr& victim : victims) {
+        // Sealed segments are immutable, so the scan itself needs no lock; each copy re-checks the index.
+        record_header header;
+        for (size_t offset = 0; read_record(*victim, offset, header); offset += header.total_len) {
+            const char *key = reinterpret_cast<const char*>(victim->base + offset + sizeof(header));
+            const char *message = key + header.key_len;
+            const unsigned char *signature = reinterpret_cast<const unsigned char*>(message + header.message_len);
+            std::unique_lock<std::shared_mutex> lock(store_mutex);
+            if (!store) {
+                return -1;
+            }
+            record_location location;
+            if (header.kind == record_put) {
+                auto it = store->index.find(std::string(key, header.key_len));
+                if (it == store->index.end() || it->second.segment_id != victim->id || it->second.offset != offset) {
+                    continue; // overwritten or deleted since
+                }
+                if (!append_record(*store, record_put, key, header.key_len, message, header.message_len,
+                                   signature, header.signature_len, location)) {
+                    return -1;
+                }
+                victim->live_bytes -= it->second.total_len;
+                it->second = location;
+                store->segments.at(location.segment_id)->live_bytes += location.total_len;
+            } else if (store->segments.begin()->first != victim->id &&
+                       !store->index.count(std::string(key, header.key_len))) {
+                // Only while the key is still deleted: a key put again since is live in a later
+                // segment, and a tombstone copied past that put would delete it on the next open.
+                if (!append_record(*store, record_delete, key, header.key_len, nullptr, 0, nullptr, 0, location)) {
+                    return -1;
+                }
+            }
+        }
+        // The copies must be on disk before the only other copy is removed.
+        if (!mldsa_sig_store_sync()) {
+            return -1;
+        }
+        std::string dir;
+        {
+            std::unique_lock<std::shared_mutex> lock(store_mutex);
+            if (!store) {
+                return -1;
+            }
+            store->segments.erase(victim->id);
+            if (unlink(victim->path.c_str()) != 0) {
+                record_error(MLDSA_ERR_FILE_IO, errno, "remove compacted signature segment");
+            }
+            dir = store->dir;
+        }
+        sync_dir(dir);
+        ++reclaimed;
+    }
+    return reclaimed;
+}
+
+void mldsa_sig_store_stats(uint64_t *records, uint64_t *segments, uint64_t *bytes, uint64_t *dead_bytes) {
+    std::shared_lock<std::shared_mutex> lock(store_mutex);
+    uint64_t used = 0, live = 0;
+    if (store) {
+        for (const auto& [id, seg] : store->segments) {
+            used += seg->end;
+            live += seg->live_bytes;
+        }
+    }
+    if (records) *records = store ? store->index.size() : 0;
+    if (segments) *segments = store ? store->segments.size() : 0;
+    if (bytes) *bytes = used;
+    if (dead_bytes) *dead_bytes = used - live;
+}
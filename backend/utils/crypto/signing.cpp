@@ -9,6 +9,8 @@
 #include <vector>
 #include <memory>
 #include <iostream> // Added missing include
+#include <new>
+#include <openssl/core_names.h>
 
 // --- Helper: Unique pointers for OpenSSL types ---
 template<typename T, void (*Func)(T*)>
@@ -17,6 +19,7 @@ using ossl_unique_ptr = std::unique_ptr<T, decltype(Func)>;
 using EVP_PKEY_ptr = ossl_unique_ptr<EVP_PKEY, EVP_PKEY_free>;
 using EVP_MD_CTX_ptr = ossl_unique_ptr<EVP_MD_CTX, EVP_MD_CTX_free>;
 using EVP_PKEY_CTX_ptr = ossl_unique_ptr<EVP_PKEY_CTX, EVP_PKEY_CTX_free>;
+using EVP_SIGNATURE_ptr = ossl_unique_ptr<EVP_SIGNATURE, EVP_SIGNATURE_free>;
 
 // Forward declaration for helper from helpers.cpp (or include helpers.h if created)
 EVP_PKEY_ptr load_private_key(const std::string& key_path);
@@ -29,26 +32,22 @@ extern const int ml_dsa_65_private_key_size; // Defined in mldsa_lib.h
 extern const int ml_dsa_65_public_key_size; // Defined in mldsa_lib.h
 // --- Signing Implementations ---
 
-// Returns signature length on success, 0 on failure
-int sign_mldsa65(
-    const char *private_key,
+// Signs with an already imported key. Returns signature length on success, 0 on failure
+static int sign_with_pkey(
+    EVP_PKEY *pkey,
     const char *message,
     size_t message_len,
     unsigned char *signature_buf,
     size_t signature_buf_size
 ) {
-    EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_private_key_ex(NULL, "ML-DSA-65", NULL, (unsigned char*) private_key, ml_dsa_65_private_key_size), EVP_PKEY_free);
-    if (!pkey.get()) {
-        return 0;
-    }
-
     EVP_MD_CTX_ptr md_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
     if (!md_ctx) {
         handle_openssl_error("EVP_MD_CTX_new");
         return 0;
     }
 
-    if (EVP_DigestSignInit(md_ctx.get(), nullptr, nullptr, nullptr, pkey.get()) <= 0) {
+    stats_phase_timer sign_timer(stats_phase::sign);
+    if (EVP_DigestSignInit(md_ctx.get(), nullptr, nullptr, nullptr, pkey) <= 0) {
         handle_openssl_error("EVP_DigestSignInit");
         return 0;
     }
@@ -70,4 +69,262 @@ int sign_mldsa65(
     }
 
     return sig_len;
-}
\ No newline at end of file
+}
+
+// Returns signature length on success, 0 on failure
+int sign_mldsa65(
+    const char *private_key,
+    const char *message,
+    size_t message_len,
+    unsigned char *signature_buf,
+    size_t signature_buf_size
+) {
+    stats_call_timer call(stats_call::sign);
+    stats_phase_timer import_timer(stats_phase::key_import);
+    EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_private_key_ex(NULL, "ML-DSA-65", NULL, (unsigned char*) private_key, ml_dsa_65_private_key_size), EVP_PKEY_free);
+    import_timer.stop();
+    if (!pkey.get()) {
+        return 0;
+    }
+    return call.done(sign_with_pkey(pkey.get(), message, message_len, signature_buf, signature_buf_size));
+}
+
+// Returns signature length on success, 0 on failure
+int sign_mldsa65_with_handle(
+    mldsa_key_handle *handle,
+    const char *message,
+    size_t message_len,
+    unsigned char *signature_buf,
+    size_t signature_buf_size
+) {
+    stats_call_timer call(stats_call::sign_with_handle);
+    if (!handle || !handle->has_private) {
+        return 0;
+    }
+    return call.done(sign_with_pkey(handle->pkey.get(), message, message_len, signature_buf, signature_buf_size));
+}
+
+// --- Signing Contexts ---
+
+struct mldsa_sign_ctx {
+    EVP_PKEY_ptr pkey;
+    EVP_PKEY_CTX_ptr pctx;
+    EVP_SIGNATURE_ptr sig_alg;
+    bool ready;
+};
+
+mldsa_sign_ctx* new_mldsa65_sign_ctx(mldsa_key_handle *handle) {
+    if (!handle || !handle->has_private) {
+        return nullptr;
+    }
+    if (EVP_PKEY_up_ref(handle->pkey.get()) != 1) {
+        handle_openssl_error("EVP_PKEY_up_ref for signing context");
+        return nullptr;
+    }
+    EVP_PKEY_ptr pkey(handle->pkey.get(), EVP_PKEY_free);
+
+    EVP_SIGNATURE_ptr sig_alg(EVP_SIGNATURE_fetch(NULL, "ML-DSA-65", NULL), EVP_SIGNATURE_free);
+    if (!sig_alg) {
+        handle_openssl_error("EVP_SIGNATURE_fetch for signing context");
+        return nullptr;
+    }
+
+    EVP_PKEY_CTX_ptr pctx(EVP_PKEY_CTX_new_from_pkey(NULL, pkey.get(), NULL), EVP_PKEY_CTX_free);
+    if (!pctx) {
+        handle_openssl_error("EVP_PKEY_CTX_new_from_pkey for signing context");
+        return nullptr;
+    }
+
+    mldsa_sign_ctx *ctx = new (std::nothrow) mldsa_sign_ctx{std::move(pkey), std::move(pctx), std::move(sig_alg), false};
+    if (!ctx) {
+        return nullptr;
+    }
+    if (!reset_mldsa65_sign_ctx(ctx)) {
+        delete ctx;
+        return nullptr;
+    }
+    return ctx;
+}
+
+bool reset_mldsa65_sign_ctx(mldsa_sign_ctx *ctx) {
+    if (!ctx) {
+        return false;
+    }
+    ctx->ready = EVP_PKEY_sign_message_init(ctx->pctx.get(), ctx->sig_alg.get(), NULL) > 0;
+    if (!ctx->ready) {
+        handle_openssl_error("EVP_PKEY_sign_message_init");
+    }
+    return ctx->ready;
+}
+
+// Returns signature length on success, 0 on failure
+int sign_mldsa65_with_ctx(
+    mldsa_sign_ctx *ctx,
+    const char *message,
+    size_t message_len,
+    unsigned char *signature_buf,
+    size_t signature_buf_size
+) {
+    stats_call_timer call(stats_call::sign_with_ctx);
+    if (!ctx || signature_buf_size < (size_t) ml_dsa_65_signature_size) {
+        return 0;
+    }
+    if (!ctx->ready && !reset_mldsa65_sign_ctx(ctx)) {
+        return 0;
+    }
+
+    // ML-DSA-65 signatures have a fixed size, so no size probe is needed.
+    size_t sig_len = ml_dsa_65_signature_size;
+    stats_phase_timer sign_timer(stats_phase::sign);
+    if (EVP_PKEY_sign(ctx->pctx.get(), signature_buf, &sig_len, (const unsigned char*) message, message_len) <= 0) {
+        handle_openssl_error("EVP_PKEY_sign (signing context)");
+        // Force a re-init before the next message.
+        ctx->ready = false;
+        return 0;
+    }
+    sign_timer.stop();
+    return call.done(static_cast<int>(sig_len));
+}
+
+void free_mldsa65_sign_ctx(mldsa_sign_ctx *ctx) {
+    delete ctx;
+}
+
+// --- Streaming Signatures ---
+// ML-DSA signs mu = SHAKE256(tr || 0x00 || ctx_len || ctx || M) with tr = SHAKE256(pk, 64)
+// (FIPS 204, external mu). The stream hashes M as it arrives and hands OpenSSL only the
+// 64-byte mu, so memory stays constant and the result is an ordinary ML-DSA-65 signature
+// over M with an empty context: verify_mldsa65 and friends accept it unchanged.
+
+constexpr size_t mldsa_tr_size = 64;
+constexpr size_t mldsa_mu_size = 64;
+
+struct mldsa_sign_stream {
+    EVP_PKEY_ptr pkey;
+    EVP_MD_CTX_ptr shake;
+    EVP_SIGNATURE_ptr sig_alg;
+    unsigned char tr[mldsa_tr_size];
+    bool ready;
+};
+
+// Starts mu = SHAKE256(tr || 0x00 || 0x00 || ...): pure ML-DSA with an empty context string.
+static bool start_mu(mldsa_sign_stream *stream) {
+    static const unsigned char pure_empty_context[2] = {0x00, 0x00};
+    if (EVP_DigestInit_ex(stream->shake.get(), EVP_shake256(), nullptr) <= 0 ||
+        EVP_DigestUpdate(stream->shake.get(), stream->tr, sizeof(stream->tr)) <= 0 ||
+        EVP_DigestUpdate(stream->shake.get(), pure_empty_context, sizeof(pure_empty_context)) <= 0) {
+        handle_openssl_error("SHAKE256 init for mu");
+        stream->ready = false;
+        return false;
+    }
+    stream->ready = true;
+    return true;
+}
+
+mldsa_sign_stream* new_mldsa65_sign_stream(mldsa_key_handle *handle) {
+    if (!handle || !handle->has_private) {
+        return nullptr;
+    }
+    // The private key carries its public key, which is all tr needs.
+    unsigned char public_key[ml_dsa_65_public_key_size];
+    size_t public_key_len = sizeof(public_key);
+    if (EVP_PKEY_get_raw_public_key(handle->pkey.get(), public_key, &public_key_len) != 1) {
+        handle_openssl_error("EVP_PKEY_get_raw_public_key for sign stream");
+        return nullptr;
+    }
+
+    EVP_SIGNATURE_ptr sig_alg(EVP_SIGNATURE_fetch(NULL, "ML-DSA-65", NULL), EVP_SIGNATURE_free);
+    EVP_MD_CTX_ptr shake(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    if (!sig_alg || !shake) {
+        handle_openssl_error("EVP_SIGNATURE_fetch / EVP_MD_CTX_new for sign stream");
+        return nullptr;
+    }
+    if (EVP_PKEY_up_ref(handle->pkey.get()) != 1) {
+        handle_openssl_error("EVP_PKEY_up_ref for sign stream");
+        return nullptr;
+    }
+    EVP_PKEY_ptr pkey(handle->pkey.get(), EVP_PKEY_free);
+
+    mldsa_sign_stream *stream = new (std::nothrow) mldsa_sign_stream{std::move(pkey), std::move(shake), std::move(sig_alg), {}, false};
+    if (!stream) {
+        return nullptr;
+    }
+    // tr = SHAKE256(pk) squeezed to 64 bytes, computed once per stream.
+    EVP_MD_CTX_ptr tr_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    if (!tr_ctx ||
+        EVP_DigestInit_ex(tr_ctx.get(), EVP_shake256(), nullptr) <= 0 ||
+        EVP_DigestUpdate(tr_ctx.get(), public_key, public_key_len) <= 0 ||
+        EVP_DigestFinalXOF(tr_ctx.get(), stream->tr, sizeof(stream->tr)) <= 0 ||
+        !start_mu(stream)) {
+        handle_openssl_error("SHAKE256 for tr");
+        delete stream;
+        return nullptr;
+    }
+    return stream;
+}
+
+bool update_mldsa65_sign_stream(mldsa_sign_stream *stream, const char *chunk, size_t chunk_len) {
+    if (!stream || !stream->ready) {
+        return false;
+    }
+    if (chunk_len == 0) {
+        return true;
+    }
+    if (EVP_DigestUpdate(stream->shake.get(), chunk, chunk_len) <= 0) {
+        handle_openssl_error("SHAKE256 update for mu");
+        stream->ready = false;
+        return false;
+    }
+    return true;
+}
+
+// Returns signature length on success, 0 on failure. The stream restarts for a new message either way.
+int final_mldsa65_sign_stream(
+    mldsa_sign_stream *stream,
+    unsigned char *signature_buf,
+    size_t signature_buf_size
+) {
+    stats_call_timer call(stats_call::sign_stream);
+    if (!stream || signature_buf_size < (size_t) ml_dsa_65_signature_size) {
+        return 0;
+    }
+    if (!stream->ready) {
+        start_mu(stream);
+        return 0;
+    }
+
+    unsigned char mu[mldsa_mu_size];
+    if (EVP_DigestFinalXOF(stream->shake.get(), mu, sizeof(mu)) <= 0) {
+        handle_openssl_error("SHAKE256 final for mu");
+        start_mu(stream);
+        return 0;
+    }
+    start_mu(stream);
+
+    EVP_PKEY_CTX_ptr pctx(EVP_PKEY_CTX_new_from_pkey(NULL, stream->pkey.get(), NULL), EVP_PKEY_CTX_free);
+    if (!pctx) {
+        handle_openssl_error("EVP_PKEY_CTX_new_from_pkey for sign stream");
+        return 0;
+    }
+    int external_mu = 1;
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_int(OSSL_SIGNATURE_PARAM_MU, &external_mu),
+        OSSL_PARAM_construct_end()
+    };
+    if (EVP_PKEY_sign_message_init(pctx.get(), stream->sig_alg.get(), params) <= 0) {
+        handle_openssl_error("EVP_PKEY_sign_message_init (external mu)");
+        return 0;
+    }
+    size_t sig_len = ml_dsa_65_signature_size;
+    stats_phase_timer sign_timer(stats_phase::sign);
+    if (EVP_PKEY_sign(pctx.get(), signature_buf, &sig_len, mu, sizeof(mu)) <= 0) {
+        handle_openssl_error("EVP_PKEY_sign (external mu)");
+        return 0;
+    }
+    sign_timer.stop();
+    return call.done(static_cast<int>(sig_len));
+}
+
+void free_mldsa65_sign_stream(mldsa_sign_stream *stream) {
+    delete stream;
+}
@@ -0,0 +1,297 @@
+#include "mldsa_lib.h"
+
+// src/stats.cpp
+// Call counters and latency histograms for the exported functions and for the phases
+// inside them (parsing, key import, lattice work, encoding, output copies), so production
+// can tell PEM parsing from ML-DSA arithmetic without a profiler.
+//
+// Recording is a handful of relaxed atomic adds: no locks, no allocation. Histograms are
+// log-linear over nanoseconds (HDR style): values below 8 ns are exact, above that each
+// power of two is split into 8 sub-buckets, so any reported value is within 12.5% of the
+// true one. Each histogram sits on its own cache lines to keep threads from false sharing.
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr int sub_bucket_bits = 3;
+constexpr int sub_buckets = 1 << sub_bucket_bits;
+// Highest tracked power of two (2^41 ns is about 37 minutes); longer values share the last bucket.
+constexpr int max_msb = 40;
+constexpr int bucket_count = (max_msb - sub_bucket_bits + 2) * sub_buckets;
+
+// Prometheus buckets: every power of two from ~1 us to ~17 s. They line up with the
+// sub-bucket boundaries, so the cumulative counts are exact.
+constexpr int prometheus_first_power = 10;
+constexpr int prometheus_last_power = 34;
+
+constexpr const char *phase_names[] = {
+    "parse", "key_import", "keygen", "sign", "verify", "encode", "output_copy"
+};
+constexpr const char *call_names[] = {
+    "generate_mldsa65_keypair",
+    "generate_csr",
+    "generate_self_signed_certificate",
+    "sign_certificate",
+    "sign_certificates_batch",
+    "sign_mldsa65",
+    "sign_mldsa65_with_handle",
+    "sign_mldsa65_with_ctx",
+    "sign_mldsa65_stream",
+    "verify_mldsa65",
+    "verify_mldsa65_with_handle",
+    "verify_signature_with_cert",
+    "verify_signature_batch",
+    "verify_certificate_issued_by_ca",
+    "mldsa_merkle_sign_batch",
+    "mldsa_merkle_verify",
+};
+static_assert(sizeof(phase_names) / sizeof(phase_names[0]) == static_cast<size_t>(stats_phase::count), "phase names");
+static_assert(sizeof(call_names) / sizeof(call_names[0]) == static_cast<size_t>(stats_call::count), "call names");
+
+int bucket_index(uint64_t ns) {
+    if (ns < sub_buckets) {
+        return static_cast<int>(ns);
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    if (msb > max_msb) {
+        return bucket_count - 1;
+    }
+    return (msb - sub_bucket_bits + 1) * sub_buckets +
+           static_cast<int>((ns >> (msb - sub_bucket_bits)) & (sub_buckets - 1));
+}
+
+// Exclusive upper bound of a bucket in nanoseconds.
+uint64_t bucket_upper_ns(int index) {
+    if (index < sub_buckets) {
+        return static_cast<uint64_t>(index) + 1;
+    }
+    int shift = index / sub_buckets - 1;
+    uint64_t lower = static_cast<uint64_t>(sub_buckets + index % sub_buckets) << shift;
+    return lower + (uint64_t(1) << shift);
+}
+
+struct alignas(64) latency_histogram {
+    std::atomic<uint64_t> buckets[bucket_count];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum_ns;
+    std::atomic<uint64_t> max_ns;
+
+    void record(uint64_t ns) {
+        buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t seen = max_ns.load(std::memory_order_relaxed);
+        while (ns > seen && !max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        sum_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct call_stats {
+    latency_histogram latency;
+    std::atomic<uint64_t> failures;
+};
+
+// Zero-initialized statics: usable before main and from any thread without setup.
+latency_histogram phase_stats[static_cast<int>(stats_phase::count)];
+call_stats function_stats[static_cast<int>(stats_call::count)];
+std::atomic<bool> stats_enabled{true};
+
+// Point-in-time copy of one histogram. Counters are read individually, so a snapshot
+// taken under load may be off by the few calls in flight.
+struct histogram_snapshot {
+    uint64_t buckets[bucket_count];
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+
+    explicit histogram_snapshot(const latency_histogram& h) {
+        for (int i = 0; i < bucket_count; ++i) {
+            buckets[i] = h.buckets[i].load(std::memory_order_relaxed);
+            count += buckets[i];
+        }
+        sum_ns = h.sum_ns.load(std::memory_order_relaxed);
+        max_ns = h.max_ns.load(std::memory_order_relaxed);
+    }
+
+    uint64_t percentile_ns(double p) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p * count + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return bucket_upper_ns(i) < max_ns ? bucket_upper_ns(i) : max_ns;
+            }
+        }
+        return max_ns;
+    }
+
+    // Values strictly below 2^power ns.
+    uint64_t count_below_power(int power) const {
+        int end = (power - sub_bucket_bits + 1) * sub_buckets;
+        uint64_t total = 0;
+        for (int i = 0; i < end && i < bucket_count; ++i) total += buckets[i];
+        return total;
+    }
+};
+
+void appendf(std::string& out, const char *fmt, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (len > 0) {
+        out.append(line, static_cast<size_t>(len) < sizeof(line) ? len : sizeof(line) - 1);
+    }
+}
+
+void append_json_histogram(std::string& out, const histogram_snapshot& h) {
+    appendf(out, "{\"count\":%llu,\"sum_ns\":%llu,\"max_ns\":%llu,\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"buckets\":[",
+            (unsigned long long) h.count, (unsigned long long) h.sum_ns, (unsigned long long) h.max_ns,
+            (unsigned long long) h.percentile_ns(0.50), (unsigned long long) h.percentile_ns(0.90),
+            (unsigned long long) h.percentile_ns(0.99));
+    // Only non-empty buckets, as [exclusive upper bound ns, count].
+    bool first = true;
+    for (int i = 0; i < bucket_count; ++i) {
+        if (h.buckets[i]) {
+            appendf(out, "%s[%llu,%llu]", first ? "" : ",",
+                    (unsigned long long) bucket_upper_ns(i), (unsigned long long) h.buckets[i]);
+            first = false;
+        }
+    }
+    out += "]}";
+}
+
+std::string export_json() {
+    std::string out;
+    appendf(out, "{\"enabled\":%s,\"functions\":{", stats_enabled.load(std::memory_order_relaxed) ? "true" : "false");
+    for (int i = 0; i < static_cast<int>(stats_call::count); ++i) {
+        const call_stats& c = function_stats[i];
+        histogram_snapshot h(c.latency);
+        appendf(out, "%s\"%s\":{\"calls\":%llu,\"failures\":%llu,\"latency\":", i ? "," : "", call_names[i],
+                (unsigned long long) h.count, (unsigned long long) c.failures.load(std::memory_order_relaxed));
+        append_json_histogram(out, h);
+        out += "}";
+    }
+    out += "},\"phases\":{";
+    for (int i = 0; i < static_cast<int>(stats_phase::count); ++i) {
+        appendf(out, "%s\"%s\":", i ? "," : "", phase_names[i]);
+        append_json_histogram(out, histogram_snapshot(phase_stats[i]));
+    }
+    out += "}}";
+    return out;
+}
+
+void append_prometheus_histogram(std::string& out, const char *metric, const char *label, const char *value,
+                                 const histogram_snapshot& h) {
+    for (int power = prometheus_first_power; power <= prometheus_last_power; ++power) {
+        appendf(out, "%s_bucket{%s=\"%s\",le=\"%.9g\"} %llu\n", metric, label, value,
+                static_cast<double>(uint64_t(1) << power) / 1e9, (unsigned long long) h.count_below_power(power));
+    }
+    appendf(out, "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", metric, label, value, (unsigned long long) h.count);
+    appendf(out, "%s_sum{%s=\"%s\"} %.9f\n", metric, label, value, h.sum_ns / 1e9);
+    appendf(out, "%s_count{%s=\"%s\"} %llu\n", metric, label, value, (unsigned long long) h.count);
+}
+
+std::string export_prometheus() {
+    std::string out;
+    out += "# HELP mldsa_calls_total Calls to exported ML-DSA library functions.\n"
+           "# TYPE mldsa_calls_total counter\n";
+    for (int i = 0; i < static_cast<int>(stats_call::count); ++i) {
+        appendf(out, "mldsa_calls_total{function=\"%s\"} %llu\n", call_names[i],
+                (unsigned long long) function_stats[i].latency.count.load(std::memory_order_relaxed));
+    }
+    out += "# HELP mldsa_call_failures_total Failed calls to exported ML-DSA library functions.\n"
+           "# TYPE mldsa_call_failures_total counter\n";
+    for (int i = 0; i < static_cast<int>(stats_call::count); ++i) {
+        appendf(out, "mldsa_call_failures_total{function=\"%s\"} %llu\n", call_names[i],
+                (unsigned long long) function_stats[i].failures.load(std::memory_order_relaxed));
+    }
+    out += "# HELP mldsa_call_duration_seconds Latency of exported ML-DSA library functions.\n"
+           "# TYPE mldsa_call_duration_seconds histogram\n";
+    for (int i = 0; i < static_cast<int>(stats_call::count); ++i) {
+        append_prometheus_histogram(out, "mldsa_call_duration_seconds", "function", call_names[i],
+                                    histogram_snapshot(function_stats[i].latency));
+    }
+    out += "# HELP mldsa_phase_duration_seconds Time spent in each phase inside the library.\n"
+           "# TYPE mldsa_phase_duration_seconds histogram\n";
+    for (int i = 0; i < static_cast<int>(stats_phase::count); ++i) {
+        append_prometheus_histogram(out, "mldsa_phase_duration_seconds", "phase", phase_names[i],
+                                    histogram_snapshot(phase_stats[i]));
+    }
+    return out;
+}
+
+} // namespace
+
+uint64_t stats_clock_ns() {
+    if (!stats_enabled.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    // Never 0, which the timers reserve for "not timing".
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()) | 1;
+}
+
+void stats_record_phase(stats_phase phase, uint64_t start_ns) {
+    uint64_t end_ns = stats_clock_ns();
+    if (end_ns) {
+        phase_stats[static_cast<int>(phase)].record(end_ns > start_ns ? end_ns - start_ns : 0);
+    }
+}
+
+void stats_record_call(stats_call call, uint64_t start_ns, bool ok) {
+    uint64_t end_ns = stats_clock_ns();
+    if (!end_ns) {
+        return;
+    }
+    call_stats& c = function_stats[static_cast<int>(call)];
+    c.latency.record(end_ns > start_ns ? end_ns - start_ns : 0);
+    if (!ok) {
+        c.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+long mldsa_stats_export(int format, char *out, size_t out_size) {
+    std::string text;
+    if (format == 0) {
+        text = export_json();
+    } else if (format == 1) {
+        text = export_prometheus();
+    } else {
+        return -1;
+    }
+    if (!out || text.size() + 1 > out_size) {
+        return -1;
+    }
+    memcpy(out, text.data(), text.size());
+    out[text.size()] = '\0';
+    return static_cast<long>(text.size());
+}
+
+void mldsa_stats_reset(void) {
+    for (auto& h : phase_stats) h.reset();
+    for (auto& c : function_stats) {
+        c.latency.reset();
+        c.failures.store(0, std::memory_order_relaxed);
+    }
+}
+
+void mldsa_set_stats_enabled(bool enabled) {
+    stats_enabled.store(enabled, std::memory_order_relaxed);
+}
@@ -0,0 +1,343 @@
+#include "mldsa_lib.h"
+
+// src/status_token.cpp
+// Cached, MAC-signed verification status for repeat QR scans.
+//
+// The first scan of a signature UUID runs the full ML-DSA (and optional CA chain)
+// verification and stores the outcome as a compact status token with a TTL. Later scans
+// of the same UUID are answered from the cache after re-hashing the presented content,
+// and a client that kept the token can have it checked with one HMAC and one hash of the
+// content presented with it, with no lookup and no verification.
+// Only verdicts are cached: a bad signature or a failed chain check is, but a call that failed
+// earlier (allocation, parsing) is answered without a usable token and verified again next time.
+//
+// Token layout (mldsa_status_token_size bytes, big-endian):
+//   [0]       version
+//   [1]       status (1 valid, 0 invalid)
+//   [2..9]    issued at (unix seconds)
+//   [10..17]  expires at (unix seconds)
+//   [18..33]  first 16 bytes of SHA-256(certificate, signature, message, CA certificate or none)
+//   [34..49]  HMAC-SHA256(key, uuid length, uuid, bytes 0..33), truncated to 16 bytes
+//
+// The MAC key is random per process unless mldsa_status_set_key installs a shared one
+// (needed when several backend nodes answer the same QR codes). A cache hit is also re-checked
+// against the revocation index, so a loaded CRL takes effect on the next status check before
+// the TTL runs out. A token already handed out is not: mldsa_status_token_check only checks
+// the MAC, the expiry and the content digest, so a token for a since-revoked certificate stays
+// valid until it expires.
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/x509_vfy.h>
+
+namespace {
+
+constexpr unsigned char token_version = 1;
+constexpr size_t digest_prefix_size = 16;
+constexpr size_t mac_size = 16;
+constexpr size_t signed_part_size = 34;
+constexpr size_t shard_count = 16;
+constexpr size_t default_status_cache_capacity = 4096;
+static_assert(signed_part_size + mac_size == mldsa_status_token_size, "token layout");
+
+struct status_entry {
+    std::string uuid;
+    unsigned char token[mldsa_status_token_size];
+    unsigned char content_digest[32];
+    uint64_t expires_at;
+    revocation_ref ref;
+};
+
+struct status_shard {
+    std::mutex mutex;
+    std::list<status_entry> lru; // front = most recently used
+    std::unordered_map<std::string, std::list<status_entry>::iterator> index;
+};
+
+status_shard shards[shard_count];
+std::atomic<size_t> shard_capacity{default_status_cache_capacity / shard_count};
+std::atomic<uint64_t> cache_hits{0};
+std::atomic<uint64_t> cache_misses{0};
+
+std::shared_mutex key_mutex;
+unsigned char mac_key[32];
+size_t mac_key_len = 0;
+
+uint64_t now_seconds() {
+    return static_cast<uint64_t>(time(nullptr));
+}
+
+void put_u64(unsigned char *out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out[i] = static_cast<unsigned char>(v >> (56 - 8 * i));
+}
+
+uint64_t get_u64(const unsigned char *in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | in[i];
+    return v;
+}
+
+status_shard& shard_for(const std::string& uuid) {
+    return shards[std::hash<std::string>{}(uuid) % shard_count];
+}
+
+bool ensure_key() {
+    {
+        std::shared_lock<std::shared_mutex> lock(key_mutex);
+        if (mac_key_len) return true;
+    }
+    std::unique_lock<std::shared_mutex> lock(key_mutex);
+    if (mac_key_len) return true;
+    if (RAND_bytes(mac_key, sizeof(mac_key)) != 1) {
+        handle_openssl_error("RAND_bytes for status token key");
+        return false;
+    }
+    mac_key_len = sizeof(mac_key);
+    return true;
+}
+
+bool token_mac(const char *uuid, size_t uuid_len, const unsigned char *signed_part, unsigned char *mac_out) {
+    if (!ensure_key()) {
+        return false;
+    }
+    unsigned char input[8 + 256 + signed_part_size];
+    if (uuid_len > 256) {
+        return false;
+    }
+    put_u64(input, uuid_len);
+    memcpy(input + 8, uuid, uuid_len);
+    memcpy(input + 8 + uuid_len, signed_part, signed_part_size);
+    unsigned char mac[EVP_MAX_MD_SIZE];
+    unsigned int mac_len = 0;
+    std::shared_lock<std::shared_mutex> lock(key_mutex);
+    if (!HMAC(EVP_sha256(), mac_key, static_cast<int>(mac_key_len), input, 8 + uuid_len + signed_part_size, mac, &mac_len)) {
+        handle_openssl_error("HMAC for status token");
+        return false;
+    }
+    memcpy(mac_out, mac, mac_size);
+    return true;
+}
+
+// Length-framed so (cert, signature, message, CA) boundaries cannot be shifted. The CA is part
+// of the content: a verdict cached without a chain check must not answer a call that asks for one.
+bool content_digest(const char *cert_buf, size_t cert_len, const unsigned char *signature_buf, size_t signature_len,
+                    const char *message_buf, size_t message_len, const char *ca_cert_buf, size_t ca_cert_len,
+                    unsigned char *digest_out) {
+    using EVP_MD_CTX_ptr = ossl_unique_ptr<EVP_MD_CTX, EVP_MD_CTX_free>;
+    EVP_MD_CTX_ptr ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    unsigned char lens[33];
+    put_u64(lens, cert_len);
+    put_u64(lens + 8, signature_len);
+    put_u64(lens + 16, message_len);
+    lens[24] = ca_cert_buf ? 1 : 0; // "no CA" differs from any CA, even an empty one
+    put_u64(lens + 25, ca_cert_buf ? ca_cert_len : 0);
+    unsigned int digest_len = 0;
+    if (!ctx || EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) != 1 ||
+        EVP_DigestUpdate(ctx.get(), lens, sizeof(lens)) != 1 ||
+        EVP_DigestUpdate(ctx.get(), cert_buf, cert_len) != 1 ||
+        EVP_DigestUpdate(ctx.get(), signature_buf, signature_len) != 1 ||
+        EVP_DigestUpdate(ctx.get(), message_buf, message_len) != 1 ||
+        (ca_cert_buf && EVP_DigestUpdate(ctx.get(), ca_cert_buf, ca_cert_len) != 1) ||
+        EVP_DigestFinal_ex(ctx.get(), digest_out, &digest_len) != 1) {
+        handle_openssl_error("EVP_Digest for status content");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int mldsa_verify_status_cached(
+    const char *uuid,
+    size_t uuid_len,
+    const char *cert_buf,
+    size_t cert_len,
+    const char *ca_cert_buf,
+    size_t ca_cert_len,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const char *message_buf,
+    size_t message_len,
+    unsigned ttl_seconds,
+    unsigned char *token_out,
+    size_t token_out_size
+) {
+    if (!uuid || uuid_len == 0 || uuid_len > 256 || !cert_buf || !signature_buf ||
+        (message_len > 0 && !message_buf) || !token_out || token_out_size < mldsa_status_token_size) {
+        return -1;
+    }
+    unsigned char digest[32];
+    if (!content_digest(cert_buf, cert_len, signature_buf, signature_len, message_buf, message_len,
+                        ca_cert_buf, ca_cert_len, digest)) {
+        return -1;
+    }
+    std::string key(uuid, uuid_len);
+    status_shard& shard = shard_for(key);
+    uint64_t now = now_seconds();
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            status_entry& entry = *it->second;
+            // A hit must be for the same content, still fresh, and not revoked since.
+            if (entry.expires_at > now && CRYPTO_memcmp(entry.content_digest, digest, sizeof(digest)) == 0 &&
+                !(entry.token[1] == 1 && is_revoked(entry.ref))) {
+                cache_hits.fetch_add(1, std::memory_order_relaxed);
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                memcpy(token_out, entry.token, mldsa_status_token_size);
+                return entry.token[1];
+            }
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+    }
+    cache_misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Full verification outside the lock; verify_signature_with_cert also applies the revocation index.
+    revocation_ref ref;
+    take_last_error(nullptr); // only errors from this verification count below
+    X509_ptr cert = read_x509(cert_buf, cert_len);
+    if (cert) {
+        make_revocation_ref(cert.get(), ref);
+    }
+    bool valid = cert && message_len <= INT32_MAX &&
+                 verify_signature_with_cert(cert_buf, cert_len, signature_buf, signature_len, message_buf,
+                                            static_cast<int>(message_len)) &&
+                 (!ca_cert_buf || verify_certificate_issued_by_ca(cert_buf, cert_len, ca_cert_buf, ca_cert_len));
+    // An invalid result is only a verdict if the signature or chain check itself said no. A failed
+    // allocation or parse answers this call with 0 and an expired token, and is not remembered.
+    unsigned long detail = 0;
+    int failure = valid ? 0 : take_last_error(&detail);
+    if (!valid && failure != MLDSA_ERR_INVALID_SIGNATURE &&
+        !(failure == MLDSA_ERR_CERT_CHAIN && detail != X509_V_ERR_OUT_OF_MEM)) {
+        ttl_seconds = 0;
+    }
+
+    status_entry entry;
+    entry.uuid = key;
+    entry.expires_at = now + ttl_seconds;
+    entry.ref = ref;
+    memcpy(entry.content_digest, digest, sizeof(digest));
+    entry.token[0] = token_version;
+    entry.token[1] = valid ? 1 : 0;
+    put_u64(entry.token + 2, now);
+    put_u64(entry.token + 10, entry.expires_at);
+    memcpy(entry.token + 18, digest, digest_prefix_size);
+    if (!token_mac(uuid, uuid_len, entry.token, entry.token + signed_part_size)) {
+        return -1;
+    }
+    memcpy(token_out, entry.token, mldsa_status_token_size);
+
+    size_t capacity = shard_capacity.load(std::memory_order_relaxed);
+    if (ttl_seconds > 0 && capacity > 0) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+        shard.lru.push_front(std::move(entry));
+        shard.index.emplace(key, shard.lru.begin());
+        while (shard.lru.size() > capacity) {
+            shard.index.erase(shard.lru.back().uuid);
+            shard.lru.pop_back();
+        }
+    }
+    return valid ? 1 : 0;
+}
+
+int mldsa_status_token_check(
+    const char *uuid,
+    size_t uuid_len,
+    const char *cert_buf,
+    size_t cert_len,
+    const char *ca_cert_buf,
+    size_t ca_cert_len,
+    const unsigned char *signature_buf,
+    size_t signature_len,
+    const char *message_buf,
+    size_t message_len,
+    const unsigned char *token,
+    size_t token_len
+) {
+    if (!uuid || uuid_len == 0 || uuid_len > 256 || !cert_buf || !signature_buf ||
+        (message_len > 0 && !message_buf) || !token || token_len != mldsa_status_token_size ||
+        token[0] != token_version || token[1] > 1) {
+        return -1;
+    }
+    unsigned char mac[mac_size];
+    if (!token_mac(uuid, uuid_len, token, mac) || CRYPTO_memcmp(mac, token + signed_part_size, mac_size) != 0) {
+        record_error(MLDSA_ERR_INVALID_SIGNATURE, 0, "status token MAC");
+        return -1;
+    }
+    if (get_u64(token + 10) <= now_seconds()) {
+        return -1; // expired: the caller re-verifies and gets a fresh token
+    }
+    // The MAC only proves what was verified for this UUID; the token must not vouch for other content.
+    unsigned char digest[32];
+    if (!content_digest(cert_buf, cert_len, signature_buf, signature_len, message_buf, message_len,
+                        ca_cert_buf, ca_cert_len, digest)) {
+        return -1;
+    }
+    if (CRYPTO_memcmp(digest, token + 18, digest_prefix_size) != 0) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "status token content");
+        return -1;
+    }
+    return token[1];
+}
+
+bool mldsa_status_set_key(const unsigned char *key, size_t key_len) {
+    if (!key || key_len < 16 || key_len > sizeof(mac_key)) {
+        return false;
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(key_mutex);
+        memcpy(mac_key, key, key_len);
+        mac_key_len = key_len;
+    }
+    // Cached tokens carry MACs under the old key.
+    mldsa_status_cache_clear();
+    return true;
+}
+
+void mldsa_status_cache_clear(void) {
+    for (status_shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+    }
+}
+
+void mldsa_set_status_cache_capacity(size_t capacity) {
+    size_t per_shard = (capacity + shard_count - 1) / shard_count;
+    shard_capacity.store(per_shard, std::memory_order_relaxed);
+    for (status_shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        while (shard.lru.size() > per_shard) {
+            shard.index.erase(shard.lru.back().uuid);
+            shard.lru.pop_back();
+        }
+    }
+}
+
+void mldsa_get_status_cache_stats(uint64_t *hits, uint64_t *misses, size_t *entries) {
+    if (hits) *hits = cache_hits.load(std::memory_order_relaxed);
+    if (misses) *misses = cache_misses.load(std::memory_order_relaxed);
+    if (entries) {
+        size_t total = 0;
+        for (status_shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.lru.size();
+        }
+        *entries = total;
+    }
+}
@@ -1,4 +1,5 @@
 import { expect } from 'chai';
+import fs from 'node:fs';
 import {MLDSAWrapper} from './MLDSAWrapper.js';
 
 describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
@@ -34,6 +35,20 @@ describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
       expect(publicKey).to.be.an.instanceof(Uint8Array);
       expect(publicKey).to.have.length(wrapper.ML_DSA_65_PUBLIC_KEY_SIZE);
     });
+
+    it('should serve distinct key pairs from the pre-generated pool', async function() {
+      wrapper.startKeyPairPool({ size: 2, threads: 1 });
+      try {
+        const first = await wrapper.generateKeyPair();
+        const second = await wrapper.generateKeyPair();
+        expect(first.privateKey).to.have.length(wrapper.ML_DSA_65_PRIVATE_KEY_SIZE);
+        expect(second.publicKey).to.have.length(wrapper.ML_DSA_65_PUBLIC_KEY_SIZE);
+        expect(wrapper._bytesToHex(first.publicKey)).to.not.equal(wrapper._bytesToHex(second.publicKey));
+      } finally {
+        wrapper.stopKeyPairPool();
+      }
+      expect(wrapper.getKeyPairPoolSize()).to.equal(0);
+    });
   });
 
   describe('Signing and Verification (sign, verify)', function() {
@@ -66,6 +81,82 @@ describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
       const isValid = await wrapper.verify(publicKey, invalidSignature, message);
       expect(isValid).to.be.false;
     });
+
+    it('should queue a structured error for an invalid signature instead of printing it', async function() {
+      wrapper.drainErrors();
+      const forged = await wrapper.sign(privateKey, 'a different message');
+      const handle = wrapper.loadPublicKey(publicKey);
+      try {
+        expect(await wrapper.verifyWithHandle(handle, forged, message)).to.be.false;
+      } finally {
+        wrapper.freeKeyHandle(handle);
+      }
+      const report = wrapper.drainErrors();
+      expect(report.errors.map(e => e.code)).to.include('invalid_signature');
+      expect(wrapper.drainErrors().errors).to.have.length(0);
+    });
+  });
+
+  describe('Key Handles (loadPrivateKey, signWithHandle, verifyWithHandle)', function() {
+    let privateKey, publicKey, privateHandle, publicHandle;
+    const message = 'Message signed repeatedly with one loaded key.';
+
+    before(async function() {
+      const keys = await wrapper.generateKeyPair();
+      privateKey = keys.privateKey;
+      publicKey = keys.publicKey;
+      privateHandle = wrapper.loadPrivateKey(privateKey);
+      publicHandle = wrapper.loadPublicKey(publicKey);
+    });
+
+    after(function() {
+      if (privateHandle) wrapper.freeKeyHandle(privateHandle);
+      if (publicHandle) wrapper.freeKeyHandle(publicHandle);
+    });
+
+    it('should sign with a handle and verify with the raw public key', async function() {
+      const signature = await wrapper.signWithHandle(privateHandle, message);
+      expect(signature).to.have.length(wrapper.ML_DSA_65_SIGNATURE_SIZE);
+      const isValid = await wrapper.verifyWithHandle(publicHandle, signature, message);
+      expect(isValid).to.be.true;
+    });
+
+    it('should reject a signature over a different message', async function() {
+      const signature = await wrapper.signWithHandle(privateHandle, message);
+      const isValid = await wrapper.verifyWithHandle(publicHandle, signature, message + '!');
+      expect(isValid).to.be.false;
+    });
+
+    it('should sign repeatedly with a reusable signing context', async function() {
+      const ctx = wrapper.createSignContext(privateHandle);
+      try {
+        for (let i = 0; i < 3; i++) {
+          const signature = await wrapper.signWithContext(ctx, message + i);
+          expect(signature).to.have.length(wrapper.ML_DSA_65_SIGNATURE_SIZE);
+          expect(await wrapper.verifyWithHandle(publicHandle, signature, message + i)).to.be.true;
+        }
+      } finally {
+        wrapper.freeSignContext(ctx);
+      }
+    });
+
+    it('should stream-sign a chunked document into an ordinary signature', async function() {
+      const document = new Uint8Array(200 * 1024).map((_, i) => i & 0xff);
+      const chunks = [document.subarray(0, 1000), document.subarray(1000, 150000), document.subarray(150000)];
+      const signature = await wrapper.signStream(privateHandle, chunks);
+      expect(signature).to.have.length(wrapper.ML_DSA_65_SIGNATURE_SIZE);
+      expect(await wrapper.verifyWithHandle(publicHandle, signature, document)).to.be.true;
+    });
+
+    it('should refuse to sign with a public key handle', async function() {
+      let error;
+      try {
+        await wrapper.signWithHandle(publicHandle, message);
+      } catch (e) {
+        error = e;
+      }
+      expect(error).to.be.an('error');
+    });
   });
 
   describe('CSR Generation (generateCSR)', function() {
@@ -138,6 +229,13 @@ describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
       expect(isValid).to.be.true;
     });
 
+    it('should accept DER certificates as well as PEM', async function() {
+      const toDer = (pem) => new Uint8Array(Buffer.from(
+        new TextDecoder().decode(pem).replace(/-----[^-]+-----/g, '').replace(/\s+/g, ''), 'base64'));
+      const isValid = await wrapper.verifyCertificateIssuedByCA(toDer(certData), toDer(caCertData));
+      expect(isValid).to.be.true;
+    });
+
     it('should return false if certificate is not issued by the given CA', async function() {
       // Generate another self-signed certificate (not issued by caCertData)
       const anotherKeys = await wrapper.generateKeyPair();
@@ -150,6 +248,20 @@ describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
       const isValid = await wrapper.verifyCertificateIssuedByCA(anotherCertData, caCertData);
       expect(isValid).to.be.false;
     });
+
+    it('should reject a certificate revoked by a loaded CRL', async function() {
+      const revokedCert = await wrapper.signCertificate(caPrivateKey, certCsrData, caCertData);
+      const crl = wrapper.signCRL(caPrivateKey, caCertData, [wrapper.getCertificateSerial(revokedCert)]);
+      try {
+        expect(wrapper.loadCRL(crl, caCertData)).to.equal(1);
+        expect(wrapper.isRevoked(revokedCert)).to.be.true;
+        expect(await wrapper.verifyCertificateIssuedByCA(revokedCert, caCertData)).to.be.false;
+        expect(await wrapper.verifyCertificateIssuedByCA(certData, caCertData)).to.be.true;
+      } finally {
+        wrapper.clearRevocations();
+      }
+      expect(await wrapper.verifyCertificateIssuedByCA(revokedCert, caCertData)).to.be.true;
+    });
   });
 
   describe('Signature Verification with Certificate (verifyWithCertificate)', function() {
@@ -179,6 +291,162 @@ describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
       const isValid = await wrapper.verifyWithCertificate(certData, new TextEncoder().encode(message), invalidSignature);
       expect(isValid).to.be.false;
     });
+
+    it('should answer a repeat status check from the cache with a checkable token', async function() {
+      const signature = await wrapper.sign(privateKey, message);
+      const uuid = '5f0c6a1e-status-cache-test';
+      wrapper.clearStatusCache();
+
+      const first = wrapper.verifyStatusCached(uuid, certData, signature, message);
+      const second = wrapper.verifyStatusCached(uuid, certData, signature, message);
+      expect(first.valid).to.be.true;
+      expect(second.token).to.equal(first.token);
+      expect(wrapper.checkStatusToken(uuid, first.token, certData, signature, message)).to.be.true;
+      expect(wrapper.checkStatusToken('another-uuid', first.token, certData, signature, message)).to.be.null;
+    });
+
+    it('should not accept a status token presented with other content', async function() {
+      const signature = await wrapper.sign(privateKey, message);
+      const otherSignature = await wrapper.sign(privateKey, message + ' (amended)');
+      const uuid = '5f0c6a1e-status-token-content-test';
+      const { token } = wrapper.verifyStatusCached(uuid, certData, signature, message);
+
+      expect(wrapper.checkStatusToken(uuid, token, certData, signature, message)).to.be.true;
+      expect(wrapper.checkStatusToken(uuid, token, certData, otherSignature, message + ' (amended)')).to.be.null;
+      expect(wrapper.checkStatusToken(uuid, token, certData, signature, message, { caCert: certData })).to.be.null;
+    });
+
+    it('should cache a bad signature but not a certificate that failed to parse', async function() {
+      const forged = await wrapper.sign(privateKey, 'a different message');
+      const unparsable = new Uint8Array([0x30, 0x03, 0x02, 0x01, 0x00]);
+      wrapper.clearStatusCache();
+
+      const rejected = wrapper.verifyStatusCached('5f0c6a1e-status-forged-test', certData, forged, message);
+      expect(rejected.valid).to.be.false;
+      expect(wrapper.checkStatusToken('5f0c6a1e-status-forged-test', rejected.token, certData, forged, message)).to.be.false;
+
+      const failed = wrapper.verifyStatusCached('5f0c6a1e-status-unparsable-test', unparsable, forged, message);
+      expect(failed.valid).to.be.false;
+      expect(wrapper.checkStatusToken('5f0c6a1e-status-unparsable-test', failed.token, unparsable, forged, message)).to.be.null;
+    });
+
+    it('should not answer a CA-checked status from a verdict cached without the CA', async function() {
+      const signature = await wrapper.sign(privateKey, message);
+      const uuid = '5f0c6a1e-status-cache-ca-test';
+      const otherKeys = await wrapper.generateKeyPair();
+      const otherCsr = await wrapper.generateCSR(otherKeys.privateKey, otherKeys.publicKey, ['C=US', 'CN=other-ca.example.com']);
+      const otherCa = await wrapper.generateSelfSignedCertificate(otherKeys.privateKey, otherCsr);
+      wrapper.clearStatusCache();
+
+      expect(wrapper.verifyStatusCached(uuid, certData, signature, message).valid).to.be.true;
+      expect(wrapper.verifyStatusCached(uuid, certData, signature, message, { caCert: otherCa }).valid).to.be.false;
+    });
+
+    it('should verify a binary QR payload reassembled from out-of-order frames', async function() {
+      const qrMessage = wrapper.encodeQrMessage([message, 'application-42']);
+      const signature = await wrapper.sign(privateKey, qrMessage);
+      const payload = wrapper.encodeQrPayload(certData, qrMessage, signature);
+
+      const frames = wrapper.splitQrPayload(payload);
+      expect(frames.length).to.equal(2);
+      const joined = wrapper.joinQrPayload(frames.reverse());
+      const parsed = wrapper.parseQrPayload(joined);
+      expect(new TextDecoder().decode(parsed.fields[1])).to.equal('application-42');
+      expect(wrapper.verifyQrPayload(joined, certData)).to.be.true;
+    });
+
+    it('should verify a signature kept in the signature store', async function() {
+      const signature = await wrapper.sign(privateKey, message);
+      const uuid = '9b2e4d70-signature-store-test';
+      wrapper.openSignatureStore('/tmp/mldsa-sig-store-test', { segmentSize: 1 << 20 });
+      try {
+        wrapper.putSignature(uuid, message, signature);
+        const record = wrapper.getSignature(uuid);
+        expect(new TextDecoder().decode(record.message)).to.equal(message);
+        expect(record.signature).to.deep.equal(signature);
+        expect(await wrapper.verifyStoredSignature(uuid, certData)).to.be.true;
+
+        expect(wrapper.deleteSignature(uuid)).to.be.true;
+        expect(wrapper.getSignature(uuid)).to.be.null;
+        expect(await wrapper.verifyStoredSignature(uuid, certData)).to.be.null;
+      } finally {
+        wrapper.closeSignatureStore();
+      }
+    });
+
+    it('should keep a re-put signature across compaction of its tombstone and a reopen', async function() {
+      const signature = await wrapper.sign(privateKey, message);
+      const dir = `/tmp/mldsa-sig-store-compact-${process.pid}`;
+      const segments = () => wrapper.getSignatureStoreStats().segments;
+      const options = { segmentSize: 64 * 1024 };
+      wrapper.openSignatureStore(dir, options);
+      try {
+        wrapper.putSignature('reissued', 'first', signature, { durable: false });
+        for (let i = 0; segments() === 1; i++) wrapper.putSignature(`a-${i}`, message, signature, { durable: false });
+        wrapper.deleteSignature('reissued'); // tombstone lands in segment 1
+        let fillers = 0;
+        for (; segments() === 2; fillers++) wrapper.putSignature(`b-${fillers}`, message, signature, { durable: false });
+        wrapper.putSignature('reissued', 'second', signature, { durable: false });
+        // Overwriting the fillers leaves segment 1 with nothing live, so compaction picks it.
+        for (let i = 0; i < fillers; i++) wrapper.putSignature(`b-${i}`, message, signature, { durable: false });
+        expect(wrapper.compactSignatureStore(0.1)).to.equal(1);
+
+        wrapper.closeSignatureStore();
+        wrapper.openSignatureStore(dir, options);
+        expect(new TextDecoder().decode(wrapper.getSignature('reissued').message)).to.equal('second');
+      } finally {
+        wrapper.closeSignatureStore();
+        fs.rmSync(dir, { recursive: true, force: true });
+      }
+    });
+  });
+
+  describe('Batch Signature Verification (verifySignatureBatch)', function() {
+    let certA, certB, keysA, keysB;
+
+    before(async function() {
+      keysA = await wrapper.generateKeyPair();
+      keysB = await wrapper.generateKeyPair();
+      const csrA = await wrapper.generateCSR(keysA.privateKey, keysA.publicKey, ['C=VN', 'CN=officer-a.example.com']);
+      const csrB = await wrapper.generateCSR(keysB.privateKey, keysB.publicKey, ['C=VN', 'CN=officer-b.example.com']);
+      certA = await wrapper.generateSelfSignedCertificate(keysA.privateKey, csrA);
+      certB = await wrapper.generateSelfSignedCertificate(keysB.privateKey, csrB);
+    });
+
+    it('should report a per-item result for each signature', async function() {
+      const sigA = await wrapper.sign(keysA.privateKey, 'document-a');
+      const sigB = await wrapper.sign(keysB.privateKey, 'document-b');
+      const results = await wrapper.verifySignatureBatch([certA, certB], [
+        { certIndex: 0, signature: sigA, message: 'document-a' },
+        { certIndex: 1, signature: sigB, message: 'document-b' },
+        { certIndex: 0, signature: sigB, message: 'document-b' },
+        { certIndex: 7, signature: sigA, message: 'document-a' },
+      ]);
+      expect(results).to.deep.equal([true, true, false, false]);
+    });
+
+    it('should prove each document of a Merkle-signed batch under one signature', async function() {
+      const documents = ['birth-reg-1', 'birth-reg-2', 'birth-reg-3', 'birth-reg-4', 'birth-reg-5'];
+      const { signature, proofs } = await wrapper.signMerkleBatch(keysA.privateKey, documents);
+      expect(proofs.length).to.equal(documents.length);
+      expect(await wrapper.verifyMerkleProof(keysA.publicKey, signature, proofs[4], documents[4])).to.be.true;
+      expect(await wrapper.verifyMerkleProofWithCertificate(certA, signature, proofs[2], documents[2])).to.be.true;
+      expect(await wrapper.verifyMerkleProof(keysA.publicKey, signature, proofs[0], documents[1])).to.be.false;
+    });
+  });
+
+  describe('Library Stats (getStats)', function() {
+    it('should count calls and time the sign phase', async function() {
+      const { privateKey } = await wrapper.generateKeyPair();
+      wrapper.resetStats();
+      await wrapper.sign(privateKey, 'stats');
+      const stats = wrapper.getStats();
+      expect(stats.functions.sign_mldsa65.calls).to.equal(1);
+      expect(stats.functions.sign_mldsa65.failures).to.equal(0);
+      expect(stats.phases.sign.count).to.equal(1);
+      expect(stats.phases.key_import.count).to.equal(1);
+      expect(wrapper.getStats('prometheus')).to.include('mldsa_calls_total{function="sign_mldsa65"} 1');
+    });
   });
 
   describe('Certificate Signing (signCertificate)', function() {
@@ -207,6 +475,22 @@ describe('MLDSAWrapper - Real WASM Interaction Tests', function() {
       expect(signedCert).to.be.an.instanceof(Uint8Array);
       expect(signedCert.length).to.be.above(0); // Signed certificate length depends on content
     });
+
+    it('should give every issued certificate a distinct serial', async function() {
+      const first = await wrapper.signCertificate(caPrivateKey, clientCsrData, caCertData);
+      const second = await wrapper.signCertificate(caPrivateKey, clientCsrData, caCertData);
+      const serial = wrapper.getCertificateSerial(first);
+      expect(serial).to.have.length.above(2);
+      expect(serial).to.not.equal(wrapper.getCertificateSerial(second));
+      expect(serial).to.not.equal(wrapper.getCertificateSerial(caCertData));
+    });
+
+    it('should issue a batch of certificates and fail only the bad CSR', async function() {
+      const results = await wrapper.signCertificatesBatch(caPrivateKey, [clientCsrData, 'not a CSR', clientCsrData], caCertData);
+      expect(results.map(r => r.status)).to.deep.equal([wrapper.ISSUE_OK, wrapper.ISSUE_BAD_CSR, wrapper.ISSUE_OK]);
+      expect(await wrapper.verifyCertificateIssuedByCA(results[0].certificate, caCertData)).to.be.true;
+      expect(results[1].certificate).to.be.null;
+    });
   });
 
   describe('Utility Functions', function() {
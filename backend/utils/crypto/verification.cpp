@@ -8,6 +8,15 @@
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include "helper.cpp"
 
 // --- Helper: Unique pointers for OpenSSL types ---
@@ -29,31 +38,12 @@ void handle_openssl_error(const char* context);
 bool read_file_bytes(const std::string& file_path, std::vector<unsigned char>& data);
 
 X509_ptr load_certificate(const std::string& cert_path) {
-    // Open certificate file using std::ifstream
-    std::ifstream file(cert_path, std::ios::binary);
-    if (!file) {
-        std::cerr << "Failed to open certificate file: " << cert_path << std::endl;
+    // Map the file and parse it in place (PEM or DER)
+    mapped_file file(cert_path);
+    if (!file.ok()) {
         return X509_ptr(nullptr, X509_free);
     }
-
-    // Read the entire file into a std::string
-    std::string pem_data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-    // Create a memory BIO from the PEM data
-    BIO_ptr cert_bio(BIO_new_mem_buf(pem_data.data(), static_cast<int>(pem_data.size())), BIO_free_all);
-    if (!cert_bio) {
-        handle_openssl_error("BIO_new_mem_buf for loading certificate");
-        return X509_ptr(nullptr, X509_free);
-    }
-
-    // Parse X509 certificate from the memory BIO
-    X509* cert_raw = PEM_read_bio_X509(cert_bio.get(), nullptr, nullptr, nullptr);
-    if (!cert_raw) {
-        handle_openssl_error("PEM_read_bio_X509");
-        return X509_ptr(nullptr, X509_free);
-    }
-
-    return X509_ptr(cert_raw, X509_free);
+    return read_x509(file.chars(), file.size());
 }
 
 
@@ -75,183 +65,449 @@ EVP_PKEY_ptr load_public_key(const std::string& key_path) {
 
 // --- Verification Implementations ---
 
-bool verify_mldsa65(const char *public_key_chr, const char *signature_path, const char *message_chr, int message_len){
-    EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_public_key(EVP_PKEY_ML_DSA_65, nullptr, (const unsigned char*)public_key_chr, ml_dsa_65_public_key_size), EVP_PKEY_free);
-    if (!pkey) {
-        return false;
-    }
-
-    // Check if the key is ECDSA
-    // if (EVP_PKEY_base_id(pkey.get()) != EVP_PKEY_ML_DSA_65) {
-    //     std::cerr << "Error: Provided key is not a key for ML-DSA-65 verification." << std::endl;
-    //     return false;
-    // }
-
-    std::vector<unsigned char> message_data;
-    for(int i=0;i<message_len; i++) {
-        message_data.push_back(static_cast<unsigned char>(message_chr[i]));
-    }
-
-    std::vector<unsigned char> signature_data;
-    if (!read_file_bytes(signature_path, signature_data)) {
-        return false;
-    }
-
+// Verifies with an already imported key.
+static bool verify_with_pkey(EVP_PKEY *pkey, const unsigned char *signature_buf, size_t signature_len, const char *message_chr, int message_len) {
     EVP_MD_CTX_ptr md_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free); // Corrected init
     if (!md_ctx) {
         handle_openssl_error("EVP_MD_CTX_new for verification");
         return false;
     }
 
-    if (EVP_DigestVerifyInit(md_ctx.get(), nullptr, NULL, nullptr, pkey.get()) <= 0) {
+    if (EVP_DigestVerifyInit(md_ctx.get(), nullptr, NULL, nullptr, pkey) <= 0) {
         handle_openssl_error("EVP_DigestVerifyInit");
         return false;
     }
 
-
-
-        // EVP_DigestVerifyFinal returns 1 for success (valid signature), 0 for failure (invalid signature),
+    // EVP_DigestVerify returns 1 for success (valid signature), 0 for failure (invalid signature),
     // and a negative value for other errors.
-    int verify_result = EVP_DigestVerify(md_ctx.get(), signature_data.data(), signature_data.size(), (unsigned char*) message_chr, message_len);
+    stats_phase_timer verify_timer(stats_phase::verify);
+    int verify_result = EVP_DigestVerify(md_ctx.get(), signature_buf, signature_len, (const unsigned char*) message_chr, message_len);
+    verify_timer.stop();
     if (verify_result == 1) {
         return true; // Signature is valid
     } else if (verify_result == 0) {
-        std::cerr << "Verification failed: Signature is invalid." << std::endl;
-        return false; // Signature is invalidB
+        // Forged QR codes land here; recording must stay as cheap as the success path.
+        ERR_clear_error();
+        record_error(MLDSA_ERR_INVALID_SIGNATURE, 0, "EVP_DigestVerify");
+        return false; // Signature is invalid
     } else {
         handle_openssl_error("EVP_DigestVerifyFinal");
         return false; // An error occurred during verification
     }
 }
 
-bool verify_signature_with_cert(const char *certificate_buf, size_t certificate_len, const unsigned char *signature_buf, size_t signature_len, const char *message_chr, int message_len) {
-    // Load certificate from buffer
-    BIO_ptr cert_bio(BIO_new_mem_buf(certificate_buf, static_cast<int>(certificate_len)), BIO_free_all);
-    if (!cert_bio) {
-        handle_openssl_error("BIO_new_mem_buf for certificate");
+bool verify_mldsa65(const char *public_key_chr, const char *signature_path, const char *message_chr, int message_len){
+    stats_call_timer call(stats_call::verify);
+    stats_phase_timer import_timer(stats_phase::key_import);
+    EVP_PKEY_ptr pkey(EVP_PKEY_new_raw_public_key(EVP_PKEY_ML_DSA_65, nullptr, (const unsigned char*)public_key_chr, ml_dsa_65_public_key_size), EVP_PKEY_free);
+    import_timer.stop();
+    if (!pkey) {
         return false;
     }
-    X509* cert_raw = PEM_read_bio_X509(cert_bio.get(), nullptr, nullptr, nullptr);
-    if (!cert_raw) {
-        handle_openssl_error("PEM_read_bio_X509");
+
+    mapped_file signature_file(signature_path);
+    if (!signature_file.ok()) {
         return false;
     }
-    X509_ptr cert(cert_raw, X509_free);
+
+    return call.done(verify_with_pkey(pkey.get(), signature_file.data(), signature_file.size(), message_chr, message_len));
+}
+
+bool verify_mldsa65_with_handle(mldsa_key_handle *handle, const unsigned char *signature_buf, size_t signature_len, const char *message_chr, int message_len) {
+    stats_call_timer call(stats_call::verify_with_handle);
+    if (!handle || !handle->pkey) {
+        return false;
+    }
+    return call.done(verify_with_pkey(handle->pkey.get(), signature_buf, signature_len, message_chr, message_len));
+}
+
+// Parses a certificate and returns its ML-DSA-65 public key, ready to verify with,
+// plus the key it is looked up by in the revocation index.
+static EVP_PKEY_ptr load_verify_key_from_cert(const char *certificate_buf, size_t certificate_len, revocation_ref& ref) {
+    // Load certificate from buffer (PEM or DER)
+    X509_ptr cert = read_x509(certificate_buf, certificate_len);
+    if (!cert) {
+        return EVP_PKEY_ptr(nullptr, EVP_PKEY_free);
+    }
+    make_revocation_ref(cert.get(), ref);
 
     // Extract the public key from the certificate
     EVP_PKEY* pkey_raw = X509_get_pubkey(cert.get());
     if (!pkey_raw) {
         handle_openssl_error("X509_get_pubkey for verification");
-        return false;
+        return EVP_PKEY_ptr(nullptr, EVP_PKEY_free);
     }
     EVP_PKEY_ptr pkey(pkey_raw, EVP_PKEY_free);
 
-    char_ptr temp_pubkey = std::make_unique<char[]>(ml_dsa_65_public_key_size);
-    size_t public_key_size = ml_dsa_65_public_key_size;
-    if (!EVP_PKEY_get_raw_public_key(pkey.get(), (unsigned char*) temp_pubkey.get(), &public_key_size)) {
-        handle_openssl_error("EVP_PKEY_get_raw_public_key for verification");
+    // The decoded key verifies as is; no need to export and re-import its raw bytes.
+    if (!EVP_PKEY_is_a(pkey.get(), "ML-DSA-65")) {
+        record_error(MLDSA_ERR_INVALID_ARGUMENT, 0, "certificate key is not ML-DSA-65");
+        return EVP_PKEY_ptr(nullptr, EVP_PKEY_free);
+    }
+    return pkey;
+}
+
+// --- Verify key cache ---
+// LRU from the SHA-256 of a certificate buffer to its ready-to-use verify key, so hot
+// officer certificates skip parsing the certificate and decoding its key. Entries hand out
+// up-ref'd keys, so eviction never frees a key another thread is still verifying with.
+constexpr size_t default_verify_key_cache_capacity = 256;
+
+struct verify_key_entry {
+    std::string digest;
+    EVP_PKEY_ptr pkey;
+    revocation_ref ref; // revocation is checked on every use, so a cached key never hides a new CRL
+};
+
+static std::mutex verify_key_cache_mutex;
+static std::list<verify_key_entry> verify_key_lru; // front = most recently used
+static std::unordered_map<std::string, std::list<verify_key_entry>::iterator> verify_key_index;
+static size_t verify_key_cache_capacity = default_verify_key_cache_capacity;
+static uint64_t verify_key_cache_hits = 0;
+static uint64_t verify_key_cache_misses = 0;
+
+static bool buffer_sha256(const char *buf, size_t len, std::string& digest_out, const char *context) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+    if (EVP_Digest(buf, len, digest, &digest_len, EVP_sha256(), nullptr) != 1) {
+        handle_openssl_error(context);
         return false;
     }
+    digest_out.assign(reinterpret_cast<const char*>(digest), digest_len);
+    return true;
+}
 
-    // Prepare message data
-    std::vector<unsigned char> message_data(message_chr, message_chr + message_len);
+static EVP_PKEY_ptr share_pkey(EVP_PKEY *pkey) {
+    if (!pkey || EVP_PKEY_up_ref(pkey) != 1) {
+        return EVP_PKEY_ptr(nullptr, EVP_PKEY_free);
+    }
+    return EVP_PKEY_ptr(pkey, EVP_PKEY_free);
+}
 
-    EVP_PKEY_ptr verify_pkey(EVP_PKEY_new_raw_public_key(EVP_PKEY_ML_DSA_65, nullptr, (const unsigned char*)temp_pubkey.get(), ml_dsa_65_public_key_size), EVP_PKEY_free);
-    if (!verify_pkey) {
-        handle_openssl_error("EVP_PKEY_new_raw_public_key for verification");
-        return false;
+// Must hold verify_key_cache_mutex.
+static void trim_verify_key_cache(size_t capacity) {
+    while (verify_key_lru.size() > capacity) {
+        verify_key_index.erase(verify_key_lru.back().digest);
+        verify_key_lru.pop_back();
     }
+}
 
-    EVP_MD_CTX_ptr md_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
-    if (!md_ctx) {
-        handle_openssl_error("EVP_MD_CTX_new for verification");
-        return false;
+static EVP_PKEY_ptr cached_verify_key_from_cert(const char *certificate_buf, size_t certificate_len, revocation_ref& ref) {
+    std::string digest;
+    if (!buffer_sha256(certificate_buf, certificate_len, digest, "EVP_Digest for certificate cache key")) {
+        return EVP_PKEY_ptr(nullptr, EVP_PKEY_free);
+    }
+    {
+        std::lock_guard<std::mutex> lock(verify_key_cache_mutex);
+        auto it = verify_key_index.find(digest);
+        if (it != verify_key_index.end()) {
+            ++verify_key_cache_hits;
+            verify_key_lru.splice(verify_key_lru.begin(), verify_key_lru, it->second);
+            ref = it->second->ref;
+            return share_pkey(it->second->pkey.get());
+        }
+        ++verify_key_cache_misses;
     }
 
-    if (EVP_DigestVerifyInit(md_ctx.get(), nullptr, NULL, nullptr, verify_pkey.get()) <= 0) {
-        handle_openssl_error("EVP_DigestVerifyInit");
-        return false;
+    // Parse outside the lock; failures are not cached.
+    EVP_PKEY_ptr pkey = load_verify_key_from_cert(certificate_buf, certificate_len, ref);
+    if (!pkey) {
+        return pkey;
+    }
+    std::lock_guard<std::mutex> lock(verify_key_cache_mutex);
+    if (verify_key_cache_capacity == 0 || verify_key_index.count(digest)) {
+        return pkey;
     }
+    EVP_PKEY_ptr cached = share_pkey(pkey.get());
+    if (cached) {
+        verify_key_lru.push_front(verify_key_entry{digest, std::move(cached), ref});
+        verify_key_index.emplace(std::move(digest), verify_key_lru.begin());
+        trim_verify_key_cache(verify_key_cache_capacity);
+    }
+    return pkey;
+}
 
-    int verify_result = EVP_DigestVerify(md_ctx.get(), signature_buf, signature_len, (unsigned char*)message_chr, message_len);
-    if (verify_result == 1) {
-        return true; 
-    } else if (verify_result == 0) {
-        handle_openssl_error("EVP_DigestVerifyFinal for verification");
-        std::cerr << "Verification failed: Signature is invalid." << std::endl;
+void mldsa_set_verify_key_cache_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(verify_key_cache_mutex);
+    verify_key_cache_capacity = capacity;
+    trim_verify_key_cache(capacity);
+}
+
+void mldsa_get_verify_key_cache_stats(uint64_t *hits, uint64_t *misses, size_t *entries) {
+    std::lock_guard<std::mutex> lock(verify_key_cache_mutex);
+    if (hits) *hits = verify_key_cache_hits;
+    if (misses) *misses = verify_key_cache_misses;
+    if (entries) *entries = verify_key_lru.size();
+}
+
+bool verify_signature_with_cert(const char *certificate_buf, size_t certificate_len, const unsigned char *signature_buf, size_t signature_len, const char *message_chr, int message_len) {
+    stats_call_timer call(stats_call::verify_with_cert);
+    revocation_ref ref;
+    EVP_PKEY_ptr verify_pkey = cached_verify_key_from_cert(certificate_buf, certificate_len, ref);
+    if (!verify_pkey) {
         return false;
-    } else {
-        handle_openssl_error("EVP_DigestVerifyFinal");
+    }
+    if (is_revoked(ref)) {
+        record_error(MLDSA_ERR_CERT_CHAIN, X509_V_ERR_CERT_REVOKED, "verify_signature_with_cert");
         return false;
     }
+    return call.done(verify_with_pkey(verify_pkey.get(), signature_buf, signature_len, message_chr, message_len));
 }
 
-bool verify_certificate_issued_by_ca(
-    const char* cert_buf, size_t cert_buf_len,
-    const char* ca_cert_buf, size_t ca_cert_buf_len
+// Returns the number of valid signatures, -1 on invalid arguments
+int verify_signature_batch(
+    const char **certificate_bufs,
+    const size_t *certificate_lens,
+    size_t certificate_count,
+    const uint32_t *cert_indices,
+    const unsigned char **signature_bufs,
+    const size_t *signature_lens,
+    const char **message_bufs,
+    const size_t *message_lens,
+    size_t item_count,
+    unsigned char *result_bitmap,
+    size_t result_bitmap_size,
+    int thread_count
 ) {
-    // Create BIOs from memory buffers
-    BIO_ptr cert_bio(BIO_new_mem_buf(cert_buf, static_cast<int>(cert_buf_len)), BIO_free_all);
-    BIO_ptr ca_bio(BIO_new_mem_buf(ca_cert_buf, static_cast<int>(ca_cert_buf_len)), BIO_free_all);
-    if (!cert_bio || !ca_bio) {
-        handle_openssl_error("BIO_new_mem_buf for certificate or CA");
-        return false;
+    stats_call_timer call(stats_call::verify_batch);
+    if (!result_bitmap || result_bitmap_size < (item_count + 7) / 8) {
+        return -1;
+    }
+    if (item_count > 0 && (!cert_indices || !signature_bufs || !signature_lens || !message_bufs || !message_lens)) {
+        return -1;
+    }
+    if (certificate_count > 0 && (!certificate_bufs || !certificate_lens)) {
+        return -1;
+    }
+    memset(result_bitmap, 0, (item_count + 7) / 8);
+
+    // Parse every certificate once; items pointing at a bad certificate just fail.
+    // Revoked certificates are dropped here, so their items fail like a bad certificate.
+    std::vector<EVP_PKEY_ptr> keys;
+    keys.reserve(certificate_count);
+    for (size_t i = 0; i < certificate_count; ++i) {
+        revocation_ref ref;
+        keys.push_back(cached_verify_key_from_cert(certificate_bufs[i], certificate_lens[i], ref));
+        if (keys.back() && is_revoked(ref)) {
+            record_error(MLDSA_ERR_CERT_CHAIN, X509_V_ERR_CERT_REVOKED, "verify_signature_batch");
+            keys.back().reset();
+        }
     }
 
-    // Load X509 structures
-    X509* cert = PEM_read_bio_X509(cert_bio.get(), nullptr, nullptr, nullptr);
-    X509* ca_cert = PEM_read_bio_X509(ca_bio.get(), nullptr, nullptr, nullptr);
-    if (!cert || !ca_cert) {
-        handle_openssl_error("PEM_read_bio_X509 for certificate or CA");
-        if (cert) X509_free(cert);
-        if (ca_cert) X509_free(ca_cert);
+    std::vector<unsigned char> results(item_count, 0);
+    auto verify_item = [&](size_t i) {
+        uint32_t cert_index = cert_indices[i];
+        if (cert_index >= keys.size() || !keys[cert_index] || message_lens[i] > INT32_MAX) {
+            return;
+        }
+        results[i] = verify_with_pkey(keys[cert_index].get(), signature_bufs[i], signature_lens[i],
+                                      message_bufs[i], static_cast<int>(message_lens[i])) ? 1 : 0;
+    };
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    size_t workers = thread_count > 0 ? static_cast<size_t>(thread_count) : std::thread::hardware_concurrency();
+    workers = std::max<size_t>(1, std::min(workers, item_count));
+    if (workers > 1) {
+        // EVP_PKEY is safe to share read-only; each verification uses its own EVP_MD_CTX.
+        std::atomic<size_t> next_item{0};
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t w = 0; w < workers; ++w) {
+            pool.emplace_back([&] {
+                for (size_t i = next_item.fetch_add(1); i < item_count; i = next_item.fetch_add(1)) {
+                    verify_item(i);
+                }
+            });
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    } else
+#endif
+    {
+        (void) thread_count;
+        for (size_t i = 0; i < item_count; ++i) {
+            verify_item(i);
+        }
+    }
+
+    int valid_count = 0;
+    for (size_t i = 0; i < item_count; ++i) {
+        if (results[i]) {
+            result_bitmap[i / 8] |= static_cast<unsigned char>(1u << (i % 8));
+            ++valid_count;
+        }
+    }
+    return call.done(valid_count, true);
+}
+
+// --- Trust store cache ---
+// Chain checks always run against the same handful of CAs, so each CA is parsed into an
+// X509_STORE once and reused. X509_STORE is reference counted and safe to share between
+// concurrent X509_STORE_CTXs; only the cache itself needs the lock.
+//
+// Anchors are keyed by the SHA-256 of the CA's DER encoding, so the PEM and DER forms of one
+// CA (or PEM with other line endings) share a store. The SHA-256 of each input buffer seen
+// for a CA is kept as an alias in front of that, so a repeat buffer still needs no parsing.
+using X509_STORE_ptr = ossl_unique_ptr<X509_STORE, X509_STORE_free>;
+using X509_STORE_CTX_ptr = ossl_unique_ptr<X509_STORE_CTX, X509_STORE_CTX_free>;
+
+constexpr size_t trust_store_cache_limit = 16;
+constexpr size_t trust_anchor_alias_limit = 4; // further encodings of a CA are parsed each time
+
+struct trust_anchor {
+    X509_STORE_ptr store{nullptr, X509_STORE_free};
+};
+
+struct trust_anchor_entry {
+    std::string fingerprint;
+    std::shared_ptr<trust_anchor> anchor;
+    std::vector<std::string> aliases;
+};
+
+static std::mutex trust_store_mutex;
+static std::list<trust_anchor_entry> trust_store_lru; // front = most recently used
+static std::unordered_map<std::string, std::list<trust_anchor_entry>::iterator> trust_store_index;
+static std::unordered_map<std::string, std::list<trust_anchor_entry>::iterator> trust_store_aliases;
+
+static bool ca_fingerprint(X509 *ca_cert, std::string& fingerprint) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+    if (X509_digest(ca_cert, EVP_sha256(), digest, &digest_len) != 1) {
+        handle_openssl_error("X509_digest for CA fingerprint");
         return false;
     }
+    fingerprint.assign(reinterpret_cast<const char*>(digest), digest_len);
+    return true;
+}
 
-    // Create X509_STORE and add CA cert
-    X509_STORE* store = X509_STORE_new();
-    if (!store) {
+static std::shared_ptr<trust_anchor> build_trust_anchor(X509 *ca_cert) {
+    auto anchor = std::make_shared<trust_anchor>();
+    anchor->store.reset(X509_STORE_new());
+    if (!anchor->store) {
         handle_openssl_error("X509_STORE_new");
-        X509_free(cert);
-        X509_free(ca_cert);
-        return false;
+        return nullptr;
     }
-    if (X509_STORE_add_cert(store, ca_cert) != 1) {
+    // The store takes its own reference to the CA.
+    if (X509_STORE_add_cert(anchor->store.get(), ca_cert) != 1) {
         handle_openssl_error("X509_STORE_add_cert");
-        X509_STORE_free(store);
-        X509_free(cert);
-        X509_free(ca_cert);
+        return nullptr;
+    }
+    return anchor;
+}
+
+// Must hold trust_store_mutex.
+static void trim_trust_store_cache(size_t capacity) {
+    while (trust_store_lru.size() > capacity) {
+        trust_anchor_entry& victim = trust_store_lru.back();
+        for (const std::string& alias : victim.aliases) {
+            trust_store_aliases.erase(alias);
+        }
+        trust_store_index.erase(victim.fingerprint);
+        trust_store_lru.pop_back();
+    }
+}
+
+// Must hold trust_store_mutex. Marks the entry most recently used and remembers alias for it.
+static std::shared_ptr<trust_anchor> use_trust_anchor(std::list<trust_anchor_entry>::iterator entry, const std::string& alias) {
+    trust_store_lru.splice(trust_store_lru.begin(), trust_store_lru, entry);
+    if (!alias.empty() && entry->aliases.size() < trust_anchor_alias_limit &&
+        trust_store_aliases.emplace(alias, entry).second) {
+        entry->aliases.push_back(alias);
+    }
+    return entry->anchor;
+}
+
+static std::shared_ptr<trust_anchor> get_trust_anchor(const char *ca_cert_buf, size_t ca_cert_buf_len) {
+    std::string alias;
+    if (!buffer_sha256(ca_cert_buf, ca_cert_buf_len, alias, "EVP_Digest for CA buffer")) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(trust_store_mutex);
+        auto it = trust_store_aliases.find(alias);
+        if (it != trust_store_aliases.end()) {
+            return use_trust_anchor(it->second, std::string());
+        }
+    }
+
+    // Unseen buffer: parse it to find out which CA it is.
+    X509_ptr ca_cert = read_x509(ca_cert_buf, ca_cert_buf_len);
+    if (!ca_cert) {
+        return nullptr;
+    }
+    std::string fingerprint;
+    if (!ca_fingerprint(ca_cert.get(), fingerprint)) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(trust_store_mutex);
+        auto it = trust_store_index.find(fingerprint);
+        if (it != trust_store_index.end()) {
+            return use_trust_anchor(it->second, alias);
+        }
+    }
+
+    // Build outside the lock; if two threads race, the first insert wins.
+    std::shared_ptr<trust_anchor> anchor = build_trust_anchor(ca_cert.get());
+    if (!anchor) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(trust_store_mutex);
+    auto it = trust_store_index.find(fingerprint);
+    if (it != trust_store_index.end()) {
+        return use_trust_anchor(it->second, alias);
+    }
+    trust_store_lru.push_front(trust_anchor_entry{fingerprint, std::move(anchor), {}});
+    trust_store_index.emplace(std::move(fingerprint), trust_store_lru.begin());
+    trim_trust_store_cache(trust_store_cache_limit);
+    return use_trust_anchor(trust_store_lru.begin(), alias);
+}
+
+void mldsa_clear_trust_store_cache(void) {
+    std::lock_guard<std::mutex> lock(trust_store_mutex);
+    trust_store_aliases.clear();
+    trust_store_index.clear();
+    trust_store_lru.clear();
+}
+
+bool verify_certificate_issued_by_ca(
+    const char* cert_buf, size_t cert_buf_len,
+    const char* ca_cert_buf, size_t ca_cert_buf_len
+) {
+    stats_call_timer call(stats_call::verify_certificate_issued_by_ca);
+    std::shared_ptr<trust_anchor> anchor = get_trust_anchor(ca_cert_buf, ca_cert_buf_len);
+    if (!anchor) {
+        return false;
+    }
+
+    X509_ptr cert = read_x509(cert_buf, cert_buf_len);
+    if (!cert) {
         return false;
     }
 
-    // Create X509_STORE_CTX for verification
-    X509_STORE_CTX* ctx = X509_STORE_CTX_new();
+    // A fresh context per verification; the store is shared.
+    X509_STORE_CTX_ptr ctx(X509_STORE_CTX_new(), X509_STORE_CTX_free);
     if (!ctx) {
         handle_openssl_error("X509_STORE_CTX_new");
-        X509_STORE_free(store);
-        X509_free(cert);
-        X509_free(ca_cert);
         return false;
     }
 
     bool result = false;
-    if (X509_STORE_CTX_init(ctx, store, cert, nullptr) == 1) {
-        int verify_result = X509_verify_cert(ctx);
+    if (X509_STORE_CTX_init(ctx.get(), anchor->store.get(), cert.get(), nullptr) == 1) {
+        stats_phase_timer verify_timer(stats_phase::verify);
+        int verify_result = X509_verify_cert(ctx.get());
+        verify_timer.stop();
         result = (verify_result == 1);
         if (!result) {
-            handle_openssl_error("X509_verify_cert by CA");
-            int err = X509_STORE_CTX_get_error(ctx);
-            std::cerr << "Certificate verification failed: " << X509_verify_cert_error_string(err) << std::endl;
+            ERR_clear_error();
+            record_error(MLDSA_ERR_CERT_CHAIN, static_cast<unsigned long>(X509_STORE_CTX_get_error(ctx.get())), "X509_verify_cert by CA");
+        } else if (certificate_is_revoked(cert.get())) {
+            record_error(MLDSA_ERR_CERT_CHAIN, X509_V_ERR_CERT_REVOKED, "X509_verify_cert by CA");
+            result = false;
         }
     } else {
         handle_openssl_error("X509_STORE_CTX_init");
     }
-
-    // Cleanup
-    X509_STORE_CTX_free(ctx);
-    X509_STORE_free(store);
-    X509_free(cert);
-    X509_free(ca_cert);
-
-    return result;
-}
\ No newline at end of file
+    return call.done(result);
+}